@@ -0,0 +1,249 @@
+// calibration.cpp - Współczynniki kalibracji w NVS i prowadzona kalibracja
+#include "calibration.h"
+#include "config.h"
+#include "state.h"
+#include "sensor_driver.h"
+#include <nvs_flash.h>
+#include <nvs.h>
+
+struct CalPoint {
+    double raw;
+    double ref;
+};
+
+// Sesja: zapisy z web servera, próbki z tasku czujników – wszystko pod state_lock()
+struct CalSession {
+    bool active;
+    int role;
+    uint8_t id[8];
+    CalPoint points[CAL_MAX_POINTS];
+    int pointCount;
+    bool capturing;
+    double captureRef;
+    double sum;
+    double minRaw;
+    double maxRaw;
+    int samples;
+    char message[64];
+};
+
+static CalSession session = {};
+
+// Klucz NVS (max 15 znaków): prefiks ('c' kalibracja, 't' stała czasowa)
+// + 7 bajtów identyfikatora; ósmy to CRC
+static void calKey(const uint8_t* id, char* key, char prefix = 'c') {
+    snprintf(key, 16, "%c%02X%02X%02X%02X%02X%02X%02X",
+             prefix, id[0], id[1], id[2], id[3], id[4], id[5], id[6]);
+}
+
+SensorCal calibration_load(const uint8_t* id) {
+    SensorCal cal = SENSOR_CAL_IDENTITY;
+    nvs_handle_t nvsHandle;
+    if (nvs_open("sensor_cal", NVS_READONLY, &nvsHandle) != ESP_OK) return cal;
+
+    char key[16];
+    calKey(id, key);
+    SensorCal stored;
+    size_t len = sizeof(stored);
+    if (nvs_get_blob(nvsHandle, key, &stored, &len) == ESP_OK && len == sizeof(stored) &&
+        stored.gain >= CAL_GAIN_MIN && stored.gain <= CAL_GAIN_MAX) {
+        cal = stored;
+    }
+    nvs_close(nvsHandle);
+    return cal;
+}
+
+bool calibration_store(const uint8_t* id, const SensorCal& cal) {
+    nvs_handle_t nvsHandle;
+    if (nvs_open("sensor_cal", NVS_READWRITE, &nvsHandle) != ESP_OK) return false;
+    char key[16];
+    calKey(id, key);
+    bool ok = nvs_set_blob(nvsHandle, key, &cal, sizeof(cal)) == ESP_OK &&
+              nvs_commit(nvsHandle) == ESP_OK;
+    nvs_close(nvsHandle);
+    return ok;
+}
+
+bool calibration_erase(const uint8_t* id) {
+    nvs_handle_t nvsHandle;
+    if (nvs_open("sensor_cal", NVS_READWRITE, &nvsHandle) != ESP_OK) return false;
+    char key[16];
+    calKey(id, key);
+    esp_err_t err = nvs_erase_key(nvsHandle, key);
+    nvs_commit(nvsHandle);
+    nvs_close(nvsHandle);
+    return err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND;
+}
+
+float calibration_loadTau(const uint8_t* id) {
+    float tau = 0.0f;
+    nvs_handle_t nvsHandle;
+    if (nvs_open("sensor_cal", NVS_READONLY, &nvsHandle) != ESP_OK) return tau;
+    char key[16];
+    calKey(id, key, 't');
+    size_t len = sizeof(tau);
+    if (nvs_get_blob(nvsHandle, key, &tau, &len) != ESP_OK || len != sizeof(tau)) tau = 0.0f;
+    nvs_close(nvsHandle);
+    return tau;
+}
+
+bool calibration_storeTau(const uint8_t* id, float tau) {
+    nvs_handle_t nvsHandle;
+    if (nvs_open("sensor_cal", NVS_READWRITE, &nvsHandle) != ESP_OK) return false;
+    char key[16];
+    calKey(id, key, 't');
+    bool ok;
+    if (tau > 0.0f) {
+        ok = nvs_set_blob(nvsHandle, key, &tau, sizeof(tau)) == ESP_OK;
+    } else {
+        esp_err_t err = nvs_erase_key(nvsHandle, key);
+        ok = (err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND);
+    }
+    ok = ok && nvs_commit(nvsHandle) == ESP_OK;
+    nvs_close(nvsHandle);
+    return ok;
+}
+
+bool calibration_begin(int role, const uint8_t* id) {
+    if (role < 0 || role >= PROBE_COUNT) return false;
+    if (!state_lock()) return false;
+    memset(&session, 0, sizeof(session));
+    session.active = true;
+    session.role = role;
+    memcpy(session.id, id, sizeof(session.id));
+    snprintf(session.message, sizeof(session.message), "Umieść sondę w punkcie odniesienia");
+    state_unlock();
+    LOG_FMT(LOG_LEVEL_INFO, "Calibration started: %s probe", probeRoleKey(role));
+    return true;
+}
+
+bool calibration_capture(double refTemp) {
+    if (!state_lock()) return false;
+    bool ok = session.active && !session.capturing && session.pointCount < CAL_MAX_POINTS;
+    if (ok) {
+        session.capturing = true;
+        session.captureRef = refTemp;
+        session.sum = 0.0;
+        session.samples = 0;
+        snprintf(session.message, sizeof(session.message), "Pomiar punktu %.2f C...", refTemp);
+    }
+    state_unlock();
+    return ok;
+}
+
+void calibration_feed(int role, double raw) {
+    // Szybka ścieżka bez blokady – odczyt flagi, którą zmienia tylko web
+    if (!session.capturing || session.role != role) return;
+    if (!state_lock(10)) return;
+
+    if (session.capturing && session.role == role) {
+        if (session.samples == 0) {
+            session.minRaw = raw;
+            session.maxRaw = raw;
+        }
+        session.sum += raw;
+        session.minRaw = min(session.minRaw, raw);
+        session.maxRaw = max(session.maxRaw, raw);
+        session.samples++;
+
+        if (session.samples >= CAL_CAPTURE_SAMPLES) {
+            session.capturing = false;
+            double spread = session.maxRaw - session.minRaw;
+            if (spread > CAL_MAX_SPREAD) {
+                snprintf(session.message, sizeof(session.message),
+                         "Niestabilny odczyt (rozrzut %.2f C) - powtórz", spread);
+            } else {
+                CalPoint& p = session.points[session.pointCount++];
+                p.raw = session.sum / session.samples;
+                p.ref = session.captureRef;
+                snprintf(session.message, sizeof(session.message),
+                         "Punkt %d: odczyt %.2f C = wzorzec %.2f C", session.pointCount, p.raw, p.ref);
+            }
+        }
+    }
+    state_unlock();
+}
+
+bool calibration_finish(char* err, size_t errLen) {
+    if (!state_lock()) {
+        snprintf(err, errLen, "busy");
+        return false;
+    }
+    CalSession s = session;
+    state_unlock();
+
+    if (!s.active || s.capturing || s.pointCount == 0) {
+        snprintf(err, errLen, "No calibration points");
+        return false;
+    }
+
+    SensorCal cal = SENSOR_CAL_IDENTITY;
+    if (s.pointCount == 1) {
+        cal.offset = (float)(s.points[0].ref - s.points[0].raw);
+    } else {
+        // Prosta ref = gain * raw + offset (najmniejsze kwadraty)
+        double n = s.pointCount, sx = 0, sy = 0, sxx = 0, sxy = 0;
+        double rawMin = s.points[0].raw, rawMax = s.points[0].raw;
+        for (int i = 0; i < s.pointCount; i++) {
+            sx += s.points[i].raw;
+            sy += s.points[i].ref;
+            sxx += s.points[i].raw * s.points[i].raw;
+            sxy += s.points[i].raw * s.points[i].ref;
+            rawMin = min(rawMin, s.points[i].raw);
+            rawMax = max(rawMax, s.points[i].raw);
+        }
+        if (rawMax - rawMin < CAL_MIN_SPAN) {
+            snprintf(err, errLen, "Points closer than %.0f C", CAL_MIN_SPAN);
+            return false;
+        }
+        double gain = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+        cal.gain = (float)gain;
+        cal.offset = (float)((sy - gain * sx) / n);
+    }
+
+    if (cal.gain < CAL_GAIN_MIN || cal.gain > CAL_GAIN_MAX || fabs(cal.offset) > CAL_MAX_OFFSET) {
+        snprintf(err, errLen, "Result out of range (gain %.3f, offset %.2f)", cal.gain, cal.offset);
+        return false;
+    }
+    if (!calibration_store(s.id, cal)) {
+        snprintf(err, errLen, "NVS write failed");
+        return false;
+    }
+
+    if (state_lock()) {
+        session.active = false;
+        snprintf(session.message, sizeof(session.message), "Zapisano: gain %.4f, offset %.2f C",
+                 cal.gain, cal.offset);
+        state_unlock();
+    }
+    LOG_FMT(LOG_LEVEL_INFO, "Calibration saved: %s gain=%.4f offset=%.2f (%d point(s))",
+            probeRoleKey(s.role), cal.gain, cal.offset, s.pointCount);
+    return true;
+}
+
+void calibration_cancel() {
+    if (!state_lock()) return;
+    session.active = false;
+    session.capturing = false;
+    snprintf(session.message, sizeof(session.message), "Przerwano");
+    state_unlock();
+}
+
+String calibration_getStatusJSON() {
+    char json[384];
+    if (!state_lock()) return String("{\"active\":false}");
+    int offset = snprintf(json, sizeof(json),
+        "{\"active\":%s,\"role\":\"%s\",\"capturing\":%s,\"samples\":%d,\"needed\":%d,"
+        "\"message\":\"%s\",\"points\":[",
+        session.active ? "true" : "false",
+        probeRoleKey(session.role),
+        session.capturing ? "true" : "false",
+        session.samples, CAL_CAPTURE_SAMPLES, session.message);
+    for (int i = 0; i < session.pointCount; i++) {
+        offset += snprintf(json + offset, sizeof(json) - offset, "%s{\"raw\":%.3f,\"ref\":%.3f}",
+                           i ? "," : "", session.points[i].raw, session.points[i].ref);
+    }
+    state_unlock();
+    snprintf(json + offset, sizeof(json) - offset, "]}");
+    return String(json);
+}
@@ -0,0 +1,37 @@
+// calibration.h - Kalibracja czujników (offset + wzmocnienie) per identyfikator kanału
+// Współczynniki siedzą w NVS pod kluczem z adresu ROM, więc idą za sondą
+// niezależnie od jej pozycji na magistrali. Rdzeń czujników trzyma kopię
+// per kanał – na odczyt przypada jedno mnożenie i dodawanie.
+// Kalibracja prowadzona: wybór roli → punkty referencyjne (lód, wrzątek,
+// termometr wzorcowy) → wyliczenie prostej metodą najmniejszych kwadratów.
+#pragma once
+#include <Arduino.h>
+
+struct SensorCal {
+    float gain;
+    float offset;
+};
+
+static constexpr SensorCal SENSOR_CAL_IDENTITY = {1.0f, 0.0f};
+
+inline double calibration_apply(const SensorCal& cal, double raw) {
+    return raw * cal.gain + cal.offset;
+}
+
+// Zapis w NVS ("sensor_cal") po 8-bajtowym identyfikatorze kanału
+SensorCal calibration_load(const uint8_t* id);
+bool calibration_store(const uint8_t* id, const SensorCal& cal);
+bool calibration_erase(const uint8_t* id);
+// Stała czasowa sondy [s] (kompensacja opóźnienia); 0 = nieznana, zapis 0 kasuje
+float calibration_loadTau(const uint8_t* id);
+bool calibration_storeTau(const uint8_t* id, float tau);
+
+// Sesja kalibracji (web → task czujników)
+bool calibration_begin(int role, const uint8_t* id);
+bool calibration_capture(double refTemp);
+// Surowy odczyt roli (przed kalibracją) – wołane z toru odczytu
+void calibration_feed(int role, double raw);
+// Wylicza i zapisuje współczynniki; false + opis błędu w err
+bool calibration_finish(char* err, size_t errLen);
+void calibration_cancel();
+String calibration_getStatusJSON();
@@ -16,6 +16,7 @@
 // 1. DEFINICJE PINÓW
 // ======================================================
 #define PIN_ONEWIRE 4
+#define PIN_ONEWIRE2 -1   // druga magistrala OneWire (tylko RMT); -1 = brak
 #define PIN_SSR1 12
 #define PIN_SSR2 13
 #define PIN_SSR3 14
@@ -28,6 +29,12 @@
 #define PIN_BTN_ENTER   16
 #define PIN_BTN_EXIT    21
 #define PIN_SD_CS 5
+#define PIN_ZERO_CROSS -1   // detektor przejścia sieci przez zero (np. 34); -1 = podstawa czasu z timera
+// Termopary SPI (MAX31855 / MAX6675) na wspólnej magistrali z TFT i SD; -1 = brak
+#define PIN_TC1_CS -1
+#define PIN_TC2_CS -1
+#define TC1_TYPE SensorBackend::MAX31855
+#define TC2_TYPE SensorBackend::MAX6675
 #define TFT_CS 15
 #define TFT_DC 2
 #define TFT_RST 22
@@ -45,6 +52,32 @@ constexpr int SCREEN_HEIGHT = 160;
 constexpr int LEDC_FREQ = 5000;
 constexpr int LEDC_RESOLUTION = 8;
 
+// --- Wyjścia SSR grzałek ---
+// SSR z przełączaniem w zerze nie nadążają za PWM 5 kHz (moc nieliniowa
+// względem wypełnienia). Tryb pakietowy: całe połówki sieci rozłożone
+// równomiernie (Bresenham), zliczane z detektora zera lub z timera.
+constexpr bool CFG_SSR_BURST = true;                 // false = PWM LEDC (SSR losowe)
+constexpr int CFG_MAINS_HZ = 50;
+constexpr unsigned long SSR_HALF_CYCLE_US = 500000UL / CFG_MAINS_HZ;
+constexpr uint16_t SSR_DUTY_FULL = 1000;             // wypełnienie w promilach (0.1 %)
+constexpr uint16_t SSR_WINDOW_HALF_CYCLES = 100;     // okno pomiaru mocy oddanej (1 s przy 50 Hz)
+constexpr unsigned long SSR_ZC_LOSS_HALF_CYCLES = 5; // brak zboczy dłużej = timer
+constexpr unsigned long SSR_ZC_MIN_GAP_US = SSR_HALF_CYCLE_US * 6 / 10; // wcześniejsze zbocze = zakłócenie
+// Tryb okna czasowego: grzałki kolejno po sobie w oknie (mniej równoczesnych załączeń)
+constexpr unsigned long SSR_WINDOW_DEFAULT_MS = 2000;
+constexpr unsigned long SSR_WINDOW_MIN_MS = 200;
+constexpr unsigned long SSR_WINDOW_MAX_MS = 10000;
+// Wyrównanie zużycia: obciążenie bazowe bierze grzałka z najkrótszym czasem pracy (NVS "heat_rt")
+constexpr int HEATER_COUNT = 3;
+constexpr unsigned long HEATER_RUNTIME_SAVE_MS = 600000UL;  // zapis do NVS co 10 min (zużycie flash)
+constexpr double HEATER_ROTATE_HYST_SEC = 1800.0;           // różnica czasu pracy wymuszająca zmianę w trakcie grzania
+// Budżet mocy przyłącza (wspólny obwód kilku wędzarni); limit 0 = bez ograniczenia
+constexpr uint16_t POWER_HEATER_W_DEFAULT = 2000;
+constexpr uint16_t POWER_SMOKE_W_DEFAULT = 300;
+constexpr uint16_t POWER_LIMIT_W_DEFAULT = 0;
+constexpr uint16_t POWER_W_MAX = 20000;                      // walidacja wartości z API/NVS
+constexpr unsigned long POWER_LIMIT_LOG_HOLD_MS = 5000;      // koniec ograniczenia po tylu ms bez niego
+
 // --- PID ---
 constexpr double CFG_Kp = 5.0;
 constexpr double CFG_Ki = 0.3;
@@ -87,11 +120,154 @@ constexpr unsigned long TEMP_REQUEST_INTERVAL = 1200;
 constexpr unsigned long TEMP_CONVERSION_TIME = 850;
 constexpr int SENSOR_ERROR_THRESHOLD = 3;
 constexpr unsigned long SENSOR_READ_TIMEOUT = 100;
+constexpr int MAX_SENSORS = 16;                // cała tablica ROM DS18B20 (wszystkie magistrale), >= liczba ról
+// Adaptacyjna rozdzielczość DS18B20 (czujnik komory)
+constexpr uint8_t SENSOR_RES_STEADY = 12;        // 0.0625 C, 750 ms
+constexpr uint8_t SENSOR_RES_FAST = 10;          // 0.25 C, 188 ms
+constexpr uint8_t SENSOR_RES_FASTEST = 9;        // 0.5 C, 94 ms
+constexpr double RES_RATE_FAST = 0.05;           // C/s – powyżej: SENSOR_RES_FAST
+constexpr double RES_RATE_FASTEST = 0.2;         // C/s – powyżej: SENSOR_RES_FASTEST
+constexpr unsigned long RES_RATE_WINDOW = 10000; // okno liczenia szybkości zmian
+constexpr unsigned long RES_STEADY_HOLD_MS = 30000;
+// Magistrale OneWire (PIN_ONEWIRE, PIN_ONEWIRE2) – każda z własnym kanałem RX+TX RMT
+constexpr int ONEWIRE_BUS_COUNT = 2;
+constexpr bool CFG_ONEWIRE_USE_RMT = true;     // false = bit-bang (OneWire/DallasTemperature)
+// Analizator magistrali (/api/sensors/bus): liczniki błędów i przebieg linii per sonda
+constexpr bool CFG_BUS_ANALYZER = true;         // stan po starcie, przełączany z API
+constexpr uint16_t BUS_RISE_WARN_US = 10;       // "1" w slocie odczytu dłuższe = słabe narastanie
+constexpr double BUS_ERROR_RATE_WARN = 0.02;    // udział błędnych transakcji sondy
+constexpr bool CFG_TIMING_MEASUREMENT = false; // pomiar blokowania/jittera tasków (porównanie sterowników)
+constexpr unsigned long TIMING_REPORT_INTERVAL = 60000;
+
+// Termopary: MAX31855 konwertuje ~100 ms, MAX6675 ~220 ms (odczyt przerywa konwersję)
+constexpr int MAX_THERMOCOUPLES = 2;
+constexpr int MAX_CHANNELS = MAX_SENSORS + MAX_THERMOCOUPLES;
+constexpr uint32_t TC_SPI_CLOCK = 4000000;
+constexpr unsigned long TC_READ_INTERVAL_MAX31855 = 200;
+constexpr unsigned long TC_READ_INTERVAL_MAX6675 = 250;
+
+// Filtr szpilek i statystyki jakości odczytów (per czujnik)
+constexpr int MEDIAN_WINDOW = 5;                 // okno mediany (nieparzyste)
+constexpr double MEDIAN_SPIKE_LIMIT = 3.0;       // [C] odchyłka od mediany = szpilka
+constexpr double QUALITY_RATE_ALPHA = 0.02;      // ~50 ostatnich odczytów
+constexpr double QUALITY_WARN_RATE = 0.05;       // >5% błędnych odczytów = ostrzeżenie
+
+// Kalibracja czujników (offset + wzmocnienie, per adres ROM)
+constexpr int CAL_MAX_POINTS = 3;
+constexpr int CAL_CAPTURE_SAMPLES = 10;          // uśredniane odczyty na punkt
+constexpr double CAL_MAX_SPREAD = 0.3;           // [C] rozrzut próbek punktu
+constexpr double CAL_MIN_SPAN = 10.0;            // [C] min. odstęp punktów dla wzmocnienia
+constexpr double CAL_GAIN_MIN = 0.9;
+constexpr double CAL_GAIN_MAX = 1.1;
+constexpr double CAL_MAX_OFFSET = 5.0;           // [C]
+
+// --- Estymator temperatury (filtr Kalmana: temperatura + szybkość zmian) ---
+constexpr double ESTIMATOR_Q_CHAMBER = 0.002;     // szum procesu komory [C^2/s^3]
+constexpr double ESTIMATOR_Q_MEAT = 0.0001;       // mięso zmienia się wolno
+constexpr double ESTIMATOR_SENSOR_NOISE = 0.02;   // szum DS18B20 ponad kwantyzację [C]
+constexpr double ESTIMATOR_RATE_VAR0 = 0.01;      // początkowa niepewność szybkości [(C/s)^2]
+constexpr double ESTIMATOR_GATE_SIGMA = 4.0;      // większa innowacja = skok (drzwi)
+constexpr double ESTIMATOR_CONF_SIGMA = 0.25;     // odchylenie [C] dla ufności 50%
+constexpr unsigned long ESTIMATOR_STALE_MS = 10000;  // zanik ufności bez nowych odczytów
+constexpr unsigned long ESTIMATOR_MAX_GAP_MS = 60000; // dłuższa przerwa = ponowna inicjalizacja
+
+// --- Kompensacja opóźnienia sondy (model 1. rzędu, tau per adres ROM) ---
+constexpr double LAG_TAU_DEFAULT_CHAMBER = 20.0;  // [s] sonda nierdzewna w ruchomym powietrzu
+constexpr double LAG_TAU_DEFAULT_MEAT = 0.0;      // 0 = bez kompensacji do pierwszej identyfikacji
+constexpr double LAG_TAU_MIN = 2.0;
+constexpr double LAG_TAU_MAX = 120.0;
+constexpr double LAG_MAX_CORRECTION = 10.0;       // [C] maks. korekta tau * dT/dt
+constexpr double LAG_ID_MIN_RATE = 0.05;          // [C/s] próg wykrycia skoku
+constexpr unsigned long LAG_ID_MAX_RISE_MS = 15000; // szczyt pochodnej później = nie skok
+constexpr int LAG_ID_MIN_SAMPLES = 5;
+constexpr double LAG_ID_ALPHA = 0.3;              // waga nowego dopasowania
+
+// --- Redundancja komory: głosowanie sond (mediana 2 z 3) ---
+constexpr int CHAMBER_PROBES_MAX = 3;             // główna + 2 zapasowe
+constexpr unsigned long VOTE_MAX_AGE_MS = 3000;   // starszy odczyt nie głosuje
+constexpr double VOTE_DISAGREE_LIMIT = 2.0;       // [C] odchyłka od mediany = niezgodność
+
+// --- Wiele sond mięsa (różne kawałki na jednym ruszcie) ---
+constexpr int MEAT_PROBES_MAX = 8;                // główna + 7 dodatkowych
+constexpr unsigned long MEAT_PROBE_INTERVAL_MS = 5000; // okres sond dodatkowych – komora ma pierwszeństwo
+constexpr unsigned long MEAT_MAX_AGE_MS = 30000;  // starszy odczyt = brak wartości
+constexpr unsigned long MEAT_PROBE_LOST_MS = MEAT_MAX_AGE_MS * 4; // reguła ALL pomija sondę bez odczytu
+
+// --- Sonda temperatury otoczenia + feedforward strat ciepła ---
+constexpr unsigned long AMBIENT_PROBE_INTERVAL_MS = 10000;
+constexpr unsigned long AMBIENT_MAX_AGE_MS = 60000;
+constexpr double FF_GAIN = 0.8;                   // część strat pokrywana z góry (reszta: PID)
+constexpr double FF_MAX_DUTY = 70.0;              // [%] maks. udział feedforward
+constexpr double FF_MIN_DELTA = 10.0;             // [C] komora - otoczenie do uczenia
+constexpr double FF_LEARN_MAX_ERROR = 1.0;        // [C] stan ustalony: |setpoint - komora|
+constexpr double FF_LEARN_MAX_RATE = 0.005;       // [C/s] stan ustalony: szybkość zmian
+constexpr unsigned long FF_LEARN_INTERVAL_MS = 60000;
+constexpr double FF_LEARN_ALPHA = 0.1;
+constexpr double FF_K_MIN = 0.001;                // [grzałka/C] zakres współczynnika strat
+constexpr double FF_K_MAX = 0.2;
+constexpr unsigned long FF_SAVE_INTERVAL_MS = 1800000UL;
+
+// --- Wirtualny czujnik komory (model cieplny po utracie sondy) ---
+constexpr unsigned long VCH_SAMPLE_MS = 5000;     // krok uczenia / całkowania modelu
+constexpr unsigned long VCH_FRESH_MS = 3000;      // odczyt komory młodszy = uczenie
+constexpr unsigned long VCH_STALE_MS = 15000;     // brak odczytów dłużej = przejęcie
+constexpr unsigned long VCH_MAX_MS = 3600000UL;   // maks. praca na modelu (potem PAUSE_SENSOR)
+constexpr unsigned long VCH_MIN_SAMPLES = 120;    // 10 min uczenia przed pierwszym użyciem
+constexpr double VCH_T_NORM = 50.0;               // [C] normalizacja regresorów
+constexpr double VCH_TAU_DEFAULT_MIN = 30.0;      // [min] model startowy
+constexpr double VCH_GAIN_DEFAULT = 40.0;         // [C] przyrost na grzałkę przy 100%
+constexpr double VCH_AMBIENT_DEFAULT = 20.0;
+constexpr double VCH_AMBIENT_MIN = -20.0;
+constexpr double VCH_TAU_MIN_MIN = 3.0;           // [min] wiarygodny zakres stałej czasowej
+constexpr double VCH_TAU_MAX_MIN = 240.0;
+constexpr double VCH_RLS_LAMBDA = 0.998;          // zapominanie (~40 min pamięci)
+constexpr double VCH_RLS_P0 = 1.0;
+constexpr double VCH_MIN_CONFIDENCE = 0.5;        // estymata komory do uczenia
+constexpr double VCH_MEAT_MIN_DIFF = 5.0;         // [C] różnica komora-mięso do uczenia km
+constexpr double VCH_KM_MIN = 0.001;              // [1/min]
+constexpr double VCH_MEAT_BLEND = 0.05;           // waga korekty z sondy mięsa na krok
+constexpr double VCH_SETPOINT_DROP = 10.0;        // [C] obniżenie setpointu na modelu
+constexpr double VCH_SETPOINT_MAX = 80.0;         // [C] górna granica setpointu na modelu
+
+// --- Predykcja czasu dojścia mięsa (ETA) ---
+constexpr unsigned long ETA_SAMPLE_MS = 30000;
+constexpr double ETA_MIN_DIFF = 5.0;              // [C] komora - mięso do uczenia
+constexpr double ETA_LAMBDA = 0.98;               // zapominanie na próbkę (~25 min pamięci)
+constexpr unsigned long ETA_MIN_SAMPLES = 10;
+constexpr double ETA_K_MIN = 0.0005;              // [1/min] zakres stałej wymiany ciepła
+constexpr double ETA_K_MAX = 0.5;
+constexpr double ETA_MIN_MARGIN = 1.0;            // [C] setpoint musi przewyższać cel mięsa
+constexpr unsigned long ETA_MAX_SEC = 172800UL;   // 48 h – dalej = nieosiągalne
+
+// --- Detekcja plateau mięsa (stall) ---
+constexpr unsigned long STALL_SAMPLE_MS = 300000UL;   // próbka co 5 min
+constexpr int STALL_WINDOW_SAMPLES = 12;              // okno nachylenia: 1 h
+constexpr double STALL_MAX_SLOPE = 1.0;               // [C/h] wolniej = plateau
+constexpr double STALL_MEAT_MIN = 55.0;               // [C] poniżej to nie parowanie
+constexpr double STALL_CHAMBER_BAND = 3.0;            // [C] komora na setpoincie
+constexpr double STALL_RAISE_STEP = 5.0;              // [C] podniesienie setpointu
+constexpr double STALL_RAISE_MAX = 15.0;              // [C] łącznie w jednym kroku
+
+// --- Autotune PID (oscylacja przekaźnikowa Åström–Hägglund) ---
+constexpr double AT_RELAY_HIGH = 100.0;               // [%] wyjście przekaźnika poniżej setpointu
+constexpr double AT_RELAY_LOW = 0.0;                  // [%] wyjście przekaźnika powyżej setpointu
+constexpr double AT_HYSTERESIS = 0.5;                 // [C] martwa strefa przełączania (szum sondy)
+constexpr int AT_DISCARD_CYCLES = 1;                  // pierwszy cykl = dojście z zimnej komory
+constexpr int AT_CYCLES = 3;                          // cykle uśredniane do Ku/Pu
+constexpr int AT_MAX_CYCLES = 10;                     // bez zbieżności dłużej = przerwanie
+constexpr double AT_CONSISTENCY = 0.2;                // względny rozrzut amplitud/okresów
+constexpr unsigned long AT_MIN_PERIOD_MS = 60000UL;   // krótszy okres = zakłócenie, nie cykl
+constexpr unsigned long AT_TIMEOUT_MS = 4UL * 3600UL * 1000UL;
 
 // --- Stałe przypisania czujników ---
 constexpr int DEFAULT_CHAMBER_SENSOR = 0;
 constexpr int DEFAULT_MEAT_SENSOR = 1;
 constexpr unsigned long SENSOR_ASSIGNMENT_CHECK = 10000;
+// Skan OneWire w tle (hot-plug): jedno urządzenie na obieg tasku, tylko w oknie
+// bez zaplanowanych konwersji/odczytów
+constexpr unsigned long SENSOR_RESCAN_INTERVAL = 30000;
+constexpr unsigned long SENSOR_SCAN_QUIET_MS = 200;   // pełny search() przez RMT ~130 ms
+constexpr int SENSOR_MISS_LIMIT = 2;                  // kolejne skany bez czujnika = usunięcie
 
 // --- Profil ---
 constexpr int MAX_STEPS = 10;
@@ -106,8 +282,34 @@ constexpr int LOG_LEVEL_WARN = 2;
 constexpr int LOG_LEVEL_ERROR = 3;
 constexpr int CURRENT_LOG_LEVEL = LOG_LEVEL_INFO;
 
-// --- Adaptive PID ---
-constexpr unsigned long PID_ADAPTATION_INTERVAL = 60000;
+// --- Harmonogram nastaw PID (gain scheduling) ---
+constexpr int GS_BANDS = 5;
+constexpr double GS_BAND_T[GS_BANDS] = {30.0, 50.0, 70.0, 90.0, 110.0};  // [C] punkty węzłowe setpointu
+constexpr double GS_MIN_CHANGE = 0.01;            // względna zmiana nastaw = przełączenie
+
+// --- Model FOPDT + regulator predykcyjny (MPC) ---
+constexpr unsigned long MPC_SAMPLE_MS = 10000;
+constexpr int MPC_MAX_DEAD = 18;                  // [próbki] kandydaci opóźnienia 0..180 s
+constexpr int MPC_HORIZON = 18;                   // [próbki] horyzont predykcji za opóźnieniem
+constexpr double MPC_MOVE_WEIGHT = 2.0;           // kara zmiany wyjścia [C^2 / grzałkę^2]
+constexpr double MPC_RLS_LAMBDA = 0.998;          // zapominanie (~55 min pamięci)
+constexpr double MPC_ERR_ALPHA = 0.02;            // wygładzanie błędu kandydatów opóźnienia
+constexpr double MPC_BIAS_ALPHA = 0.2;            // estymata zakłócenia (bez uchybu ustalonego)
+constexpr unsigned long MPC_MIN_SAMPLES = 60;     // 10 min identyfikacji przed użyciem
+constexpr double MPC_SETTLE_BAND = 1.0;           // [C] pasmo ustalenia w symulacji
+constexpr int MPC_BENCH_MAX_MIN = 480;
+
+// --- Powrót po otwarciu drzwi (zamrożenie PID + dodatek wypełnienia) ---
+constexpr double DOOR_REC_GAIN = 0.7;                 // część deficytu ciepła pokrywana z góry
+constexpr double DOOR_REC_MIN_DROP = 0.5;             // [C] mniejszy spadek = bez dodatku
+constexpr double DOOR_REC_MAX_BOOST = 60.0;           // [%] maks. dodatek wypełnienia
+constexpr unsigned long DOOR_REC_TAU_MIN_MS = 300000UL;   // zanik dodatku: 5 min + połowa otwarcia
+constexpr unsigned long DOOR_REC_TAU_MAX_MS = 900000UL;
+constexpr double DOOR_REC_BAND = 1.0;                 // [C] koniec powrotu, zwolnienie całki
+constexpr unsigned long DOOR_REC_WATCH_MS = 600000UL; // pomiar przeregulowania po dojściu
+constexpr unsigned long DOOR_REC_MAX_MS = 1800000UL;
+constexpr double DOOR_REC_EMA_ALPHA = 0.01;           // wygładzanie wyjścia co obieg (~10 s)
+constexpr unsigned long DOOR_SIM_TAU_SEC = 120;       // symulacja: wymiana powietrza przy otwartych drzwiach
 
 // --- Progi pamięci ---
 constexpr uint32_t HEAP_WARNING_THRESHOLD = 20000;
@@ -146,7 +348,56 @@ enum class ProcessState {
     PAUSE_USER,
     ERROR_PROFILE,
     SOFT_RESUME,
-    PAUSE_HEATER_FAULT
+    PAUSE_HEATER_FAULT,
+    AUTOTUNE
+};
+
+// Harmonogram wyjść SSR w silniku pakietowym (NVS "ssr_mode", "ssr_win")
+enum class SsrMode : uint8_t {
+    BURST,                         // połówki sieci rozłożone równomiernie, fazy kanałów przesunięte
+    WINDOW                         // okno czasowe: załączenia grzałek kolejno, bez nakładania
+};
+
+// Budżet mocy (NVS "pwr_budget"): moc znamionowa odbiorników i limit przyłącza [W]
+struct PowerBudget {
+    uint16_t heaterW[HEATER_COUNT];
+    uint16_t smokeW;
+    uint16_t limitW;               // 0 = bez ograniczenia
+    bool smokeFirst;               // true: dym obsłużony przed grzałkami, false: grzałki pierwsze
+};
+
+// Silnik regulacji komory (NVS "ctl_engine")
+enum class ControlEngine : uint8_t {
+    PID,
+    MPC                            // model FOPDT + predykcja; PID do czasu nauczenia modelu
+};
+
+enum class SensorBackend : uint8_t {
+    DS18B20,
+    MAX31855,
+    MAX6675
+};
+
+// Źródło wejścia PID (temperatura komory)
+enum class PidInputSource {
+    RAW,            // ostatni odczyt po filtrze szpilek
+    FILTERED,       // estymator (Kalman)
+    COMPENSATED     // estymator + kompensacja opóźnienia sondy
+};
+
+// Warunek przejścia kroku po temperaturze mięsa przy kilku sondach
+enum class MeatRule : uint8_t {
+    MIN,            // najzimniejsza sprawna sonda osiągnęła cel
+    MEAN,           // średnia sprawnych sond
+    ALL             // każda przypisana sonda choć raz osiągnęła cel w tym kroku
+};
+
+// Reakcja na plateau mięsa w kroku z warunkiem temperatury mięsa
+enum class StallAction : uint8_t {
+    NONE,           // krok czeka jak dotąd
+    RAISE,          // podniesienie setpointu komory o STALL_RAISE_STEP
+    NOTIFY,         // sygnał dźwiękowy + flaga w /status
+    WRAP            // przejście do następnego kroku (np. zawijanie w papier)
 };
 
 enum class RunMode {
@@ -181,6 +432,8 @@ struct Step {
     unsigned long fanOnTime;
     unsigned long fanOffTime;
     bool useMeatTemp;
+    MeatRule meatRule;
+    StallAction stallAction;
 };
 
 struct ProcessStats {
@@ -192,6 +445,14 @@ struct ProcessStats {
     unsigned long lastUpdate;
     unsigned long totalProcessTimeSec;
     unsigned long remainingProcessTimeSec;
+    long stepEtaSec;               // pozostały czas bieżącego kroku z ETA mięsa (-1 = nieznany)
+    bool etaPredicted;             // remainingProcessTimeSec uwzględnia ETA wszystkich kroków
+};
+
+// Nastawy PID dla jednego trybu mocy (z autotune lub domyślne CFG_K*)
+struct PidGains {
+    double kp, ki, kd;
+    bool tuned;
 };
 
 // ======================================================
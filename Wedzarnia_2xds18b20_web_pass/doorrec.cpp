@@ -0,0 +1,149 @@
+// doorrec.cpp - Zamrożenie/przywrócenie PID przy drzwiach i pomiar czasu powrotu
+#include "doorrec.h"
+#include "config.h"
+#include "mpc.h"
+
+struct DoorRecovery {
+    // Praca ustalona
+    double dutyEma;
+    bool emaValid;
+    // Zamrożenie
+    bool frozen;
+    double frozenDuty;
+    double tOpen;
+    unsigned long openMs;
+    // Powrót
+    bool active;
+    bool reached;                  // komora w paśmie DOOR_REC_BAND
+    unsigned long resumeMs;
+    unsigned long reachedMs;
+    unsigned long openDurationMs;
+    unsigned long tauMs;
+    double drop;
+    double boost0;
+    double overshoot;
+    // Wyniki
+    unsigned long count;
+    long lastRecoverySec;          // -1 = nie dojechał w DOOR_REC_MAX_MS
+    double lastOvershoot;
+    double lastDrop;
+    unsigned long lastOpenSec;
+    double lastBoost;
+    double avgRecoverySec;
+};
+
+static DoorRecovery dr = {};
+
+void doorrec_track(double duty) {
+    if (dr.active || isnan(duty)) return;
+    if (!dr.emaValid) {
+        dr.dutyEma = duty;
+        dr.emaValid = true;
+    } else {
+        dr.dutyEma += DOOR_REC_EMA_ALPHA * (duty - dr.dutyEma);
+    }
+}
+
+static void finish(unsigned long nowMs, bool completed) {
+    dr.active = false;
+    if (!completed) return;
+    dr.count++;
+    dr.lastRecoverySec = dr.reached ? (long)((dr.reachedMs - dr.resumeMs) / 1000UL) : -1;
+    dr.lastOvershoot = dr.overshoot;
+    dr.lastDrop = dr.drop;
+    dr.lastOpenSec = dr.openDurationMs / 1000UL;
+    dr.lastBoost = dr.boost0;
+    if (dr.lastRecoverySec >= 0) {
+        dr.avgRecoverySec = (dr.avgRecoverySec == 0.0) ? dr.lastRecoverySec
+                          : dr.avgRecoverySec + 0.2 * (dr.lastRecoverySec - dr.avgRecoverySec);
+    }
+    LOG_FMT(LOG_LEVEL_INFO, "Door recovery: open %lus, drop %.1f C, boost %.0f%%, back in %lds, overshoot %.1f C",
+            dr.lastOpenSec, dr.lastDrop, dr.lastBoost, dr.lastRecoverySec, dr.lastOvershoot);
+}
+
+void doorrec_freeze(unsigned long nowMs, double tChamber) {
+    // Drzwi otwarte w trakcie powrotu – poprzedni pomiar nieważny,
+    // zamrożona całka zostaje ta sprzed pierwszego otwarcia
+    bool wasRecovering = dr.active;
+    if (wasRecovering) {
+        finish(nowMs, false);
+    } else {
+        if (dr.emaValid) dr.frozenDuty = dr.dutyEma;
+        if (!isnan(tChamber)) dr.tOpen = tChamber;
+    }
+    dr.frozen = dr.emaValid;
+    dr.openMs = nowMs;
+}
+
+unsigned long doorrec_planTauMs(unsigned long openMs) {
+    return constrain(DOOR_REC_TAU_MIN_MS + openMs / 2, DOOR_REC_TAU_MIN_MS, DOOR_REC_TAU_MAX_MS);
+}
+
+double doorrec_planBoost(double drop, unsigned long openMs, int powerMode,
+                         double gainPerHeater, double tauMin) {
+    if (drop <= DOOR_REC_MIN_DROP || gainPerHeater <= 0.0 || powerMode <= 0) return 0.0;
+    double tauRecMin = doorrec_planTauMs(openMs) / 60000.0;
+    double heaters = DOOR_REC_GAIN * drop * tauMin / (gainPerHeater * tauRecMin);
+    return constrain(heaters / powerMode * 100.0, 0.0, DOOR_REC_MAX_BOOST);
+}
+
+bool doorrec_begin(unsigned long nowMs, double tChamber, int powerMode, double* duty) {
+    if (!dr.frozen) return false;
+    dr.frozen = false;
+
+    // Model z identyfikacji FOPDT, a bez niego – model startowy komory
+    double gain = VCH_GAIN_DEFAULT, tau = VCH_TAU_DEFAULT_MIN;
+    mpc_getModel(&gain, &tau);
+
+    dr.openDurationMs = nowMs - dr.openMs;
+    dr.drop = isnan(tChamber) ? 0.0 : max(0.0, dr.tOpen - tChamber);
+    dr.tauMs = doorrec_planTauMs(dr.openDurationMs);
+    dr.boost0 = doorrec_planBoost(dr.drop, dr.openDurationMs, powerMode, gain, tau);
+    dr.resumeMs = nowMs;
+    dr.reached = false;
+    dr.overshoot = 0.0;
+    dr.active = true;
+    *duty = dr.frozenDuty;
+
+    LOG_FMT(LOG_LEVEL_INFO, "Door recovery: drop %.1f C after %lus, duty %.1f%%, boost %.0f%% (tau %lus)",
+            dr.drop, dr.openDurationMs / 1000UL, dr.frozenDuty, dr.boost0, dr.tauMs / 1000UL);
+    return true;
+}
+
+double doorrec_boost(unsigned long nowMs) {
+    if (!dr.active || dr.reached || dr.boost0 <= 0.0) return 0.0;
+    double b = dr.boost0 * exp(-(double)(nowMs - dr.resumeMs) / dr.tauMs);
+    return (b < 0.5) ? 0.0 : b;
+}
+
+bool doorrec_active() {
+    return dr.active;
+}
+
+void doorrec_observe(unsigned long nowMs, double error) {
+    if (!dr.active || isnan(error)) return;
+    if (!dr.reached) {
+        if (fabs(error) <= DOOR_REC_BAND) {
+            dr.reached = true;
+            dr.reachedMs = nowMs;
+        } else if (nowMs - dr.resumeMs >= DOOR_REC_MAX_MS) {
+            finish(nowMs, true);
+        }
+        return;
+    }
+    dr.overshoot = max(dr.overshoot, -error);
+    if (nowMs - dr.reachedMs >= DOOR_REC_WATCH_MS) finish(nowMs, true);
+}
+
+String doorrec_getStatusJSON() {
+    char buf[384];
+    snprintf(buf, sizeof(buf),
+        "{\"frozen\":%s,\"active\":%s,\"reached\":%s,\"boost\":%.1f,\"duty\":%.1f,"
+        "\"count\":%lu,\"last\":{\"openSec\":%lu,\"drop\":%.1f,\"boost\":%.1f,\"recoverySec\":%ld,\"overshoot\":%.2f},"
+        "\"avgRecoverySec\":%.0f}",
+        dr.frozen ? "true" : "false", dr.active ? "true" : "false", dr.reached ? "true" : "false",
+        doorrec_boost(millis()), dr.frozenDuty,
+        dr.count, dr.lastOpenSec, dr.lastDrop, dr.lastBoost, dr.lastRecoverySec, dr.lastOvershoot,
+        dr.avgRecoverySec);
+    return String(buf);
+}
@@ -0,0 +1,29 @@
+// doorrec.h - Powrót regulatora po otwarciu drzwi (PAUSE_DOOR -> SOFT_RESUME)
+// Przy otwarciu zamrażane jest wygładzone wypełnienie z pracy ustalonej
+// (= całka + ff). Przy zamknięciu wraca do całki bez kopnięcia pochodnej,
+// a deficyt ciepła pokrywa zanikający wykładniczo dodatek
+// wypełnienia: deltaU = DOOR_REC_GAIN * spadek * tau_obiektu / (K * tau_powrotu),
+// tau_powrotu rośnie z czasem otwarcia (wystygłe ściany). Dodatek kończy się
+// przy wejściu w pasmo DOOR_REC_BAND – resztę przejmuje całka.
+#pragma once
+#include <Arduino.h>
+
+// Wygładzanie wyjścia regulatora w pracy ustalonej – task sterowania, co obieg
+void doorrec_track(double duty);
+// Zbocze wejścia w PAUSE_DOOR
+void doorrec_freeze(unsigned long nowMs, double tChamber);
+// Zbocze PAUSE_DOOR -> SOFT_RESUME; false = brak zamrożonego stanu.
+// *duty = wypełnienie sprzed otwarcia do przywrócenia
+bool doorrec_begin(unsigned long nowMs, double tChamber, int powerMode, double* duty);
+// Dodatek wypełnienia powrotu [%] (0 poza powrotem i po dojściu w pasmo)
+double doorrec_boost(unsigned long nowMs);
+bool doorrec_active();
+// Pomiar czasu powrotu i przeregulowania; error = setpoint - komora
+void doorrec_observe(unsigned long nowMs, double error);
+
+// Plan powrotu (też dla symulacji): dodatek [%] i stała zaniku [ms]
+double doorrec_planBoost(double drop, unsigned long openMs, int powerMode,
+                         double gainPerHeater, double tauMin);
+unsigned long doorrec_planTauMs(unsigned long openMs);
+
+String doorrec_getStatusJSON();
@@ -0,0 +1,111 @@
+// estimator.cpp - Filtr Kalmana temperatury (stan: temperatura, szybkość zmian)
+#include "estimator.h"
+#include "config.h"
+#include "state.h"
+
+struct KalmanState {
+    double x0, x1;           // temperatura [C], szybkość [C/s]
+    double p00, p01, p11;    // kowariancja (symetryczna)
+    unsigned long lastMs;
+    bool initialized;
+};
+
+// Stan filtra – tylko task czujników; wynik publikowany pod state_lock()
+static KalmanState kf[EST_CHANNELS] = {};
+
+struct PublishedEstimate {
+    TempEstimate est;
+    unsigned long updatedMs;
+};
+
+static PublishedEstimate published[EST_CHANNELS] = {};
+
+static double processNoise(EstChannel ch) {
+    return (ch == EST_CHAMBER) ? ESTIMATOR_Q_CHAMBER : ESTIMATOR_Q_MEAT;
+}
+
+TempEstimate estimator_update(EstChannel ch, double z, double quantStep, unsigned long nowMs) {
+    KalmanState& k = kf[ch];
+    // Kwantyzacja (rozkład jednostajny: q^2/12) + szum własny czujnika
+    double r = quantStep * quantStep / 12.0 + ESTIMATOR_SENSOR_NOISE * ESTIMATOR_SENSOR_NOISE;
+
+    if (!k.initialized || nowMs - k.lastMs > ESTIMATOR_MAX_GAP_MS) {
+        k.x0 = z;
+        k.x1 = 0.0;
+        k.p00 = r;
+        k.p01 = 0.0;
+        k.p11 = ESTIMATOR_RATE_VAR0;
+        k.initialized = true;
+    } else {
+        double dt = (nowMs - k.lastMs) / 1000.0;
+        if (dt <= 0.0) dt = 0.001;
+        double q = processNoise(ch);
+        double dt2 = dt * dt;
+
+        // Predykcja: x = F x, P = F P F' + Q (biały szum przyspieszenia)
+        k.x0 += k.x1 * dt;
+        k.p00 += 2.0 * dt * k.p01 + dt2 * k.p11 + q * dt2 * dt / 3.0;
+        k.p01 += dt * k.p11 + q * dt2 / 2.0;
+        k.p11 += q * dt;
+
+        // Korekcja
+        double y = z - k.x0;
+        double s = k.p00 + r;
+        if (y * y > ESTIMATOR_GATE_SIGMA * ESTIMATOR_GATE_SIGMA * s) {
+            // Skok (otwarte drzwi, zmiana czujnika) – zwiększenie niepewności,
+            // żeby filtr szybko dogonił pomiar zamiast go odrzucać
+            k.p00 += y * y;
+            s = k.p00 + r;
+        }
+        double k0 = k.p00 / s;
+        double k1 = k.p01 / s;
+        k.x0 += k0 * y;
+        k.x1 += k1 * y;
+
+        double p00 = k.p00, p01 = k.p01;
+        k.p00 = (1.0 - k0) * p00;
+        k.p01 = (1.0 - k0) * p01;
+        k.p11 -= k1 * p01;
+    }
+    k.lastMs = nowMs;
+
+    TempEstimate est;
+    est.temp = k.x0;
+    est.rate = k.x1;
+    est.confidence = 1.0 / (1.0 + sqrt(k.p00) / ESTIMATOR_CONF_SIGMA);
+    est.valid = true;
+
+    if (state_lock()) {
+        published[ch].est = est;
+        published[ch].updatedMs = nowMs;
+        state_unlock();
+    }
+    return est;
+}
+
+TempEstimate estimator_get(EstChannel ch) {
+    TempEstimate est = {0.0, 0.0, 0.0, false};
+    unsigned long updatedMs = 0;
+    if (state_lock()) {
+        est = published[ch].est;
+        updatedMs = published[ch].updatedMs;
+        state_unlock();
+    }
+    if (est.valid) {
+        unsigned long age = millis() - updatedMs;
+        est.confidence *= exp(-(double)age / ESTIMATOR_STALE_MS);
+    }
+    return est;
+}
+
+void estimator_reset() {
+    for (int i = 0; i < EST_CHANNELS; i++) {
+        kf[i].initialized = false;
+    }
+    if (state_lock()) {
+        for (int i = 0; i < EST_CHANNELS; i++) {
+            published[i].est.valid = false;
+        }
+        state_unlock();
+    }
+}
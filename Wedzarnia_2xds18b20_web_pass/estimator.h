@@ -0,0 +1,20 @@
+// estimator.h - Estymator stanu temperatury (komora / mięso)
+// Filtr Kalmana o modelu stałej szybkości zmian: z surowych odczytów DS18B20
+// (kwantyzacja 0.0625-0.5 C) liczy przefiltrowaną temperaturę, szybkość zmian
+// i ufność. Zasilany z sensors.cpp, konsumowany przez process.cpp i /status.
+#pragma once
+#include <Arduino.h>
+
+enum EstChannel { EST_CHAMBER = 0, EST_MEAT = 1, EST_CHANNELS = 2 };
+
+struct TempEstimate {
+    double temp;          // przefiltrowana temperatura [C]
+    double rate;          // szybkość zmian [C/s]
+    double confidence;    // 0..1 – niepewność filtra i wiek ostatniego odczytu
+    bool valid;
+};
+
+// Nowy poprawny odczyt; quantStep = krok kwantyzacji przy aktualnej rozdzielczości
+TempEstimate estimator_update(EstChannel ch, double measurement, double quantStep, unsigned long nowMs);
+TempEstimate estimator_get(EstChannel ch);
+void estimator_reset();
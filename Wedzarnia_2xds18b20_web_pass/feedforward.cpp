@@ -0,0 +1,110 @@
+// feedforward.cpp - Feedforward strat ciepła: uczenie współczynnika i udział w wyjściu
+#include "feedforward.h"
+#include "config.h"
+#include "state.h"
+#include "storage.h"
+#include "powerbudget.h"
+
+struct Feedforward {
+    double duty;                   // ostatni udział w wypełnieniu [%]
+    double lastSample;             // ostatnia próbka k [grzałka/C]
+    unsigned long lastLearnMs;
+    unsigned long samples;
+    double savedK;                 // k zapisane w NVS
+    unsigned long lastSaveMs;
+};
+
+static Feedforward ff = {};
+
+static bool isRunning(ProcessState st) {
+    return st == ProcessState::RUNNING_AUTO || st == ProcessState::RUNNING_MANUAL ||
+           st == ProcessState::SOFT_RESUME;
+}
+
+double feedforward_update(unsigned long nowMs, double rate) {
+    if (!state_lock()) return ff.duty;
+    ProcessState st = g_currentState;
+    bool enabled = g_ffEnabled;
+    double k = g_ffLossCoeff;
+    double tAmb = g_tAmbient;
+    double tChamber = pidInput;
+    double error = pidSetpoint - pidInput;
+    double output = pidOutput;
+    int pm = g_powerMode;
+    bool door = g_doorOpen;
+    bool virt = g_chamberVirtual;
+    state_unlock();
+
+    double delta = tChamber - tAmb;
+    bool usable = isRunning(st) && !isnan(tAmb) && !virt && pm > 0;
+
+    // Uczenie tylko w stanie ustalonym: przy setpoincie, bez drzwi, bez
+    // nasycenia wyjścia i bez budżetu mocy – wtedy całe wypełnienie pokrywa straty
+    if (usable && st != ProcessState::SOFT_RESUME && !door && !powerbudget_limiting() &&
+        delta >= FF_MIN_DELTA &&
+        fabs(error) <= FF_LEARN_MAX_ERROR && fabs(rate) <= FF_LEARN_MAX_RATE &&
+        output > 0.5 && output < 99.5 && nowMs - ff.lastLearnMs >= FF_LEARN_INTERVAL_MS) {
+        ff.lastLearnMs = nowMs;
+        double sample = (output / 100.0) * pm / delta;
+        if (sample >= FF_K_MIN && sample <= FF_K_MAX) {
+            k = (k > 0.0) ? k + FF_LEARN_ALPHA * (sample - k) : sample;
+            ff.lastSample = sample;
+            ff.samples++;
+            if (state_lock()) {
+                g_ffLossCoeff = k;
+                state_unlock();
+            }
+            bool changed = ff.savedK <= 0.0 || fabs(k - ff.savedK) > 0.05 * ff.savedK;
+            if (changed && (ff.savedK <= 0.0 || nowMs - ff.lastSaveMs >= FF_SAVE_INTERVAL_MS)) {
+                storage_save_feedforward_nvs();
+                ff.savedK = k;
+                ff.lastSaveMs = nowMs;
+                LOG_FMT(LOG_LEVEL_INFO, "Feedforward loss coefficient: %.4f heater/C", k);
+            }
+        }
+    }
+
+    double duty = 0.0;
+    if (usable && enabled && k > 0.0 && delta > 0.0) {
+        duty = constrain(FF_GAIN * k * delta / pm * 100.0, 0.0, FF_MAX_DUTY);
+    }
+    ff.duty = duty;
+    return duty;
+}
+
+void feedforward_setEnabled(bool enabled) {
+    if (!state_lock()) return;
+    g_ffEnabled = enabled;
+    state_unlock();
+    storage_save_feedforward_nvs();
+    LOG_FMT(LOG_LEVEL_INFO, "Feedforward %s", enabled ? "enabled" : "disabled");
+}
+
+void feedforward_reset() {
+    if (!state_lock()) return;
+    g_ffLossCoeff = 0.0;
+    state_unlock();
+    ff.samples = 0;
+    ff.lastSample = 0.0;
+    ff.savedK = 0.0;
+    storage_save_feedforward_nvs();
+    log_msg(LOG_LEVEL_INFO, "Feedforward loss coefficient reset");
+}
+
+String feedforward_getStatusJSON() {
+    bool enabled = false;
+    double k = 0.0, tAmb = NAN;
+    if (state_lock()) {
+        enabled = g_ffEnabled;
+        k = g_ffLossCoeff;
+        tAmb = g_tAmbient;
+        state_unlock();
+    }
+    char json[320];
+    snprintf(json, sizeof(json),
+        "{\"enabled\":%s,\"ambientValid\":%s,\"ambient\":%.2f,\"kLoss\":%.5f,\"learned\":%s,"
+        "\"samples\":%lu,\"lastSample\":%.5f,\"duty\":%.1f,\"gain\":%.2f,\"maxDuty\":%.0f}",
+        enabled ? "true" : "false", isnan(tAmb) ? "false" : "true", isnan(tAmb) ? 0.0 : tAmb,
+        k, k > 0.0 ? "true" : "false", ff.samples, ff.lastSample, ff.duty, FF_GAIN, FF_MAX_DUTY);
+    return String(json);
+}
@@ -0,0 +1,16 @@
+// feedforward.h - Feedforward strat ciepła komory (sonda otoczenia)
+// Straty w stanie ustalonym ~ k * (T_komory - T_otoczenia), k [grzałka/C]
+// uczone z wypełnienia potrzebnego do utrzymania setpointu. Regulator dostaje
+// z góry FF_GAIN tych strat – całka PID nie musi się nabijać po zmianie
+// pogody, a po otwarciu drzwi wraca szybciej. Bez sondy otoczenia lub
+// przed nauczeniem k feedforward = 0 (czysty PID jak dotąd).
+#pragma once
+#include <Arduino.h>
+
+// Krok w tasku sterowania przed pid.Compute(); rate = szybkość zmian komory [C/s].
+// Zwraca udział feedforward w wypełnieniu [%]
+double feedforward_update(unsigned long nowMs, double rate);
+void feedforward_setEnabled(bool enabled);
+// Zapomnienie nauczonego k (np. po przebudowie komory)
+void feedforward_reset();
+String feedforward_getStatusJSON();
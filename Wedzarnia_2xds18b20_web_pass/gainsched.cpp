@@ -0,0 +1,135 @@
+// gainsched.cpp - Harmonogram nastaw PID: interpolacja po setpoincie i trybie mocy
+#include "gainsched.h"
+#include "state.h"
+#include "storage.h"
+
+// Ostatnie wyszukanie – do podglądu w /api/pid/schedule
+struct GainSchedLast {
+    double setpoint;
+    int powerMode;
+    PidGains gains;
+    bool scheduled;
+};
+
+static GainSchedLast last = {NAN, 0, {CFG_Kp, CFG_Ki, CFG_Kd, false}, false};
+
+static bool validPowerMode(int pm) {
+    return pm >= CFG_POWERMODE_MIN && pm <= CFG_POWERMODE_MAX;
+}
+
+bool gainsched_peek(double setpoint, int powerMode, PidGains* out) {
+    int pm = constrain(powerMode, CFG_POWERMODE_MIN, CFG_POWERMODE_MAX);
+    PidGains row[GS_BANDS];
+    PidGains fallback;
+    if (!state_lock()) {
+        *out = last.gains;
+        return last.scheduled;
+    }
+    memcpy(row, g_gainSchedule[pm - 1], sizeof(row));
+    fallback = g_pidGains[pm - 1];
+    state_unlock();
+
+    // Najbliższe ustawione punkty poniżej i powyżej setpointu
+    int lo = -1, hi = -1;
+    for (int i = 0; i < GS_BANDS; i++) {
+        if (!row[i].tuned) continue;
+        if (GS_BAND_T[i] <= setpoint) lo = i;
+        if (GS_BAND_T[i] >= setpoint && hi < 0) hi = i;
+    }
+
+    bool scheduled = (lo >= 0 || hi >= 0);
+    if (!scheduled) {
+        *out = fallback;
+    } else if (lo < 0 || hi < 0 || lo == hi) {
+        *out = row[lo >= 0 ? lo : hi];
+    } else {
+        double f = (setpoint - GS_BAND_T[lo]) / (GS_BAND_T[hi] - GS_BAND_T[lo]);
+        out->kp = row[lo].kp + f * (row[hi].kp - row[lo].kp);
+        out->ki = row[lo].ki + f * (row[hi].ki - row[lo].ki);
+        out->kd = row[lo].kd + f * (row[hi].kd - row[lo].kd);
+        out->tuned = true;
+    }
+    return scheduled;
+}
+
+bool gainsched_lookup(double setpoint, int powerMode, PidGains* out) {
+    bool scheduled = gainsched_peek(setpoint, powerMode, out);
+    last.setpoint = setpoint;
+    last.powerMode = constrain(powerMode, CFG_POWERMODE_MIN, CFG_POWERMODE_MAX);
+    last.gains = *out;
+    last.scheduled = scheduled;
+    return scheduled;
+}
+
+int gainsched_nearestBand(double setpoint) {
+    int best = 0;
+    for (int i = 1; i < GS_BANDS; i++) {
+        if (fabs(GS_BAND_T[i] - setpoint) < fabs(GS_BAND_T[best] - setpoint)) best = i;
+    }
+    return best;
+}
+
+bool gainsched_setPoint(int powerMode, int band, double kp, double ki, double kd) {
+    if (!validPowerMode(powerMode) || band < 0 || band >= GS_BANDS) return false;
+    if (!(kp > 0.0) || !(ki >= 0.0) || !(kd >= 0.0) ||
+        !isfinite(kp) || !isfinite(ki) || !isfinite(kd)) {
+        return false;
+    }
+    if (!state_lock()) return false;
+    g_gainSchedule[powerMode - 1][band] = {kp, ki, kd, true};
+    state_unlock();
+
+    storage_save_gain_schedule_nvs(powerMode);
+    LOG_FMT(LOG_LEVEL_INFO, "Gain schedule: mode %d @ %.0f C -> Kp=%.2f Ki=%.4f Kd=%.1f",
+            powerMode, GS_BAND_T[band], kp, ki, kd);
+    return true;
+}
+
+void gainsched_clearPoint(int powerMode, int band) {
+    if (!validPowerMode(powerMode) || band >= GS_BANDS) return;
+    if (!state_lock()) return;
+    for (int i = 0; i < GS_BANDS; i++) {
+        if (band < 0 || i == band) g_gainSchedule[powerMode - 1][i].tuned = false;
+    }
+    state_unlock();
+
+    storage_save_gain_schedule_nvs(powerMode);
+    LOG_FMT(LOG_LEVEL_INFO, "Gain schedule cleared: mode %d, band %d", powerMode, band);
+}
+
+String gainsched_getStatusJSON() {
+    PidGains table[CFG_POWERMODE_MAX][GS_BANDS];
+    if (state_lock()) {
+        memcpy(table, g_gainSchedule, sizeof(table));
+        state_unlock();
+    } else {
+        memset(table, 0, sizeof(table));
+    }
+
+    char buf[1536];
+    int n = snprintf(buf, sizeof(buf), "{\"bands\":[");
+    for (int i = 0; i < GS_BANDS && n < (int)sizeof(buf); i++) {
+        n += snprintf(buf + n, sizeof(buf) - n, "%s%.0f", i ? "," : "", GS_BAND_T[i]);
+    }
+    if (n < (int)sizeof(buf)) {
+        n += snprintf(buf + n, sizeof(buf) - n,
+            "],\"active\":{\"setpoint\":%.1f,\"powerMode\":%d,\"kp\":%.3f,\"ki\":%.5f,\"kd\":%.2f,\"scheduled\":%s},\"modes\":[",
+            isnan(last.setpoint) ? 0.0 : last.setpoint, last.powerMode,
+            last.gains.kp, last.gains.ki, last.gains.kd, last.scheduled ? "true" : "false");
+    }
+    for (int pm = 0; pm < CFG_POWERMODE_MAX && n < (int)sizeof(buf); pm++) {
+        n += snprintf(buf + n, sizeof(buf) - n, "%s[", pm ? "," : "");
+        for (int i = 0; i < GS_BANDS && n < (int)sizeof(buf); i++) {
+            const PidGains& g = table[pm][i];
+            if (g.tuned) {
+                n += snprintf(buf + n, sizeof(buf) - n, "%s{\"kp\":%.3f,\"ki\":%.5f,\"kd\":%.2f}",
+                              i ? "," : "", g.kp, g.ki, g.kd);
+            } else {
+                n += snprintf(buf + n, sizeof(buf) - n, "%snull", i ? "," : "");
+            }
+        }
+        if (n < (int)sizeof(buf)) n += snprintf(buf + n, sizeof(buf) - n, "]");
+    }
+    if (n < (int)sizeof(buf)) snprintf(buf + n, sizeof(buf) - n, "]}");
+    return String(buf);
+}
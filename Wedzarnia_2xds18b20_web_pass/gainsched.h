@@ -0,0 +1,20 @@
+// gainsched.h - Harmonogram nastaw PID (gain scheduling)
+// Komora przy 30 C (suszenie) i przy 110 C (pieczenie) to różne obiekty:
+// inne straty, inna stała czasowa, inny udział grzałek. Tabela punktów
+// węzłowych GS_BAND_T dla każdego trybu mocy; Kp/Ki/Kd interpolowane liniowo
+// po setpoincie między ustawionymi punktami (poza skrajnymi – wartość skrajna).
+// Bez punktów w danym trybie mocy – nastawy z autotune lub CFG_K*.
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Nastawy dla setpointu i trybu mocy; true = z harmonogramu, false = zapas
+bool gainsched_lookup(double setpoint, int powerMode, PidGains* out);
+// Jak wyżej, bez zapisu jako aktywne (symulacje, podgląd)
+bool gainsched_peek(double setpoint, int powerMode, PidGains* out);
+// Punkt węzłowy najbliższy setpointowi (autotune zapisuje wynik do niego)
+int gainsched_nearestBand(double setpoint);
+// Ustawienie / skasowanie punktu z zapisem do NVS; band < 0 = cały tryb mocy
+bool gainsched_setPoint(int powerMode, int band, double kp, double ki, double kd);
+void gainsched_clearPoint(int powerMode, int band);
+String gainsched_getStatusJSON();
@@ -5,6 +5,8 @@
 #include "config.h"
 #include "state.h"
 #include "outputs.h"
+#include "sensors.h"
+#include "ssrout.h"
 #include "wifimanager.h"
 #include <SD.h>
 #include <nvs_flash.h>
@@ -34,17 +36,22 @@ void hardware_init_pins() {
 void hardware_init_ledc() {
     bool success = true;
 
-    if (!ledcAttach(PIN_SSR1, LEDC_FREQ, LEDC_RESOLUTION)) {
-        log_msg(LOG_LEVEL_ERROR, "LEDC SSR1 attach failed!");
-        success = false;
-    }
-    if (!ledcAttach(PIN_SSR2, LEDC_FREQ, LEDC_RESOLUTION)) {
-        log_msg(LOG_LEVEL_ERROR, "LEDC SSR2 attach failed!");
-        success = false;
-    }
-    if (!ledcAttach(PIN_SSR3, LEDC_FREQ, LEDC_RESOLUTION)) {
-        log_msg(LOG_LEVEL_ERROR, "LEDC SSR3 attach failed!");
-        success = false;
+    // Grzałki w trybie pakietowym sterowane z ssrout (GPIO), LEDC tylko dla dymu
+    if (CFG_SSR_BURST) {
+        ssrout_begin();
+    } else {
+        if (!ledcAttach(PIN_SSR1, LEDC_FREQ, LEDC_RESOLUTION)) {
+            log_msg(LOG_LEVEL_ERROR, "LEDC SSR1 attach failed!");
+            success = false;
+        }
+        if (!ledcAttach(PIN_SSR2, LEDC_FREQ, LEDC_RESOLUTION)) {
+            log_msg(LOG_LEVEL_ERROR, "LEDC SSR2 attach failed!");
+            success = false;
+        }
+        if (!ledcAttach(PIN_SSR3, LEDC_FREQ, LEDC_RESOLUTION)) {
+            log_msg(LOG_LEVEL_ERROR, "LEDC SSR3 attach failed!");
+            success = false;
+        }
     }
     if (!ledcAttach(PIN_SMOKE_FAN, LEDC_FREQ, LEDC_RESOLUTION)) {
         log_msg(LOG_LEVEL_ERROR, "LEDC SMOKE attach failed!");
@@ -60,11 +67,15 @@ void hardware_init_ledc() {
 
 void hardware_init_sensors() {
     sensors.begin();
+    // Zmiana rozdzielczości tylko w scratchpadzie – bez kopii do EEPROM sondy
+    // (przełączenia przy drzwiach/rampach zużywałyby EEPROM)
+    sensors.setAutoSaveScratchPad(false);
     sensors.setWaitForConversion(false);
     sensors.setResolution(12);
 
-    int deviceCount = sensors.getDeviceCount();
-    LOG_FMT(LOG_LEVEL_INFO, "Found %d DS18B20 sensor(s)", deviceCount);
+    // Jedno przejście po magistrali – dalej odczyty idą po adresach ROM
+    int deviceCount = rebuildSensorTable();
+    LOG_FMT(LOG_LEVEL_INFO, "Found %d temperature sensor(s)", deviceCount);
 
     if (deviceCount == 0) {
         log_msg(LOG_LEVEL_WARN, "No temperature sensors found!");
@@ -318,12 +329,12 @@ void runStartupSelfTest() {
     sensors.requestTemperatures();
     delay(1000);
 
-    int sensorCount = sensors.getDeviceCount();
+    int sensorCount = getDs18b20Count();
     bool sensor1Ok = false;
     bool sensor2Ok = false;
 
     if (sensorCount >= 1) {
-        double temp1 = sensors.getTempCByIndex(0);
+        double temp1 = sensors.getTempC(sensorAddresses[0]);
         if (temp1 != DEVICE_DISCONNECTED_C && temp1 > -20 && temp1 < 100) {
             LOG_FMT(LOG_LEVEL_INFO, "Sensor 1: %.1f C - OK", temp1);
             sensor1Ok = true;
@@ -333,7 +344,7 @@ void runStartupSelfTest() {
     }
 
     if (sensorCount >= 2) {
-        double temp2 = sensors.getTempCByIndex(1);
+        double temp2 = sensors.getTempC(sensorAddresses[1]);
         if (temp2 != DEVICE_DISCONNECTED_C && temp2 > -20 && temp2 < 100) {
             LOG_FMT(LOG_LEVEL_INFO, "Sensor 2: %.1f C - OK", temp2);
             sensor2Ok = true;
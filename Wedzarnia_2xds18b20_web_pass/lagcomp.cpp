@@ -0,0 +1,201 @@
+// lagcomp.cpp - Kompensacja opóźnienia sondy i identyfikacja stałej czasowej
+#include "lagcomp.h"
+#include "config.h"
+#include "state.h"
+#include "calibration.h"
+
+// Identyfikacja: po skoku temperatury otoczenia pochodna odczytu sondy rośnie
+// skokowo i maleje wykładniczo, |dT/dt| ~ exp(-t/tau). Nachylenie ln|dT/dt|
+// w przedziale 80%..20% szczytu (najmniejsze kwadraty) daje -1/tau.
+// Wolne narastanie szczytu = zmiana wymuszona przez proces, nie skok – odrzucane.
+struct LagIdent {
+    bool tracking;
+    int sign;
+    double peakRate;
+    unsigned long onsetMs;
+    unsigned long peakMs;
+    double sx, sy, sxx, sxy;
+    int n;
+};
+
+struct LagChannel {
+    uint8_t id[8];
+    bool bound;
+    double tau;              // [s] – pod state_lock(), czytane przez task sterowania
+    bool identified;         // tau z identyfikacji/ręcznie (nie domyślna)
+    bool held;               // korekta wstrzymana – pod state_lock()
+    double lastTauFit;
+    unsigned long fits;
+    LagIdent ident;
+};
+
+static LagChannel lag[EST_CHANNELS] = {};
+
+static double defaultTau(EstChannel ch) {
+    return (ch == EST_CHAMBER) ? LAG_TAU_DEFAULT_CHAMBER : LAG_TAU_DEFAULT_MEAT;
+}
+
+static void bindProbe(EstChannel ch, const uint8_t* id) {
+    LagChannel& c = lag[ch];
+    float stored = calibration_loadTau(id);
+    double tau = (stored >= LAG_TAU_MIN && stored <= LAG_TAU_MAX) ? stored : defaultTau(ch);
+    memcpy(c.id, id, sizeof(c.id));
+    c.bound = true;
+    c.identified = (stored >= LAG_TAU_MIN && stored <= LAG_TAU_MAX);
+    c.ident.tracking = false;
+    if (state_lock()) {
+        c.tau = tau;
+        state_unlock();
+    }
+    LOG_FMT(LOG_LEVEL_INFO, "Lag %s: tau %.1f s (%s)", ch == EST_CHAMBER ? "chamber" : "meat",
+            tau, c.identified ? "stored" : "default");
+}
+
+static void identStart(LagIdent& id, int sign, double a, unsigned long now) {
+    id.tracking = true;
+    id.sign = sign;
+    id.peakRate = a;
+    id.onsetMs = now;
+    id.peakMs = now;
+    id.sx = id.sy = id.sxx = id.sxy = 0.0;
+    id.n = 0;
+}
+
+static void identFinish(EstChannel ch) {
+    LagChannel& c = lag[ch];
+    LagIdent& id = c.ident;
+    id.tracking = false;
+    if (id.n < LAG_ID_MIN_SAMPLES) return;
+
+    double den = id.n * id.sxx - id.sx * id.sx;
+    if (den <= 0.0) return;
+    double slope = (id.n * id.sxy - id.sx * id.sy) / den;
+    if (slope >= 0.0) return;
+    double fit = -1.0 / slope;
+    if (fit < LAG_TAU_MIN || fit > LAG_TAU_MAX) return;
+
+    c.lastTauFit = fit;
+    c.fits++;
+    double oldTau = c.tau;
+    double tau = c.identified ? (1.0 - LAG_ID_ALPHA) * oldTau + LAG_ID_ALPHA * fit : fit;
+    c.identified = true;
+    if (state_lock()) {
+        c.tau = tau;
+        state_unlock();
+    }
+    LOG_FMT(LOG_LEVEL_INFO, "Lag %s: step fit tau %.1f s -> %.1f s",
+            ch == EST_CHAMBER ? "chamber" : "meat", fit, tau);
+
+    // Zapis do NVS tylko przy istotnej zmianie (zużycie flash)
+    if (fabs(tau - oldTau) > 0.05 * oldTau) calibration_storeTau(c.id, (float)tau);
+}
+
+void lagcomp_update(EstChannel ch, const uint8_t* id, const TempEstimate& est, unsigned long nowMs) {
+    LagChannel& c = lag[ch];
+    if (!c.bound || memcmp(c.id, id, sizeof(c.id)) != 0) bindProbe(ch, id);
+    if (!est.valid) return;
+
+    LagIdent& li = c.ident;
+    double a = fabs(est.rate);
+    int sign = (est.rate >= 0.0) ? 1 : -1;
+
+    if (!li.tracking) {
+        if (a >= LAG_ID_MIN_RATE) identStart(li, sign, a, nowMs);
+        return;
+    }
+
+    if (sign != li.sign || nowMs - li.peakMs > (unsigned long)(LAG_TAU_MAX * 5000.0)) {
+        li.tracking = false;
+        return;
+    }
+
+    if (a > li.peakRate) {
+        // Szczyt musi wypaść krótko po początku – inaczej to nie skok
+        if (nowMs - li.onsetMs > LAG_ID_MAX_RISE_MS) {
+            li.tracking = false;
+            return;
+        }
+        li.peakRate = a;
+        li.peakMs = nowMs;
+        li.sx = li.sy = li.sxx = li.sxy = 0.0;
+        li.n = 0;
+        return;
+    }
+
+    if (a < 0.2 * li.peakRate) {
+        identFinish(ch);
+        return;
+    }
+    if (a <= 0.8 * li.peakRate) {
+        double x = (nowMs - li.peakMs) / 1000.0;
+        double y = log(a);
+        li.sx += x;
+        li.sy += y;
+        li.sxx += x * x;
+        li.sxy += x * y;
+        li.n++;
+    }
+}
+
+void lagcomp_hold(EstChannel ch, bool hold) {
+    LagChannel& c = lag[ch];
+    if (c.held == hold) return;
+    if (hold) c.ident.tracking = false;
+    if (state_lock()) {
+        c.held = hold;
+        state_unlock();
+    }
+    LOG_FMT(LOG_LEVEL_INFO, "Lag %s: compensation %s", ch == EST_CHAMBER ? "chamber" : "meat",
+            hold ? "paused (probe vote degraded)" : "resumed");
+}
+
+double lagcomp_apply(EstChannel ch, const TempEstimate& est) {
+    double tau = 0.0;
+    if (state_lock()) {
+        tau = lag[ch].held ? 0.0 : lag[ch].tau;
+        state_unlock();
+    }
+    if (!est.valid || tau <= 0.0) return est.temp;
+    // Ograniczenie szumu: korekta proporcjonalna do ufności estymaty i przycięta
+    double correction = tau * est.rate * est.confidence;
+    correction = constrain(correction, -LAG_MAX_CORRECTION, LAG_MAX_CORRECTION);
+    return est.temp + correction;
+}
+
+double lagcomp_getTau(EstChannel ch) {
+    double tau = 0.0;
+    if (state_lock()) {
+        tau = lag[ch].tau;
+        state_unlock();
+    }
+    return tau;
+}
+
+bool lagcomp_setTau(EstChannel ch, double tau) {
+    LagChannel& c = lag[ch];
+    if (!c.bound) return false;
+    if (tau != 0.0 && (tau < LAG_TAU_MIN || tau > LAG_TAU_MAX)) return false;
+    if (!calibration_storeTau(c.id, (float)tau)) return false;
+    // Ponowne wczytanie przy następnej estymacie (task czujników)
+    c.bound = false;
+    return true;
+}
+
+String lagcomp_getStatusJSON() {
+    char json[256];
+    double tau[EST_CHANNELS];
+    if (state_lock()) {
+        for (int i = 0; i < EST_CHANNELS; i++) tau[i] = lag[i].tau;
+        state_unlock();
+    } else {
+        for (int i = 0; i < EST_CHANNELS; i++) tau[i] = 0.0;
+    }
+    snprintf(json, sizeof(json),
+        "{\"chamber\":{\"tau\":%.1f,\"identified\":%s,\"lastFit\":%.1f,\"fits\":%lu},"
+        "\"meat\":{\"tau\":%.1f,\"identified\":%s,\"lastFit\":%.1f,\"fits\":%lu}}",
+        tau[EST_CHAMBER], lag[EST_CHAMBER].identified ? "true" : "false",
+        lag[EST_CHAMBER].lastTauFit, lag[EST_CHAMBER].fits,
+        tau[EST_MEAT], lag[EST_MEAT].identified ? "true" : "false",
+        lag[EST_MEAT].lastTauFit, lag[EST_MEAT].fits);
+    return String(json);
+}
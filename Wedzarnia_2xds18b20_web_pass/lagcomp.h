@@ -0,0 +1,20 @@
+// lagcomp.h - Kompensacja opóźnienia cieplnego sondy (model pierwszego rzędu)
+// Sonda w osłonie nierdzewnej widzi temperaturę powietrza z opóźnieniem
+// o stałej czasowej tau: T_sonda' = (T_pow - T_sonda) / tau. Odwrócenie modelu:
+// T_pow = T_sonda + tau * dT_sonda/dt, z pochodną z estymatora (już odszumioną)
+// i ograniczeniem korekty. tau identyfikowana z odpowiedzi na skok (zamknięcie
+// drzwi, włączenie grzania) i zapisywana w NVS per adres ROM sondy.
+#pragma once
+#include <Arduino.h>
+#include "estimator.h"
+
+// Nowa estymata z tasku czujników; id = identyfikator kanału przypisanego do roli
+void lagcomp_update(EstChannel ch, const uint8_t* id, const TempEstimate& est, unsigned long nowMs);
+// Wstrzymanie identyfikacji i korekty (odczyt nie pochodzi z sondy, do której należy tau)
+void lagcomp_hold(EstChannel ch, bool hold);
+// Temperatura skompensowana (dowolny task)
+double lagcomp_apply(EstChannel ch, const TempEstimate& est);
+double lagcomp_getTau(EstChannel ch);
+// Ręczne ustawienie tau [s]; 0 = powrót do identyfikacji od wartości domyślnej
+bool lagcomp_setTau(EstChannel ch, double tau);
+String lagcomp_getStatusJSON();
@@ -0,0 +1,172 @@
+// meateta.cpp - Predykcja czasu dojścia mięsa: uczenie k i symulacja profilu
+#include "meateta.h"
+#include "config.h"
+#include "state.h"
+#include "estimator.h"
+
+struct MeatEta {
+    // Najmniejsze kwadraty przez zero: y = dTm/dt [C/min], x = Tc - Tm [C]
+    double num, den;
+    unsigned long samples;
+    unsigned long lastSampleMs;
+    // Temperatura mięsa do predykcji wg reguły kroku (ostatnia próbka)
+    double meatMin, meatMean;
+    bool meatValid;
+    // Ostatnia predykcja: pozostały czas każdego kroku [s], -1 = nieznany
+    long stepEta[MAX_STEPS];
+    int firstStep;
+    int stepCount;
+};
+
+static MeatEta eta = {};
+
+static double etaK() {
+    return (eta.samples >= ETA_MIN_SAMPLES && eta.den > 0.0) ? eta.num / eta.den : 0.0;
+}
+
+static bool etaTrained() {
+    double k = etaK();
+    return k >= ETA_K_MIN && k <= ETA_K_MAX;
+}
+
+void meateta_reset() {
+    eta.num = 0.0;
+    eta.den = 0.0;
+    eta.samples = 0;
+    eta.lastSampleMs = 0;
+    eta.meatValid = false;
+}
+
+void meateta_update(unsigned long nowMs) {
+    if (eta.lastSampleMs != 0 && nowMs - eta.lastSampleMs < ETA_SAMPLE_MS) return;
+    TempEstimate meatEst = estimator_get(EST_MEAT);
+    TempEstimate chamberEst = estimator_get(EST_CHAMBER);
+    if (!state_lock()) return;
+    ProcessState st = g_currentState;
+    bool door = g_doorOpen;
+    bool virt = g_chamberVirtual;
+    double tc = chamberEst.valid ? chamberEst.temp : g_tChamber;
+    double probes[MEAT_PROBES_MAX];
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) probes[i] = g_tMeatProbes[i];
+    uint16_t mask = g_meatProbeMask;
+    double tm = meatEst.valid ? meatEst.temp : g_tMeat;
+    state_unlock();
+    eta.lastSampleMs = nowMs;
+
+    // Sonda główna z estymatora, jak w warunku kroku
+    probes[0] = tm;
+    double minT = 1e9, sum = 0.0;
+    int n = 0;
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) {
+        if (!(mask & (1 << i)) || isnan(probes[i])) continue;
+        minT = min(minT, probes[i]);
+        sum += probes[i];
+        n++;
+    }
+    eta.meatValid = n > 0;
+    if (eta.meatValid) {
+        eta.meatMin = minT;
+        eta.meatMean = sum / n;
+    }
+
+    // Uczenie na sondzie głównej (szybkość z estymatora, już odszumiona);
+    // drzwi i model komory psują zależność od Tc
+    bool running = st == ProcessState::RUNNING_AUTO || st == ProcessState::RUNNING_MANUAL;
+    double x = tc - tm;
+    if (!running || door || virt || !meatEst.valid || isnan(tc) || x < ETA_MIN_DIFF) return;
+    double y = meatEst.rate * 60.0;
+    eta.num = ETA_LAMBDA * eta.num + x * y;
+    eta.den = ETA_LAMBDA * eta.den + x * x;
+    eta.samples++;
+    if (eta.samples == ETA_MIN_SAMPLES) {
+        LOG_FMT(LOG_LEVEL_INFO, "Meat ETA model ready: k=%.4f 1/min", etaK());
+    }
+}
+
+// Temperatura mięsa po czasu t [s] przy komorze na ts
+static double meatAfter(double tm, double ts, double k, double t) {
+    return ts - (ts - tm) * exp(-k * t / 60.0);
+}
+
+unsigned long meateta_predictRemaining(unsigned long nowMs) {
+    int current = g_currentStep;
+    int count = g_stepCount;
+    unsigned long stepElapsedMs = nowMs - g_stepStartTime;
+    double k = etaK();
+    bool trained = etaTrained();
+
+    eta.firstStep = current;
+    eta.stepCount = count;
+    unsigned long total = 0;
+    bool allKnown = true;
+    bool meatKnown = eta.meatValid;
+    double tm = 0.0;
+
+    for (int i = current; i >= 0 && i < count; i++) {
+        const Step& s = g_profile[i];
+        unsigned long minSec = s.minTimeMs / 1000;
+        if (i == current) minSec = (s.minTimeMs > stepElapsedMs) ? (s.minTimeMs - stepElapsedMs) / 1000 : 0;
+        if (i == current && eta.meatValid) {
+            tm = (s.meatRule == MeatRule::MEAN) ? eta.meatMean : eta.meatMin;
+        }
+
+        long stepSec = (long)minSec;
+        if (s.useMeatTemp) {
+            double target = s.tMeatTarget;
+            if (meatKnown && tm >= target) {
+                // Cel już osiągnięty – zostaje czas minimalny
+            } else if (meatKnown && trained && s.tSet - target >= ETA_MIN_MARGIN) {
+                double tMeat = log((s.tSet - tm) / (s.tSet - target)) / k * 60.0;
+                stepSec = (tMeat > (double)ETA_MAX_SEC) ? -1 : max((long)minSec, (long)tMeat);
+            } else {
+                stepSec = -1;
+            }
+            if (stepSec < 0) {
+                allKnown = false;
+                total += minSec;
+                // Dalsze kroki od celu poprzedniego – najlepsze, co wiadomo
+                tm = target;
+                meatKnown = true;
+            } else {
+                total += stepSec;
+                tm = trained ? max(target, meatAfter(tm, s.tSet, k, stepSec)) : target;
+            }
+        } else {
+            total += minSec;
+            if (meatKnown && trained) tm = meatAfter(tm, s.tSet, k, minSec);
+        }
+        if (i - current < MAX_STEPS) eta.stepEta[i - current] = stepSec;
+    }
+
+    g_processStats.stepEtaSec = (current >= 0 && current < count) ? eta.stepEta[0] : -1;
+    g_processStats.etaPredicted = allKnown;
+    return total;
+}
+
+void meateta_formatSteps(char* buf, size_t len) {
+    if (!state_lock()) {
+        snprintf(buf, len, "[]");
+        return;
+    }
+    int offset = snprintf(buf, len, "[");
+    int steps = eta.stepCount - eta.firstStep;
+    for (int i = 0; i < steps && i < MAX_STEPS && offset < (int)len; i++) {
+        offset += (eta.stepEta[i] < 0)
+            ? snprintf(buf + offset, len - offset, "%snull", i ? "," : "")
+            : snprintf(buf + offset, len - offset, "%s%ld", i ? "," : "", eta.stepEta[i]);
+    }
+    if (offset < (int)len) snprintf(buf + offset, len - offset, "]");
+    state_unlock();
+}
+
+String meateta_getStatusJSON() {
+    char steps[16 + MAX_STEPS * 12];
+    meateta_formatSteps(steps, sizeof(steps));
+    char json[256 + sizeof(steps)];
+    snprintf(json, sizeof(json),
+        "{\"trained\":%s,\"k\":%.5f,\"tauMin\":%.0f,\"samples\":%lu,\"meatMin\":%.1f,\"meatMean\":%.1f,"
+        "\"steps\":%s}",
+        etaTrained() ? "true" : "false", etaK(), etaTrained() ? 1.0 / etaK() : 0.0, eta.samples,
+        eta.meatValid ? eta.meatMin : 0.0, eta.meatValid ? eta.meatMean : 0.0, steps);
+    return String(json);
+}
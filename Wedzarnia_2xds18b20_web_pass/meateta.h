@@ -0,0 +1,19 @@
+// meateta.h - Predykcja czasu dojścia temperatury mięsa (ETA)
+// Model nagrzewania Newtona: dTm/dt = k * (Tc - Tm). Stała k uczona online
+// (najmniejsze kwadraty z zapominaniem) z historii sondy mięsa i komory;
+// predykcja kroku z warunkiem mięsa: t = ln((Ts - Tm) / (Ts - Tcel)) / k,
+// zakładając komorę na setpoincie kroku. Kroki bez warunku mięsa przenoszą
+// przewidywaną temperaturę mięsa na następne kroki.
+#pragma once
+#include <Arduino.h>
+
+// Próbka historii – task sterowania, co obieg (próbkowanie co ETA_SAMPLE_MS)
+void meateta_update(unsigned long nowMs);
+// Nowy wsad: start procesu zapomina nauczone k
+void meateta_reset();
+// Predykcja pozostałego czasu profilu [s] – wywoływać pod state_lock()
+// (czyta g_profile); wypełnia g_processStats.stepEtaSec / etaPredicted
+unsigned long meateta_predictRemaining(unsigned long nowMs);
+// Pozostały czas kolejnych kroków od bieżącego: "[1200,null,3600]"
+void meateta_formatSteps(char* buf, size_t len);
+String meateta_getStatusJSON();
@@ -0,0 +1,468 @@
+// mpc.cpp - Identyfikacja modelu FOPDT i regulator predykcyjny komory
+#include "mpc.h"
+#include "state.h"
+#include "gainsched.h"
+#include "doorrec.h"
+
+static constexpr int MPC_NPARAM = 3;
+static constexpr int MPC_SAMPLE_SEC = MPC_SAMPLE_MS / 1000;
+
+// Jeden kandydat opóźnienia: theta = {th0, th1, th2}, P = kowariancja RLS
+struct FopdtCandidate {
+    double theta[MPC_NPARAM];
+    double P[MPC_NPARAM][MPC_NPARAM];
+    double err;                    // wygładzony kwadrat błędu predykcji
+};
+
+struct Mpc {
+    FopdtCandidate cand[MPC_MAX_DEAD + 1];
+    double uHist[MPC_MAX_DEAD + 1];    // [0] = średnie u ostatniej próbki [grzałki]
+    double uSum;
+    unsigned long uCount;
+    double yPrev;
+    bool yPrevValid;
+    unsigned long lastSampleMs;
+    unsigned long samples;
+    int best;                      // indeks = opóźnienie w próbkach
+    double bias;                   // wygładzony błąd predykcji modelu (zakłócenie)
+    double duty;                   // [%], NAN = brak modelu
+};
+
+static Mpc mpc;
+static bool mpcInit = false;
+static volatile bool resetRequested = false;
+
+// Migawka modelu dla web servera – RLS i zerowanie zmieniają cand/best pod state_lock
+struct MpcSnapshot {
+    double theta[MPC_NPARAM];
+    int best;
+    bool ready;
+    unsigned long samples;
+    double bias;
+    double duty;
+    double err[MPC_MAX_DEAD + 1];
+};
+
+static bool isRunning(ProcessState st) {
+    return st == ProcessState::RUNNING_AUTO || st == ProcessState::RUNNING_MANUAL ||
+           st == ProcessState::SOFT_RESUME || st == ProcessState::AUTOTUNE;
+}
+
+static void resetModel() {
+    memset(&mpc, 0, sizeof(mpc));
+    for (int d = 0; d <= MPC_MAX_DEAD; d++) {
+        for (int i = 0; i < MPC_NPARAM; i++) mpc.cand[d].P[i][i] = VCH_RLS_P0;
+    }
+    mpc.duty = NAN;
+    mpcInit = true;
+}
+
+// Parametry fizyczne z theta: tau [min], wzmocnienie [C/grzałkę], otoczenie [C]
+static double modelTauMin(const double* th) {
+    return th[1] < 0.0 ? -VCH_T_NORM / th[1] * MPC_SAMPLE_SEC / 60.0 : 0.0;
+}
+
+static double modelGain(const double* th) {
+    return th[1] < 0.0 ? -th[0] * VCH_T_NORM / th[1] : 0.0;
+}
+
+static double modelAmbient(const double* th) {
+    return th[1] < 0.0 ? VCH_T_NORM * (1.0 - th[2] / th[1]) : 0.0;
+}
+
+static bool modelValid(const double* th) {
+    double tau = modelTauMin(th);
+    return th[0] > 0.0 && tau >= VCH_TAU_MIN_MIN && tau <= VCH_TAU_MAX_MIN;
+}
+
+bool mpc_modelReady() {
+    return mpcInit && mpc.samples >= MPC_MIN_SAMPLES && modelValid(mpc.cand[mpc.best].theta);
+}
+
+void mpc_requestReset() {
+    resetRequested = true;
+}
+
+static bool takeSnapshot(MpcSnapshot& snap) {
+    if (!state_lock()) return false;
+    memcpy(snap.theta, mpc.cand[mpc.best].theta, sizeof(snap.theta));
+    snap.best = mpc.best;
+    snap.ready = mpc_modelReady();
+    snap.samples = mpc.samples;
+    snap.bias = mpc.bias;
+    snap.duty = mpc.duty;
+    for (int d = 0; d <= MPC_MAX_DEAD; d++) snap.err[d] = mpc.cand[d].err;
+    state_unlock();
+    return true;
+}
+
+bool mpc_getModel(double* gainPerHeater, double* tauMin) {
+    if (!mpc_modelReady()) return false;
+    const double* th = mpc.cand[mpc.best].theta;
+    *gainPerHeater = modelGain(th);
+    *tauMin = modelTauMin(th);
+    return true;
+}
+
+static inline double modelStep(const double* th, double bias, double y, double u) {
+    return y + th[0] * u + th[1] * (y - VCH_T_NORM) / VCH_T_NORM + th[2] + bias;
+}
+
+// Zwraca błąd a priori (pomiar - predykcja)
+static double rlsUpdate(FopdtCandidate& c, const double phi[MPC_NPARAM], double y) {
+    double Pphi[MPC_NPARAM];
+    double denom = MPC_RLS_LAMBDA;
+    for (int i = 0; i < MPC_NPARAM; i++) {
+        Pphi[i] = 0.0;
+        for (int j = 0; j < MPC_NPARAM; j++) Pphi[i] += c.P[i][j] * phi[j];
+        denom += phi[i] * Pphi[i];
+    }
+    double err = y;
+    for (int i = 0; i < MPC_NPARAM; i++) err -= c.theta[i] * phi[i];
+    for (int i = 0; i < MPC_NPARAM; i++) c.theta[i] += Pphi[i] * err / denom;
+    for (int i = 0; i < MPC_NPARAM; i++) {
+        for (int j = 0; j < MPC_NPARAM; j++) {
+            c.P[i][j] = (c.P[i][j] - Pphi[i] * Pphi[j] / denom) / MPC_RLS_LAMBDA;
+        }
+    }
+    return err;
+}
+
+// Optymalne u [grzałki] stałe na horyzoncie: odpowiedź swobodna (znane wejścia
+// w opóźnieniu, potem u = 0) + odpowiedź skokowa S_j; dJ/du = 0 i rzutowanie na 0..pm
+static double mpcSolve(const double* th, int dead, double bias, double y,
+                       const double* uHist, double r, double uPrev, int pm) {
+    double yf = y;
+    for (int i = 0; i < dead; i++) yf = modelStep(th, bias, yf, uHist[dead - 1 - i]);
+
+    double a = 1.0 + th[1] / VCH_T_NORM;
+    double s = 0.0;
+    double num = MPC_MOVE_WEIGHT * uPrev;
+    double den = MPC_MOVE_WEIGHT;
+    for (int j = 0; j < MPC_HORIZON; j++) {
+        yf = modelStep(th, bias, yf, 0.0);
+        s = a * s + th[0];
+        num += s * (r - yf);
+        den += s * s;
+    }
+    return constrain(num / den, 0.0, (double)pm);
+}
+
+void mpc_update(unsigned long nowMs, ProcessState st) {
+    if (!state_lock()) return;
+    // Zerowanie zlecone z web servera – tu, pod blokadą, poza krokiem RLS
+    if (!mpcInit || resetRequested) {
+        resetRequested = false;
+        resetModel();
+    }
+    double y = pidInput;
+    double r = pidSetpoint;
+    int pm = constrain((int)g_powerMode, CFG_POWERMODE_MIN, CFG_POWERMODE_MAX);
+    double u = isRunning(st) ? g_heaterPower : 0.0;
+    bool learnOk = isRunning(st) && !g_doorOpen && !g_chamberVirtual;
+    state_unlock();
+
+    mpc.uSum += u;
+    mpc.uCount++;
+    if (mpc.lastSampleMs == 0) mpc.lastSampleMs = nowMs;
+    if (nowMs - mpc.lastSampleMs < MPC_SAMPLE_MS) return;
+    mpc.lastSampleMs = nowMs;
+
+    // Historia wejścia przesuwa się zawsze – opóźnienie dotyczy też pauz
+    memmove(&mpc.uHist[1], &mpc.uHist[0], MPC_MAX_DEAD * sizeof(double));
+    mpc.uHist[0] = mpc.uSum / mpc.uCount;
+    mpc.uSum = 0.0;
+    mpc.uCount = 0;
+
+    if (isnan(y)) {
+        mpc.yPrevValid = false;
+        mpc.duty = NAN;
+        return;
+    }
+
+    if (learnOk && mpc.yPrevValid && state_lock()) {
+        double dy = y - mpc.yPrev;
+        double yn = (mpc.yPrev - VCH_T_NORM) / VCH_T_NORM;
+        int best = 0;
+        for (int d = 0; d <= MPC_MAX_DEAD; d++) {
+            double phi[MPC_NPARAM] = {mpc.uHist[d], yn, 1.0};
+            FopdtCandidate& c = mpc.cand[d];
+            double e = rlsUpdate(c, phi, dy);
+            if (d == mpc.best) mpc.bias += MPC_BIAS_ALPHA * (e - mpc.bias);
+            c.err += MPC_ERR_ALPHA * (e * e - c.err);
+            if (c.err < mpc.cand[best].err) best = d;
+        }
+        mpc.samples++;
+        if (best != mpc.best) {
+            LOG_FMT(LOG_LEVEL_DEBUG, "MPC: dead time %d s -> %d s",
+                    mpc.best * MPC_SAMPLE_SEC, best * MPC_SAMPLE_SEC);
+            mpc.best = best;
+            mpc.bias = 0.0;
+        }
+        state_unlock();
+    }
+    mpc.yPrev = y;
+    mpc.yPrevValid = true;
+
+    // Krok regulatora – liczony też pod PID (podgląd cieniem)
+    if (isRunning(st) && mpc_modelReady()) {
+        double uOpt = mpcSolve(mpc.cand[mpc.best].theta, mpc.best, mpc.bias, y,
+                               mpc.uHist, r, mpc.uHist[0], pm);
+        mpc.duty = uOpt / pm * 100.0;
+    } else {
+        mpc.duty = NAN;
+    }
+}
+
+double mpc_getDuty() {
+    return mpc.duty;
+}
+
+String mpc_getStatusJSON() {
+    ControlEngine engine = ControlEngine::PID;
+    if (state_lock()) {
+        engine = g_controlEngine;
+        state_unlock();
+    }
+    MpcSnapshot snap = {};
+    takeSnapshot(snap);
+    const double* th = snap.theta;
+    bool ready = snap.ready;
+
+    char buf[768];
+    int n = snprintf(buf, sizeof(buf),
+        "{\"engine\":\"%s\",\"ready\":%s,\"active\":%s,\"samples\":%lu,\"needed\":%lu,"
+        "\"deadSec\":%d,\"tauMin\":%.1f,\"gain\":%.2f,\"ambient\":%.1f,\"bias\":%.4f,"
+        "\"duty\":%.1f,\"dutyValid\":%s,\"rmsByDead\":[",
+        engine == ControlEngine::MPC ? "mpc" : "pid", ready ? "true" : "false",
+        (engine == ControlEngine::MPC && ready && !isnan(snap.duty)) ? "true" : "false",
+        snap.samples, (unsigned long)MPC_MIN_SAMPLES,
+        snap.best * MPC_SAMPLE_SEC, modelTauMin(th), modelGain(th), modelAmbient(th), snap.bias,
+        isnan(snap.duty) ? 0.0 : snap.duty, isnan(snap.duty) ? "false" : "true");
+    for (int d = 0; d <= MPC_MAX_DEAD && n < (int)sizeof(buf); d++) {
+        n += snprintf(buf + n, sizeof(buf) - n, "%s%.4f", d ? "," : "", sqrt(snap.err[d]));
+    }
+    if (n < (int)sizeof(buf)) snprintf(buf + n, sizeof(buf) - n, "]}");
+    return String(buf);
+}
+
+// ======================================================
+// SYMULACJA PORÓWNAWCZA PID / MPC
+// ======================================================
+
+struct BenchResult {
+    double overshoot;              // [C] ponad setpoint w kierunku skoku
+    long riseSec;                  // do 90% skoku, -1 = nie osiągnięto
+    long settleSec;                // od kiedy stale w ±MPC_SETTLE_BAND, -1 = nie ustalono
+    double iae;                    // [C*min]
+};
+
+static constexpr int BENCH_DELAY_MAX = MPC_MAX_DEAD * MPC_SAMPLE_SEC + 1;
+static double benchDelay[BENCH_DELAY_MAX];  // wejście obiektu co 1 s (linia opóźniająca)
+
+// Algorytm PID_v1 (P od uchybu, D od pomiaru, całka obcinana do limitów), krok 1 s
+struct SimPid {
+    double kp, ki, kd;
+    double outputSum;
+    double lastY;
+
+    double step(double r, double y, double lo, double hi) {
+        double e = r - y;
+        double dIn = y - lastY;
+        lastY = y;
+        outputSum += ki * e;
+        outputSum = constrain(outputSum, lo, hi);
+        return constrain(kp * e + outputSum - kd * dIn, lo, hi);
+    }
+};
+
+// Obiekt co 1 s: wejście przez linię opóźniającą, przyrost próbki modelu
+// rozłożony równo na sekundy
+static double plantStep(const double* th, int delaySec, long t, double y, double u) {
+    int slot = t % BENCH_DELAY_MAX;
+    double uDelayed = (delaySec == 0) ? u : benchDelay[(t + BENCH_DELAY_MAX - delaySec) % BENCH_DELAY_MAX];
+    benchDelay[slot] = u;
+    return y + (modelStep(th, 0.0, y, uDelayed) - y) / MPC_SAMPLE_SEC;
+}
+
+// Obiekt: model identyfikowany, krok 1 s (przyrost próbki rozłożony równo)
+// Regulator: usePid ? PID_v1 co 1 s : MPC co MPC_SAMPLE_MS; pomiar bez szumu
+static BenchResult benchRun(const double* th, int dead, double from, double to, int pm,
+                            const PidGains& g, double uEq, bool usePid, long seconds) {
+    int delaySec = dead * MPC_SAMPLE_SEC;
+    for (int i = 0; i < BENCH_DELAY_MAX; i++) benchDelay[i] = uEq;
+    double uHist[MPC_MAX_DEAD + 1];
+    for (int i = 0; i <= MPC_MAX_DEAD; i++) uHist[i] = uEq;
+
+    double dir = (to >= from) ? 1.0 : -1.0;
+    double y = from;
+    double duty = uEq / pm * 100.0;
+    SimPid sp = {g.kp, g.ki, g.kd, duty, y};   // PID_v1 po Initialize() w stanie ustalonym
+    double uAcc = 0.0;
+    BenchResult res = {0.0, -1, 0, 0.0};
+
+    for (long t = 0; t < seconds; t++) {
+        if (usePid) {
+            duty = sp.step(to, y, 0.0, 100.0);
+        } else if (t % MPC_SAMPLE_SEC == 0) {
+            if (t > 0) {
+                memmove(&uHist[1], &uHist[0], MPC_MAX_DEAD * sizeof(double));
+                uHist[0] = uAcc / MPC_SAMPLE_SEC;
+                uAcc = 0.0;
+            }
+            duty = mpcSolve(th, dead, 0.0, y, uHist, to, uHist[0], pm) / pm * 100.0;
+        }
+
+        double u = duty / 100.0 * pm;
+        uAcc += u;
+        y = plantStep(th, delaySec, t, y, u);
+
+        double err = to - y;
+        res.iae += fabs(err) / 60.0;
+        res.overshoot = max(res.overshoot, -dir * err);
+        if (res.riseSec < 0 && dir * (y - from) >= 0.9 * fabs(to - from)) res.riseSec = t + 1;
+        if (fabs(err) > MPC_SETTLE_BAND) res.settleSec = t + 1;
+    }
+    if (fabs(to - y) > MPC_SETTLE_BAND) res.settleSec = -1;
+    return res;
+}
+
+String mpc_benchmarkJSON(double from, double to, int powerMode, int minutes) {
+    MpcSnapshot snap;
+    if (!takeSnapshot(snap) || !snap.ready) {
+        return "{\"error\":\"Model FOPDT nienauczony\"}";
+    }
+    int pm = constrain(powerMode, CFG_POWERMODE_MIN, CFG_POWERMODE_MAX);
+    minutes = constrain(minutes, 10, MPC_BENCH_MAX_MIN);
+    const double* th = snap.theta;
+    double amb = modelAmbient(th);
+    double k = modelGain(th);
+    if (to > amb + k * pm || from > amb + k * pm) {
+        return "{\"error\":\"Setpoint poza zasiegiem mocy w tym trybie\"}";
+    }
+
+    // Start w stanie ustalonym na "from"
+    double uEq = constrain(-(th[1] * (from - VCH_T_NORM) / VCH_T_NORM + th[2]) / th[0], 0.0, (double)pm);
+    PidGains g;
+    gainsched_peek(to, pm, &g);
+
+    long seconds = (long)minutes * 60L;
+    BenchResult rp = benchRun(th, snap.best, from, to, pm, g, uEq, true, seconds);
+    BenchResult rm = benchRun(th, snap.best, from, to, pm, g, uEq, false, seconds);
+
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+        "{\"from\":%.1f,\"to\":%.1f,\"powerMode\":%d,\"minutes\":%d,"
+        "\"model\":{\"deadSec\":%d,\"tauMin\":%.1f,\"gain\":%.2f,\"ambient\":%.1f},"
+        "\"pid\":{\"kp\":%.3f,\"ki\":%.5f,\"kd\":%.2f,\"overshoot\":%.2f,\"riseSec\":%ld,\"settleSec\":%ld,\"iae\":%.1f},"
+        "\"mpc\":{\"overshoot\":%.2f,\"riseSec\":%ld,\"settleSec\":%ld,\"iae\":%.1f}}",
+        from, to, pm, minutes,
+        snap.best * MPC_SAMPLE_SEC, modelTauMin(th), k, amb,
+        g.kp, g.ki, g.kd, rp.overshoot, rp.riseSec, rp.settleSec, rp.iae,
+        rm.overshoot, rm.riseSec, rm.settleSec, rm.iae);
+    return String(buf);
+}
+
+// Drzwi otwarte w stanie ustalonym na setpoincie: grzałki wyłączone, wymiana
+// powietrza z otoczeniem (DOOR_SIM_TAU_SEC). Po zamknięciu: recovery = false –
+// dotychczasowe wznowienie (całka i ostatni pomiar sprzed pauzy, kopnięcie D);
+// recovery = true – przywrócone wypełnienie, dodatek doorrec do pasma (jak computeOutput)
+struct DoorSimResult {
+    double drop;                   // [C] spadek przy otwartych drzwiach
+    double boost;                  // [%] dodatek startowy (tylko recovery)
+    long recoverySec;              // od zamknięcia do pasma DOOR_REC_BAND, -1 = nie dojechał
+    double overshoot;              // [C] po dojściu
+    double iae;                    // [C*min] od zamknięcia
+};
+
+static DoorSimResult doorRun(const double* th, int dead, double setpoint, int pm,
+                             const PidGains& g, double uEq, int openSec, bool recovery) {
+    constexpr long PRE_SEC = 60;
+    constexpr long POST_SEC = 3600;
+    int delaySec = dead * MPC_SAMPLE_SEC;
+    for (int i = 0; i < BENCH_DELAY_MAX; i++) benchDelay[i] = uEq;
+
+    double amb = modelAmbient(th);
+    double y = setpoint;
+    double dutyEq = uEq / pm * 100.0;
+    SimPid sp = {g.kp, g.ki, g.kd, dutyEq, y};
+    double duty = dutyEq;
+    long closeAt = PRE_SEC + openSec;
+    double boost0 = 0.0;
+    double tauSec = 1.0;
+    bool boosting = false;
+    DoorSimResult res = {0.0, 0.0, -1, 0.0, 0.0};
+
+    for (long t = 0; t < closeAt + POST_SEC; t++) {
+        if (t < PRE_SEC) {
+            duty = sp.step(setpoint, y, 0.0, 100.0);
+        } else if (t < closeAt) {
+            duty = 0.0;                // PAUSE_DOOR: wyjścia wyłączone, PID nie liczy
+        } else {
+            if (t == closeAt) {
+                res.drop = max(0.0, setpoint - y);
+                if (recovery) {
+                    double gain = modelGain(th), tau = modelTauMin(th);
+                    boost0 = doorrec_planBoost(res.drop, openSec * 1000UL, pm, gain, tau);
+                    tauSec = doorrec_planTauMs(openSec * 1000UL) / 1000.0;
+                    res.boost = boost0;
+                    sp.outputSum = dutyEq;
+                    sp.lastY = y;
+                    boosting = true;
+                }
+            }
+            double boost = boosting ? boost0 * exp(-(t - closeAt) / tauSec) : 0.0;
+            if (boost < 0.5) boost = 0.0;
+            boost = min(boost, max(0.0, 100.0 - sp.outputSum));
+            double fb = sp.step(setpoint, y, -boost, 100.0 - boost);
+            duty = constrain(fb + boost, 0.0, 100.0);
+
+            double err = setpoint - y;
+            res.iae += fabs(err) / 60.0;
+            if (res.recoverySec < 0) {
+                if (fabs(err) <= DOOR_REC_BAND) {
+                    res.recoverySec = t - closeAt;
+                    // Koniec dodatku: wyjście przechodzi do całki
+                    if (boosting) sp.outputSum = duty;
+                    boosting = false;
+                }
+            } else {
+                res.overshoot = max(res.overshoot, -err);
+            }
+        }
+
+        y = plantStep(th, delaySec, t, y, duty / 100.0 * pm);
+        if (t >= PRE_SEC && t < closeAt) y += (amb - y) / DOOR_SIM_TAU_SEC;
+    }
+    return res;
+}
+
+String mpc_doorBenchmarkJSON(double setpoint, int openSec, int powerMode) {
+    MpcSnapshot snap;
+    if (!takeSnapshot(snap) || !snap.ready) {
+        return "{\"error\":\"Model FOPDT nienauczony\"}";
+    }
+    int pm = constrain(powerMode, CFG_POWERMODE_MIN, CFG_POWERMODE_MAX);
+    openSec = constrain(openSec, 10, 1800);
+    const double* th = snap.theta;
+    if (setpoint > modelAmbient(th) + modelGain(th) * pm) {
+        return "{\"error\":\"Setpoint poza zasiegiem mocy w tym trybie\"}";
+    }
+
+    double uEq = constrain(-(th[1] * (setpoint - VCH_T_NORM) / VCH_T_NORM + th[2]) / th[0], 0.0, (double)pm);
+    PidGains g;
+    gainsched_peek(setpoint, pm, &g);
+
+    DoorSimResult rl = doorRun(th, snap.best, setpoint, pm, g, uEq, openSec, false);
+    DoorSimResult rr = doorRun(th, snap.best, setpoint, pm, g, uEq, openSec, true);
+
+    char buf[448];
+    snprintf(buf, sizeof(buf),
+        "{\"setpoint\":%.1f,\"openSec\":%d,\"powerMode\":%d,\"drop\":%.1f,"
+        "\"legacy\":{\"recoverySec\":%ld,\"overshoot\":%.2f,\"iae\":%.1f},"
+        "\"recovery\":{\"boost\":%.1f,\"recoverySec\":%ld,\"overshoot\":%.2f,\"iae\":%.1f}}",
+        setpoint, openSec, pm, rl.drop,
+        rl.recoverySec, rl.overshoot, rl.iae,
+        rr.boost, rr.recoverySec, rr.overshoot, rr.iae);
+    return String(buf);
+}
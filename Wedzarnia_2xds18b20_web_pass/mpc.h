@@ -0,0 +1,32 @@
+// mpc.h - Model FOPDT komory i regulator predykcyjny (MPC)
+// Identyfikacja: dyskretny model 1. rzędu z opóźnieniem (próbka MPC_SAMPLE_MS)
+//   dy = th0 * u[k-d] + th1 * (y - T0)/T0 + th2,   u = moc oddana [grzałki] (g_heaterPower)
+// uczony RLS równolegle dla każdego kandydata opóźnienia d = 0..MPC_MAX_DEAD;
+// wybierany kandydat z najmniejszym wygładzonym błędem predykcji.
+// Regulator: jeden ruch stały na horyzoncie MPC_HORIZON próbek za opóźnieniem,
+// koszt sum(r - y)^2 + MPC_MOVE_WEIGHT * (u - u_poprz)^2 – rozwiązanie
+// w postaci zamkniętej, ograniczenie 0..100% przez rzutowanie (dokładne dla
+// jednej zmiennej decyzyjnej). Opóźnienie znane z modelu = brak przeregulowania
+// po zmianie setpointu, na które PID reaguje dopiero po minucie.
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Próbka identyfikacji i krok regulatora – task sterowania, co obieg
+// (po ustawieniu pidInput / pidSetpoint); st = bieżący stan procesu
+void mpc_update(unsigned long nowMs, ProcessState st);
+// Wypełnienie MPC [%] lub NAN, gdy model nienauczony (wtedy PID)
+double mpc_getDuty();
+bool mpc_modelReady();
+// Wzmocnienie [C/grzałkę] i stała czasowa [min] modelu; false = nienauczony (bez zmian)
+bool mpc_getModel(double* gainPerHeater, double* tauMin);
+// Zerowanie modelu – wykona task sterowania w najbliższym mpc_update
+void mpc_requestReset();
+String mpc_getStatusJSON();
+// Symulacja skoku setpointu na zidentyfikowanym modelu: PID (nastawy
+// z harmonogramu, algorytm PID_v1) kontra MPC; przeregulowanie, czas
+// narastania i ustalania, IAE
+String mpc_benchmarkJSON(double from, double to, int powerMode, int minutes);
+// Symulacja otwarcia drzwi w stanie ustalonym: dotychczasowe wznowienie PID
+// (całka i pamięć pochodnej sprzed pauzy) kontra powrót z doorrec; czas powrotu
+String mpc_doorBenchmarkJSON(double setpoint, int openSec, int powerMode);
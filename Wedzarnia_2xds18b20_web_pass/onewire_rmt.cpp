@@ -0,0 +1,306 @@
+// onewire_rmt.cpp - Nieblokujący sterownik OneWire na peryferium RMT (ESP32)
+#include "onewire_rmt.h"
+#include "config.h"
+#include <OneWire.h>
+
+// Czasy w µs (rozdzielczość RMT = 1 MHz), wg noty DS18B20 (tryb standard)
+static constexpr uint32_t OW_RESOLUTION_HZ     = 1000000;
+static constexpr uint16_t OW_RESET_LOW_US      = 480;
+static constexpr uint16_t OW_RESET_WAIT_US     = 480;
+static constexpr uint16_t OW_PRESENCE_MAX_GAP  = 75;    // zwolnienie → zbocze presence
+static constexpr uint16_t OW_PRESENCE_MIN_US   = 50;
+static constexpr uint16_t OW_PRESENCE_MAX_US   = 300;
+static constexpr uint16_t OW_WRITE1_LOW_US     = 6;
+static constexpr uint16_t OW_WRITE0_LOW_US     = 60;
+static constexpr uint16_t OW_READ_LOW_US       = 3;
+static constexpr uint16_t OW_SLOT_US           = 70;
+static constexpr uint16_t OW_SAMPLE_US         = 15;    // krótszy impuls = odczytany bit 1
+static constexpr uint32_t OW_RX_GLITCH_NS      = 1000;
+static constexpr uint32_t OW_RX_IDLE_NS        = 1000000;  // 1 ms ciszy = koniec transakcji
+static constexpr unsigned long OW_TXN_TIMEOUT_MS = 50;
+
+static inline rmt_symbol_word_t owSymbol(uint16_t lowUs, uint16_t highUs) {
+    rmt_symbol_word_t s;
+    s.level0 = 0;
+    s.duration0 = lowUs;
+    s.level1 = 1;
+    s.duration1 = highUs;
+    return s;
+}
+
+bool IRAM_ATTR OneWireRmt::onRecvDone(rmt_channel_handle_t,
+                                      const rmt_rx_done_event_data_t* edata, void* ctx) {
+    OneWireRmt* self = static_cast<OneWireRmt*>(ctx);
+    BaseType_t woken = pdFALSE;
+    size_t num = edata->num_symbols;
+    xQueueSendFromISR(self->rxQueue, &num, &woken);
+    return woken == pdTRUE;
+}
+
+bool OneWireRmt::begin(int pin) {
+    if (active) return true;
+
+    // RX najpierw – TX z pętlą zwrotną podpina się pod ten sam pin
+    rmt_rx_channel_config_t rxCfg = {};
+    rxCfg.gpio_num = (gpio_num_t)pin;
+    rxCfg.clk_src = RMT_CLK_SRC_DEFAULT;
+    rxCfg.resolution_hz = OW_RESOLUTION_HZ;
+    rxCfg.mem_block_symbols = MAX_SYMBOLS;
+    if (rmt_new_rx_channel(&rxCfg, &rxChan) != ESP_OK) {
+        log_msg(LOG_LEVEL_ERROR, "OneWire RMT: RX channel allocation failed");
+        end();
+        return false;
+    }
+
+    rmt_tx_channel_config_t txCfg = {};
+    txCfg.gpio_num = (gpio_num_t)pin;
+    txCfg.clk_src = RMT_CLK_SRC_DEFAULT;
+    txCfg.resolution_hz = OW_RESOLUTION_HZ;
+    txCfg.mem_block_symbols = 64;
+    txCfg.trans_queue_depth = 2;
+    txCfg.flags.io_loop_back = 1;
+    txCfg.flags.io_od_mode = 1;
+    if (rmt_new_tx_channel(&txCfg, &txChan) != ESP_OK) {
+        log_msg(LOG_LEVEL_ERROR, "OneWire RMT: TX channel allocation failed");
+        end();
+        return false;
+    }
+
+    rmt_copy_encoder_config_t encCfg = {};
+    if (rmt_new_copy_encoder(&encCfg, &encoder) != ESP_OK) {
+        end();
+        return false;
+    }
+
+    rxQueue = xQueueCreate(1, sizeof(size_t));
+    if (!rxQueue) {
+        end();
+        return false;
+    }
+
+    rmt_rx_event_callbacks_t cbs = {};
+    cbs.on_recv_done = onRecvDone;
+    rmt_rx_register_event_callbacks(rxChan, &cbs, this);
+
+    rmt_enable(rxChan);
+    rmt_enable(txChan);
+
+    // Zwolnienie linii – w spoczynku TX ma trzymać poziom wysoki
+    rmt_symbol_word_t release = owSymbol(0, 0);
+    release.level0 = 1;
+    release.duration0 = 1;
+    rmt_transmit_config_t tc = {};
+    tc.flags.eot_level = 1;
+    rmt_transmit(txChan, encoder, &release, sizeof(release), &tc);
+    rmt_tx_wait_all_done(txChan, 10);
+
+    active = true;
+    busy = false;
+    lastStatus = OwStatus::IDLE;
+    LOG_FMT(LOG_LEVEL_INFO, "OneWire RMT driver active on GPIO %d", pin);
+    return true;
+}
+
+void OneWireRmt::end() {
+    if (txChan) {
+        if (active) rmt_disable(txChan);
+        rmt_del_channel(txChan);
+        txChan = nullptr;
+    }
+    if (rxChan) {
+        if (active) rmt_disable(rxChan);
+        rmt_del_channel(rxChan);
+        rxChan = nullptr;
+    }
+    if (encoder) {
+        rmt_del_encoder(encoder);
+        encoder = nullptr;
+    }
+    if (rxQueue) {
+        vQueueDelete(rxQueue);
+        rxQueue = nullptr;
+    }
+    active = false;
+    busy = false;
+}
+
+bool OneWireRmt::startTransaction(bool reset, const uint8_t* tx, uint16_t txBits, uint16_t rxBits) {
+    if (!active || busy) return false;
+    // RX widzi dodatkowo impuls presence
+    if ((reset ? 2 : 0) + txBits + rxBits > MAX_SYMBOLS) return false;
+    if (rxBits > MAX_RX_BYTES * 8) return false;
+
+    size_t n = 0;
+    if (reset) txSymbols[n++] = owSymbol(OW_RESET_LOW_US, OW_RESET_WAIT_US);
+    for (uint16_t i = 0; i < txBits; i++) {
+        bool bit = (tx[i / 8] >> (i % 8)) & 0x01;
+        txSymbols[n++] = bit ? owSymbol(OW_WRITE1_LOW_US, OW_SLOT_US - OW_WRITE1_LOW_US)
+                             : owSymbol(OW_WRITE0_LOW_US, OW_SLOT_US - OW_WRITE0_LOW_US);
+    }
+    for (uint16_t i = 0; i < rxBits; i++) {
+        txSymbols[n++] = owSymbol(OW_READ_LOW_US, OW_SLOT_US - OW_READ_LOW_US);
+    }
+    if (n == 0) return false;
+
+    xQueueReset(rxQueue);
+    rmt_receive_config_t rc = {};
+    rc.signal_range_min_ns = OW_RX_GLITCH_NS;
+    rc.signal_range_max_ns = OW_RX_IDLE_NS;
+    if (rmt_receive(rxChan, rxSymbols, sizeof(rxSymbols), &rc) != ESP_OK) {
+        return false;
+    }
+
+    rmt_transmit_config_t tc = {};
+    tc.flags.eot_level = 1;
+    if (rmt_transmit(txChan, encoder, txSymbols, n * sizeof(rmt_symbol_word_t), &tc) != ESP_OK) {
+        recover();
+        return false;
+    }
+
+    busy = true;
+    wireUs = (reset ? OW_RESET_LOW_US + OW_RESET_WAIT_US : 0) + (uint32_t)(txBits + rxBits) * OW_SLOT_US;
+    pendingReset = reset;
+    pendingTxBits = txBits;
+    pendingRxBits = rxBits;
+    startMs = millis();
+    startUs = micros();
+    return true;
+}
+
+OwStatus OneWireRmt::poll() {
+    if (!busy) return lastStatus;
+
+    size_t num = 0;
+    if (xQueueReceive(rxQueue, &num, 0) != pdTRUE) {
+        if (millis() - startMs > OW_TXN_TIMEOUT_MS) {
+            log_msg(LOG_LEVEL_WARN, "OneWire RMT: transaction timeout");
+            recover();
+            busy = false;
+            lastStatus = OwStatus::ERROR;
+            return lastStatus;
+        }
+        return OwStatus::BUSY;
+    }
+
+    busy = false;
+    durationUs = micros() - startUs;
+    lastStatus = decode(num);
+    return lastStatus;
+}
+
+OwStatus OneWireRmt::decode(size_t numSymbols) {
+    size_t idx = 0;
+    presenceDetected = false;
+    memset(rxBytes, 0, sizeof(rxBytes));
+    timing = {};
+    timing.sampleUs = OW_SAMPLE_US;
+    timing.minZeroLowUs = 0xFFFF;
+
+    if (pendingReset) {
+        if (numSymbols < 1) return OwStatus::ERROR;
+        // Presence: urządzenie ściąga linię tuż po zwolnieniu resetu
+        if (numSymbols > 1) {
+            timing.presenceGapUs = rxSymbols[0].duration1;
+            timing.presenceWidthUs = rxSymbols[1].duration0;
+        }
+        presenceDetected = numSymbols > 1 &&
+                           rxSymbols[0].duration1 < OW_PRESENCE_MAX_GAP &&
+                           rxSymbols[1].duration0 >= OW_PRESENCE_MIN_US &&
+                           rxSymbols[1].duration0 <= OW_PRESENCE_MAX_US;
+        timing.presence = presenceDetected;
+        if (!presenceDetected) return OwStatus::NO_PRESENCE;
+        idx = 2;
+    }
+
+    idx += pendingTxBits;
+    if (numSymbols < idx + pendingRxBits) return OwStatus::ERROR;
+
+    for (uint16_t i = 0; i < pendingRxBits; i++) {
+        uint16_t low = rxSymbols[idx + i].duration0;
+        if (low < OW_SAMPLE_US) {
+            rxBytes[i / 8] |= (uint8_t)(1 << (i % 8));
+            if (low > timing.maxOneLowUs) timing.maxOneLowUs = low;
+        } else if (low < timing.minZeroLowUs) {
+            timing.minZeroLowUs = low;
+        }
+    }
+    timing.readSlots = pendingRxBits > 0;
+    if (timing.minZeroLowUs == 0xFFFF) timing.minZeroLowUs = 0;
+    return OwStatus::DONE;
+}
+
+void OneWireRmt::recover() {
+    // Przerwanie zawieszonego odbioru i wyczyszczenie kolejki
+    rmt_disable(rxChan);
+    rmt_enable(rxChan);
+    xQueueReset(rxQueue);
+}
+
+OwStatus OneWireRmt::transact(bool reset, const uint8_t* tx, uint16_t txBits, uint16_t rxBits) {
+    if (!startTransaction(reset, tx, txBits, rxBits)) return OwStatus::ERROR;
+    OwStatus st;
+    while ((st = poll()) == OwStatus::BUSY) {
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    return st;
+}
+
+void OneWireRmt::resetSearch() {
+    memset(searchRom, 0, sizeof(searchRom));
+    lastDiscrepancy = 0;
+    lastDeviceFound = false;
+}
+
+bool OneWireRmt::search(uint8_t rom[8]) {
+    if (!active || lastDeviceFound) return false;
+
+    // Reset + SEARCH ROM + pierwsza para bitów (id, dopełnienie)
+    static const uint8_t cmd = 0xF0;
+    if (transact(true, &cmd, 8, 2) != OwStatus::DONE) {
+        resetSearch();
+        return false;
+    }
+
+    int lastZero = 0;
+    for (int bitNo = 1; bitNo <= 64; bitNo++) {
+        bool idBit = rxBytes[0] & 0x01;
+        bool cmpBit = rxBytes[0] & 0x02;
+        if (idBit && cmpBit) {
+            resetSearch();
+            return false;
+        }
+
+        int byteIdx = (bitNo - 1) / 8;
+        uint8_t mask = (uint8_t)(1 << ((bitNo - 1) % 8));
+        bool dir;
+        if (idBit != cmpBit) {
+            dir = idBit;
+        } else if (bitNo < lastDiscrepancy) {
+            dir = (searchRom[byteIdx] & mask) != 0;
+        } else {
+            dir = (bitNo == lastDiscrepancy);
+        }
+        if (!dir && idBit == cmpBit) lastZero = bitNo;
+
+        if (dir) searchRom[byteIdx] |= mask;
+        else searchRom[byteIdx] &= (uint8_t)~mask;
+
+        // Wybór gałęzi + para bitów kolejnej pozycji w jednej transakcji
+        uint8_t dirBit = dir ? 1 : 0;
+        uint16_t rxBits = (bitNo < 64) ? 2 : 0;
+        if (transact(false, &dirBit, 1, rxBits) != OwStatus::DONE) {
+            resetSearch();
+            return false;
+        }
+    }
+
+    lastDiscrepancy = lastZero;
+    if (lastDiscrepancy == 0) lastDeviceFound = true;
+
+    if (OneWire::crc8(searchRom, 7) != searchRom[7]) {
+        resetSearch();
+        return false;
+    }
+    memcpy(rom, searchRom, 8);
+    return true;
+}
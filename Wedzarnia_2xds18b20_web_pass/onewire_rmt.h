@@ -0,0 +1,94 @@
+// onewire_rmt.h - Nieblokujący sterownik OneWire na peryferium RMT (ESP32)
+// Reset, sloty zapisu i odczytu generuje sprzęt (kanał TX w trybie open-drain),
+// a stan linii zbiera kanał RX z pętlą zwrotną. Jedna transakcja =
+// [reset] + N bitów zapisu + M slotów odczytu, bez wyłączania przerwań.
+#pragma once
+#include <Arduino.h>
+#include <driver/rmt_tx.h>
+#include <driver/rmt_rx.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+// Przebieg elektryczny ostatniej transakcji (z symboli RX) – diagnostyka kabla:
+// długi/obciążony kabel wydłuża narastanie zbocza, więc "1" w slocie odczytu
+// zbliża się do progu próbkowania, a presence przesuwa się w czasie
+struct OwTiming {
+    uint16_t presenceGapUs;        // zwolnienie resetu → początek presence (norma 15-60)
+    uint16_t presenceWidthUs;      // szerokość presence (norma 60-240)
+    uint16_t maxOneLowUs;          // najdłuższe "0" w slocie odczytanym jako 1 (margines narastania)
+    uint16_t minZeroLowUs;         // najkrótsze "0" w slocie odczytanym jako 0
+    uint16_t sampleUs;             // próg próbkowania bitu
+    bool presence;
+    bool readSlots;
+};
+
+enum class OwStatus {
+    IDLE,
+    BUSY,
+    DONE,
+    NO_PRESENCE,
+    ERROR
+};
+
+class OneWireRmt {
+public:
+    // Reset + 10 bajtów (MATCH ROM + adres + komenda) + 9 bajtów scratchpada = 154 symbole
+    static constexpr int MAX_SYMBOLS = 192;
+    static constexpr int MAX_RX_BYTES = 16;
+
+    bool begin(int pin);
+    void end();
+    bool isActive() const { return active; }
+    bool isBusy() const { return busy; }
+
+    // Start transakcji – zwraca od razu; wynik odbiera poll()
+    bool startTransaction(bool reset, const uint8_t* tx, uint16_t txBits, uint16_t rxBits);
+    OwStatus poll();
+
+    const uint8_t* rxData() const { return rxBytes; }
+    bool presence() const { return presenceDetected; }
+    unsigned long lastDurationUs() const { return durationUs; }
+    // Czas zajęcia linii przez ostatnią transakcję (suma slotów, bez opóźnienia odpytania)
+    unsigned long lastWireTimeUs() const { return wireUs; }
+    const OwTiming& lastTiming() const { return timing; }
+
+    // Wersja blokująca (czeka oddając CPU) – tylko poza cyklem pomiaru
+    OwStatus transact(bool reset, const uint8_t* tx, uint16_t txBits, uint16_t rxBits);
+
+    // Wyszukiwanie urządzeń (Maxim AN187) – każdy krok bitu to osobna transakcja
+    void resetSearch();
+    bool search(uint8_t rom[8]);
+
+private:
+    static bool onRecvDone(rmt_channel_handle_t channel,
+                           const rmt_rx_done_event_data_t* edata, void* ctx);
+    OwStatus decode(size_t numSymbols);
+    void recover();
+
+    rmt_channel_handle_t txChan = nullptr;
+    rmt_channel_handle_t rxChan = nullptr;
+    rmt_encoder_handle_t encoder = nullptr;
+    QueueHandle_t rxQueue = nullptr;
+
+    rmt_symbol_word_t txSymbols[MAX_SYMBOLS];
+    rmt_symbol_word_t rxSymbols[MAX_SYMBOLS];
+    uint8_t rxBytes[MAX_RX_BYTES];
+
+    bool active = false;
+    bool busy = false;
+    bool pendingReset = false;
+    uint16_t pendingTxBits = 0;
+    uint16_t pendingRxBits = 0;
+    bool presenceDetected = false;
+    OwStatus lastStatus = OwStatus::IDLE;
+    unsigned long startMs = 0;
+    unsigned long startUs = 0;
+    unsigned long durationUs = 0;
+    unsigned long wireUs = 0;
+    OwTiming timing = {};
+
+    // Stan wyszukiwania
+    uint8_t searchRom[8] = {0};
+    int lastDiscrepancy = 0;
+    bool lastDeviceFound = false;
+};
@@ -2,6 +2,9 @@
 #include "outputs.h"
 #include "config.h"
 #include "state.h"
+#include "ssrout.h"
+#include "storage.h"
+#include "powerbudget.h"
 
 // --- Zmienne dla brzęczyka ---
 static volatile bool buzzerActive = false;
@@ -14,6 +17,15 @@ static volatile unsigned long buzzerPhaseEnd = 0;
 // --- Zmienne dla grzałek (chronione heaterMutex) ---
 static HeaterEnable he;
 
+// --- Wyrównanie zużycia grzałek (tylko task sterowania) ---
+// loadOrder[i] = fizyczna grzałka (0..2) na i-tym stopniu obciążenia;
+// stopień 0 = obciążenie bazowe (w trybach 2 i 3 pierwszy dochodzi do 100 %)
+static uint8_t loadOrder[HEATER_COUNT] = {0, 1, 2};
+static double lastHeaterPct[HEATER_COUNT] = {0.0, 0.0, 0.0};
+static unsigned long lastMapMs = 0;
+static unsigned long lastRuntimeSaveMs = 0;
+static double savedRuntimeTotal = -1.0;      // zapis do NVS tylko po zmianie
+
 // --- Zmienne dla wentylatora cyklicznego (atomic) ---
 static volatile bool fanState = true;
 static volatile unsigned long fanTimer = 0;
@@ -24,11 +36,17 @@ void allOutputsOff() {
         log_msg(LOG_LEVEL_ERROR, "allOutputsOff: output_lock failed!");
         // Mimo to spróbuj wyłączyć wyjścia - bezpieczeństwo ważniejsze
     }
-    ledcWrite(PIN_SSR1, 0);
-    ledcWrite(PIN_SSR2, 0);
-    ledcWrite(PIN_SSR3, 0);
+    if (CFG_SSR_BURST) {
+        ssrout_allOff();
+    } else {
+        ledcWrite(PIN_SSR1, 0);
+        ledcWrite(PIN_SSR2, 0);
+        ledcWrite(PIN_SSR3, 0);
+    }
     digitalWrite(PIN_FAN, LOW);
     ledcWrite(PIN_SMOKE_FAN, 0);
+    powerbudget_smokeOff();
+    for (int i = 0; i < HEATER_COUNT; i++) lastHeaterPct[i] = 0.0;
     output_unlock();
 }
 
@@ -96,14 +114,79 @@ bool areHeatersReady() {
     return ready;
 }
 
+// Kolejność obciążenia: rosnąco po czasie pracy wszystkich grzałek – pierwsze
+// pm to grzałki używane w danym trybie (najmniej zużyte). Przy wyłączonym
+// wyjściu – od razu; w trakcie grzania dopiero, gdy grzałka wyżej w kolejności
+// (albo nieużywana) ma o HEATER_ROTATE_HYST_SEC mniej pracy niż używana przed
+// nią (bez przerzucania co obieg). Rozkład na stopnie nie zmienia sumy mocy.
+static void updateLoadOrder(int pm, const double* rt, bool idle) {
+    uint8_t sorted[HEATER_COUNT];
+    for (int i = 0; i < HEATER_COUNT; i++) sorted[i] = i;
+    for (int i = 1; i < HEATER_COUNT; i++) {
+        uint8_t h = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && rt[sorted[j]] > rt[h]) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = h;
+    }
+
+    bool worn = false;
+    for (int i = 0; i < pm; i++) {
+        for (int j = i + 1; j < HEATER_COUNT; j++) {
+            if (rt[loadOrder[i]] - rt[loadOrder[j]] > HEATER_ROTATE_HYST_SEC) worn = true;
+        }
+    }
+    bool differs = false;
+    for (int i = 0; i < pm; i++) {
+        if (sorted[i] != loadOrder[i]) differs = true;
+    }
+    if (!differs || !(worn || idle)) return;
+
+    for (int i = 0; i < HEATER_COUNT; i++) loadOrder[i] = sorted[i];
+    LOG_FMT(LOG_LEVEL_INFO, "Heater load order: %d-%d-%d (runtime %.1f / %.1f / %.1f h)",
+            loadOrder[0] + 1, loadOrder[1] + 1, loadOrder[2] + 1,
+            rt[0] / 3600.0, rt[1] / 3600.0, rt[2] / 3600.0);
+}
+
+int getBaseLoadHeater() {
+    return loadOrder[0] + 1;
+}
+
 void mapPowerToHeaters() {
     double p1 = 0, p2 = 0, p3 = 0;
     double p = constrain(pidOutput, 0, 100);
+    unsigned long now = millis();
+    double rt[HEATER_COUNT];
 
     // [FIX] Sprawdzenie locka
     if (!state_lock()) return;
     int pm = g_powerMode;
+    SsrMode ssrMode = g_ssrMode;
+    unsigned long ssrWindowMs = g_ssrWindowMs;
+    PowerBudget budget = g_powerBudget;
+    // Czas pracy z wypełnienia poprzedniego obiegu (przerwa > 5 s = wyjścia stały)
+    if (lastMapMs != 0 && now - lastMapMs < 5000) {
+        double dt = (now - lastMapMs) / 1000.0;
+        for (int i = 0; i < HEATER_COUNT; i++) g_heaterRuntimeSec[i] += lastHeaterPct[i] / 100.0 * dt;
+    }
+    for (int i = 0; i < HEATER_COUNT; i++) rt[i] = g_heaterRuntimeSec[i];
+    // Wyjścia poprzedniego obiegu = moc faktycznie oddana (budżet, wyłączone grzałki)
+    g_heaterPower = (lastHeaterPct[0] + lastHeaterPct[1] + lastHeaterPct[2]) / 100.0;
     state_unlock();
+    lastMapMs = now;
+
+    double rtTotal = rt[0] + rt[1] + rt[2];
+    if (savedRuntimeTotal < 0.0) savedRuntimeTotal = rtTotal;
+    if (now - lastRuntimeSaveMs >= HEATER_RUNTIME_SAVE_MS) {
+        lastRuntimeSaveMs = now;
+        if (rtTotal != savedRuntimeTotal) {
+            savedRuntimeTotal = rtTotal;
+            storage_save_heater_runtime_nvs();
+        }
+    }
+    updateLoadOrder(constrain(pm, CFG_POWERMODE_MIN, CFG_POWERMODE_MAX), rt, p <= 0.0);
 
     if (pm == 1) {
         p1 = p;
@@ -116,6 +199,14 @@ void mapPowerToHeaters() {
         else { p1 = 100; p2 = 100; p3 = (p - 66) * 3; }
     }
 
+    // Stopnie obciążenia -> fizyczne grzałki
+    double load[HEATER_COUNT] = {p1, p2, p3};
+    double heater[HEATER_COUNT];
+    for (int i = 0; i < HEATER_COUNT; i++) heater[loadOrder[i]] = constrain(load[i], 0.0, 100.0);
+    p1 = heater[0];
+    p2 = heater[1];
+    p3 = heater[2];
+
     // [FIX] Sprawdzenie locka
     if (!heater_lock()) return;
     if (!he.h1) p1 = 0;
@@ -123,10 +214,38 @@ void mapPowerToHeaters() {
     if (!he.h3) p3 = 0;
     heater_unlock();
 
+    // Budżet mocy przyłącza – po rozkładzie na grzałki, przed zapisem SSR
+    double out[HEATER_COUNT] = {p1, p2, p3};
+    powerbudget_applyHeaters(budget, loadOrder, constrain(pm, CFG_POWERMODE_MIN, CFG_POWERMODE_MAX), out, now);
+    p1 = out[0];
+    p2 = out[1];
+    p3 = out[2];
+    lastHeaterPct[0] = p1;
+    lastHeaterPct[1] = p2;
+    lastHeaterPct[2] = p3;
+
+    if (!output_lock()) return;
+    if (CFG_SSR_BURST) {
+        ssrout_setMode(ssrMode, ssrWindowMs);
+        ssrout_setDuty(0, p1);
+        ssrout_setDuty(1, p2);
+        ssrout_setDuty(2, p3);
+    } else {
+        ledcWrite(PIN_SSR1, (int)(p1 * 2.55));
+        ledcWrite(PIN_SSR2, (int)(p2 * 2.55));
+        ledcWrite(PIN_SSR3, (int)(p3 * 2.55));
+    }
+    output_unlock();
+}
+
+void setSmokePwm(int pwm) {
+    if (!state_lock()) return;
+    PowerBudget budget = g_powerBudget;
+    state_unlock();
+
+    int allowed = powerbudget_applySmoke(budget, pwm);
     if (!output_lock()) return;
-    ledcWrite(PIN_SSR1, (int)(p1 * 2.55));
-    ledcWrite(PIN_SSR2, (int)(p2 * 2.55));
-    ledcWrite(PIN_SSR3, (int)(p3 * 2.55));
+    ledcWrite(PIN_SMOKE_FAN, allowed);
     output_unlock();
 }
 
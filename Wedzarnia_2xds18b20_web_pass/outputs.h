@@ -8,5 +8,7 @@ void handleBuzzer();
 void initHeaterEnable();
 void applySoftEnable();
 void mapPowerToHeaters();
+void setSmokePwm(int pwm);  // generator dymu przez budżet mocy
 void handleFanLogic();
 bool areHeatersReady();  // NOWE: sprawdza czy wszystkie grzałki soft-enabled
+int getBaseLoadHeater(); // grzałka 1..3 z obciążeniem bazowym (wyrównanie zużycia)
@@ -0,0 +1,118 @@
+// powerbudget.cpp - Ograniczenie sumy mocy grzałek i dymu z podziałem wg priorytetu
+#include "powerbudget.h"
+#include "state.h"
+
+struct PowerBudgetRun {
+    double heaterW;                // moc grzałek po ograniczeniu (ostatnia aktualizacja)
+    double heaterDemandW;
+    double smokeW;                 // moc dymu po ograniczeniu
+    double smokeDemandW;
+    bool heaterLimited;
+    bool smokeLimited;
+    double capPct;
+    // Epizody ograniczenia
+    bool limiting;
+    unsigned long limitStartMs;
+    unsigned long lastLimitedMs;
+    unsigned long lastUpdateMs;
+    unsigned long limitedMs;       // łączny czas z ograniczeniem od startu
+    unsigned long episodes;
+    double peakDemandW;
+};
+
+static PowerBudgetRun pbr = {0.0, 0.0, 0.0, 0.0, false, false, 100.0};
+
+int powerbudget_applySmoke(const PowerBudget& cfg, int pwm) {
+    pwm = constrain(pwm, CFG_SMOKE_PWM_MIN, CFG_SMOKE_PWM_MAX);
+    pbr.smokeDemandW = (double)pwm / CFG_SMOKE_PWM_MAX * cfg.smokeW;
+    int allowed = pwm;
+    if (cfg.limitW > 0 && cfg.smokeW > 0) {
+        double availW = cfg.smokeFirst ? (double)cfg.limitW : max(0.0, cfg.limitW - pbr.heaterW);
+        if (pbr.smokeDemandW > availW) {
+            allowed = (int)(availW / cfg.smokeW * CFG_SMOKE_PWM_MAX);
+        }
+    }
+    pbr.smokeLimited = (allowed < pwm);
+    pbr.smokeW = (double)allowed / CFG_SMOKE_PWM_MAX * cfg.smokeW;
+    return allowed;
+}
+
+void powerbudget_smokeOff() {
+    pbr.smokeDemandW = 0.0;
+    pbr.smokeW = 0.0;
+    pbr.smokeLimited = false;
+}
+
+void powerbudget_applyHeaters(const PowerBudget& cfg, const uint8_t* loadOrder, int powerMode,
+                              double* heaterPct, unsigned long nowMs) {
+    double demandW = 0.0;
+    for (int i = 0; i < HEATER_COUNT; i++) demandW += heaterPct[i] / 100.0 * cfg.heaterW[i];
+    pbr.heaterDemandW = demandW;
+
+    pbr.heaterLimited = false;
+    pbr.capPct = 100.0;
+    if (cfg.limitW > 0) {
+        double availW = max(0.0, cfg.limitW - (cfg.smokeFirst ? pbr.smokeW : 0.0));
+        if (demandW > availW) {
+            double scale = availW / demandW;
+            for (int i = 0; i < HEATER_COUNT; i++) heaterPct[i] *= scale;
+            demandW = availW;
+            pbr.heaterLimited = true;
+        }
+        // pidOutput 100 % = wszystkie używane grzałki na pełnej mocy
+        double fullW = 0.0;
+        for (int i = 0; i < powerMode && i < HEATER_COUNT; i++) fullW += cfg.heaterW[loadOrder[i]];
+        if (fullW > 0.0) pbr.capPct = constrain(availW / fullW * 100.0, 0.0, 100.0);
+    }
+    pbr.heaterW = demandW;
+
+    // Czas z ograniczeniem i epizody (koniec po POWER_LIMIT_LOG_HOLD_MS bez ograniczenia)
+    bool limited = pbr.heaterLimited || pbr.smokeLimited;
+    unsigned long dt = (pbr.lastUpdateMs != 0) ? nowMs - pbr.lastUpdateMs : 0;
+    pbr.lastUpdateMs = nowMs;
+    if (limited) {
+        if (dt < 5000) pbr.limitedMs += dt;
+        pbr.lastLimitedMs = nowMs;
+        pbr.peakDemandW = max(pbr.peakDemandW, pbr.heaterDemandW + pbr.smokeDemandW);
+        if (!pbr.limiting) {
+            pbr.limiting = true;
+            pbr.limitStartMs = nowMs;
+            pbr.episodes++;
+            LOG_FMT(LOG_LEVEL_WARN, "Power budget: limiting (demand %.0f W > limit %u W)",
+                    pbr.heaterDemandW + pbr.smokeDemandW, cfg.limitW);
+        }
+    } else if (pbr.limiting && nowMs - pbr.lastLimitedMs >= POWER_LIMIT_LOG_HOLD_MS) {
+        pbr.limiting = false;
+        LOG_FMT(LOG_LEVEL_INFO, "Power budget: limit released after %lus (total limited %lus)",
+                (pbr.lastLimitedMs - pbr.limitStartMs) / 1000UL, pbr.limitedMs / 1000UL);
+    }
+}
+
+double powerbudget_heaterCapPct() {
+    return pbr.capPct;
+}
+
+bool powerbudget_limiting() {
+    return pbr.limiting;
+}
+
+String powerbudget_getStatusJSON() {
+    PowerBudget cfg = {};
+    if (state_lock()) {
+        cfg = g_powerBudget;
+        state_unlock();
+    }
+    char buf[512];
+    snprintf(buf, sizeof(buf),
+        "{\"limitW\":%u,\"heaterW\":[%u,%u,%u],\"smokeW\":%u,\"priority\":\"%s\","
+        "\"demandW\":%.0f,\"actualW\":%.0f,\"heaterActualW\":%.0f,\"smokeActualW\":%.0f,"
+        "\"limiting\":%s,\"heaterLimited\":%s,\"smokeLimited\":%s,\"capPct\":%.1f,"
+        "\"limitedSec\":%lu,\"episodes\":%lu,\"peakDemandW\":%.0f}",
+        cfg.limitW, cfg.heaterW[0], cfg.heaterW[1], cfg.heaterW[2], cfg.smokeW,
+        cfg.smokeFirst ? "smoke" : "heaters",
+        pbr.heaterDemandW + pbr.smokeDemandW, pbr.heaterW + pbr.smokeW, pbr.heaterW, pbr.smokeW,
+        pbr.limiting ? "true" : "false", pbr.heaterLimited ? "true" : "false",
+        pbr.smokeLimited ? "true" : "false", pbr.capPct,
+        pbr.limitedMs / 1000UL, pbr.episodes, pbr.peakDemandW);
+    return String(buf);
+}
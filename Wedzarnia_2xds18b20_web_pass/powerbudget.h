@@ -0,0 +1,23 @@
+// powerbudget.h - Budżet mocy przyłącza: grzałki + generator dymu <= limit
+// Między pidOutput a zapisem wyjść (outputs.cpp), w każdej aktualizacji:
+//  - dym: wypełnienie obcięte do mocy, która zostaje wg priorytetu
+//    (smokeFirst – cały limit, inaczej limit minus bieżące grzałki),
+//  - grzałki: gdy zapotrzebowanie przekracza dostępne, wszystkie skalowane
+//    tym samym współczynnikiem (podział proporcjonalny, bez zmiany rozkładu).
+// Czas pracy z ograniczeniem liczony i logowany (początek / koniec epizodu).
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Wywołania tylko z taska sterowania (outputs.cpp); cfg = migawka g_powerBudget
+int powerbudget_applySmoke(const PowerBudget& cfg, int pwm);
+// Dym wyłączony poza powerbudget_applySmoke (allOutputsOff)
+void powerbudget_smokeOff();
+// heaterPct[HEATER_COUNT] – fizyczne grzałki [%], modyfikowane w miejscu;
+// loadOrder[0..powerMode-1] = używane grzałki (do sufitu dla PID)
+void powerbudget_applyHeaters(const PowerBudget& cfg, const uint8_t* loadOrder, int powerMode,
+                              double* heaterPct, unsigned long nowMs);
+// Sufit pidOutput [%] z budżetu (100 = bez ograniczenia) – anti-windup PID
+double powerbudget_heaterCapPct();
+bool powerbudget_limiting();
+String powerbudget_getStatusJSON();
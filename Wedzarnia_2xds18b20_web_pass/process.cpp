@@ -5,19 +5,53 @@
 #include "state.h"
 #include "outputs.h"
 #include "ui.h"
-
-// Struktura dla adaptacyjnego PID
+#include "estimator.h"
+#include "lagcomp.h"
+#include "vchamber.h"
+#include "feedforward.h"
+#include "meateta.h"
+#include "storage.h"
+#include "gainsched.h"
+#include "mpc.h"
+#include "doorrec.h"
+#include "powerbudget.h"
+
+// Nastawy PID z harmonogramu (gainsched) aktualnie zadane regulatorowi
 struct AdaptivePID {
-    double errorHistory[10] = {0};
-    int historyIndex = 0;
-    unsigned long lastAdaptation = 0;
     double currentKp = CFG_Kp;
     double currentKi = CFG_Ki;
     double currentKd = CFG_Kd;
+    bool scheduled = false;        // z harmonogramu (false = autotune / CFG_K*)
+    bool applied = false;          // false = następny obieg ustawia nastawy od zera
+    double lastError = 0.0;        // błąd z ostatniego wykonanego Compute()
 };
 
 static AdaptivePID adaptivePid;
 
+// Sondy mięsa, które w bieżącym kroku osiągnęły cel (reguła ALL)
+static uint16_t meatReachedMask = 0;
+// Sondy bez świeżego odczytu dłużej niż MEAT_PROBE_LOST_MS – reguła ALL ich nie czeka
+static uint16_t meatLostMask = 0;
+static unsigned long meatSeenMs[MEAT_PROBES_MAX] = {};
+
+// Detekcja plateau mięsa: okno próbek temperatury co STALL_SAMPLE_MS
+struct StallMonitor {
+    double samples[STALL_WINDOW_SAMPLES + 1];
+    int count;                     // próbki w oknie (ciągłe, bez przerw warunków)
+    int head;
+    unsigned long lastSampleMs;
+    double raised;                 // suma podniesień setpointu w bieżącym kroku
+};
+
+static StallMonitor stall = {};
+
+static void resetStallMonitor() {
+    stall.count = 0;
+    stall.head = 0;
+    stall.lastSampleMs = 0;
+    stall.raised = 0.0;
+}
+
 // Historia temperatury dla predykcyjnego sterowania wentylatorem
 static double tempHistory[5] = {0};
 static int tempHistoryIndex = 0;
@@ -59,8 +93,15 @@ void resetHeaterFaultMonitor() {
  * Gdy któryś z warunków odpada (np. temp doszła do celu) → monitoring wyłączany, reset.
  */
 static void checkHeaterEfficiency() {
+    TempEstimate est = estimator_get(EST_CHAMBER);
     if (!state_lock()) return;
-    double currentTemp  = g_tChamber;
+    // Na modelu komory brak pomiaru, który mógłby potwierdzić awarię grzałki
+    if (g_chamberVirtual) {
+        state_unlock();
+        hfm.monitoring = false;
+        return;
+    }
+    double currentTemp  = est.valid ? est.temp : g_tChamber;
     double setpoint     = g_tSet;
     double pid          = pidOutput;
     ProcessState st     = g_currentState;
@@ -166,30 +207,13 @@ static void updateProcessStats() {
         }
 
         if (g_currentState == ProcessState::RUNNING_AUTO) {
-            unsigned long elapsedTotal = (now - g_processStartTime) / 1000;
-
-            unsigned long completedTime = 0;
-            for (int i = 0; i < g_currentStep; i++) {
-                if (i < g_stepCount) {
-                    completedTime += g_profile[i].minTimeMs / 1000;
-                }
-            }
-
-            unsigned long stepElapsed = (now - g_stepStartTime) / 1000;
-            unsigned long stepTotal = 0;
-            if (g_currentStep >= 0 && g_currentStep < g_stepCount) {
-                stepTotal = g_profile[g_currentStep].minTimeMs / 1000;
-            }
-            unsigned long stepRemaining = (stepTotal > stepElapsed) ? (stepTotal - stepElapsed) : 0;
-
-            unsigned long futureTime = 0;
-            for (int i = g_currentStep + 1; i < g_stepCount; i++) {
-                futureTime += g_profile[i].minTimeMs / 1000;
-            }
-
-            g_processStats.remainingProcessTimeSec = stepRemaining + futureTime;
+            // Czas minimalny kroków + przewidywany czas dojścia mięsa
+            // w krokach z warunkiem temperatury mięsa
+            g_processStats.remainingProcessTimeSec = meateta_predictRemaining(now);
         } else {
             g_processStats.remainingProcessTimeSec = 0;
+            g_processStats.stepEtaSec = -1;
+            g_processStats.etaPredicted = false;
         }
     }
 
@@ -197,60 +221,46 @@ static void updateProcessStats() {
     state_unlock();
 }
 
-static void adaptPidParameters() {
-    unsigned long now = millis();
-    if (now - adaptivePid.lastAdaptation < PID_ADAPTATION_INTERVAL) return;
-
-    double currentError = pidSetpoint - pidInput;
-
-    adaptivePid.errorHistory[adaptivePid.historyIndex] = currentError;
-    adaptivePid.historyIndex = (adaptivePid.historyIndex + 1) % 10;
+static bool gainsDiffer(double a, double b) {
+    return fabs(a - b) > GS_MIN_CHANGE * max(fabs(a), fabs(b));
+}
 
-    double errorMean = 0;
-    double errorVariance = 0;
-    int validCount = 0;
+// Harmonogram nastaw (setpoint x tryb mocy) zamiast heurystyki wariancji
+// błędu. Przełączenie bez skoku wyjścia: PID_v1 liczy u = Kp*e + I, więc przy
+// zmianie Kp całka przestawiana na I' = u - Kp'*e, z e z ostatniego Compute().
+// Nowy setpoint z applyCurrentStep() działa potem przez część P jak zwykła
+// zmiana zadanej – skok wynika z błędu, nie z podmiany nastaw.
+static void adaptPidParameters() {
+    if (!state_lock()) return;
+    int pm = g_powerMode;
+    state_unlock();
 
-    for (int i = 0; i < 10; i++) {
-        if (fabs(adaptivePid.errorHistory[i]) < 50) {
-            errorMean += adaptivePid.errorHistory[i];
-            validCount++;
-        }
+    PidGains g;
+    bool scheduled = gainsched_lookup(pidSetpoint, pm, &g);
+    if (adaptivePid.applied &&
+        !gainsDiffer(g.kp, adaptivePid.currentKp) &&
+        !gainsDiffer(g.ki, adaptivePid.currentKi) &&
+        !gainsDiffer(g.kd, adaptivePid.currentKd)) {
+        return;
     }
 
-    if (validCount > 0) {
-        errorMean /= validCount;
-
-        for (int i = 0; i < 10; i++) {
-            if (fabs(adaptivePid.errorHistory[i]) < 50) {
-                errorVariance += pow(adaptivePid.errorHistory[i] - errorMean, 2);
-            }
-        }
-        errorVariance /= validCount;
-
-        if (errorVariance > 5.0) {
-            adaptivePid.currentKp = CFG_Kp * 0.8;
-            adaptivePid.currentKi = CFG_Ki * 0.5;
-            adaptivePid.currentKd = CFG_Kd * 1.2;
-        } else if (errorVariance < 0.5 && fabs(currentError) < 2.0) {
-            adaptivePid.currentKp = CFG_Kp * 1.2;
-            adaptivePid.currentKi = CFG_Ki * 0.8;
-            adaptivePid.currentKd = CFG_Kd * 0.8;
-        } else {
-            adaptivePid.currentKp = CFG_Kp;
-            adaptivePid.currentKi = CFG_Ki;
-            adaptivePid.currentKd = CFG_Kd;
-        }
-
-        pid.SetTunings(adaptivePid.currentKp, adaptivePid.currentKi, adaptivePid.currentKd);
-
-        if (adaptivePid.lastAdaptation > 0) {
-            LOG_FMT(LOG_LEVEL_DEBUG, "PID adapted: Kp=%.2f Ki=%.2f Kd=%.2f var=%.2f",
-                     adaptivePid.currentKp, adaptivePid.currentKi, adaptivePid.currentKd,
-                     errorVariance);
-        }
+    pid.SetTunings(g.kp, g.ki, g.kd);
+    if (adaptivePid.applied) {
+        // SetMode(AUTOMATIC) -> Initialize(): suma całki = bieżące wyjście
+        double u = pidFeedback;
+        pidFeedback = u - g.kp * adaptivePid.lastError;
+        pid.SetMode(MANUAL);
+        pid.SetMode(AUTOMATIC);
+        pidFeedback = u;
     }
 
-    adaptivePid.lastAdaptation = now;
+    LOG_FMT(LOG_LEVEL_DEBUG, "PID gains %s (set %.1f, mode %d): Kp=%.2f Ki=%.4f Kd=%.1f",
+            scheduled ? "scheduled" : "default", pidSetpoint, pm, g.kp, g.ki, g.kd);
+    adaptivePid.currentKp = g.kp;
+    adaptivePid.currentKi = g.ki;
+    adaptivePid.currentKd = g.kd;
+    adaptivePid.scheduled = scheduled;
+    adaptivePid.applied = true;
 }
 
 // ======================================================
@@ -304,13 +314,64 @@ void predictiveFanControl() {
 // TRYB AUTO
 // ======================================================
 
+const char* meatRuleName(MeatRule rule) {
+    switch (rule) {
+        case MeatRule::MEAN: return "mean";
+        case MeatRule::ALL:  return "all";
+        default:             return "min";
+    }
+}
+
+// Warunek temperatury mięsa przy wielu sondach. Sonda główna (0) – jak dotąd
+// estymata lub ostatni odczyt z cache; dodatkowe – NAN, gdy bez świeżego odczytu.
+static bool meatTargetReached(MeatRule rule, double target, const double* probes, uint16_t mask,
+                              unsigned long now) {
+    double minT = 1e9, sum = 0.0;
+    int n = 0;
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) {
+        if (!(mask & (1 << i))) continue;
+        uint16_t bit = (uint16_t)(1 << i);
+        if (isnan(probes[i])) {
+            if (!(meatLostMask & bit) && now - meatSeenMs[i] > MEAT_PROBE_LOST_MS) {
+                meatLostMask |= bit;
+                LOG_FMT(LOG_LEVEL_WARN, "Meat probe %d: no reading for %lus - ignored by ALL rule",
+                        i + 1, MEAT_PROBE_LOST_MS / 1000UL);
+            }
+            continue;
+        }
+        meatSeenMs[i] = now;
+        if (meatLostMask & bit) {
+            meatLostMask &= (uint16_t)~bit;
+            LOG_FMT(LOG_LEVEL_INFO, "Meat probe %d: reading again", i + 1);
+        }
+        if (probes[i] >= target) meatReachedMask |= (uint16_t)(1 << i);
+        minT = min(minT, probes[i]);
+        sum += probes[i];
+        n++;
+    }
+    if (n == 0) return false;
+
+    switch (rule) {
+        case MeatRule::MEAN: return sum / n >= target;
+        // Każda przypisana sonda (także chwilowo niesprawna) musi osiągnąć cel;
+        // sonda bez odczytu dłużej niż MEAT_PROBE_LOST_MS nie blokuje kroku
+        case MeatRule::ALL:  return ((meatReachedMask | meatLostMask) & mask) == mask;
+        default:             return minT >= target;
+    }
+}
+
 static void handleAutoMode() {
+    TempEstimate meatEst = estimator_get(EST_MEAT);
+    double meatProbes[MEAT_PROBES_MAX];
     if (!state_lock()) return;
     int step = g_currentStep;
     int count = g_stepCount;
     unsigned long stepStart = g_stepStartTime;
-    double meat = g_tMeat;
+    double meat = meatEst.valid ? meatEst.temp : g_tMeat;
+    uint16_t meatMask = g_meatProbeMask;
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) meatProbes[i] = g_tMeatProbes[i];
     state_unlock();
+    meatProbes[0] = meat;
 
     if (step < 0 || step >= count) {
         LOG_FMT(LOG_LEVEL_ERROR, "Invalid step in AUTO mode: %d", step);
@@ -326,9 +387,15 @@ static void handleAutoMode() {
     unsigned long elapsed = millis() - stepStart;
 
     bool timeOk = (elapsed >= localStep.minTimeMs);
-    bool meatOk = (!localStep.useMeatTemp) || (meat >= localStep.tMeatTarget);
+    bool meatOk = (!localStep.useMeatTemp) ||
+                  meatTargetReached(localStep.meatRule, localStep.tMeatTarget, meatProbes, meatMask,
+                                    millis());
 
     if (timeOk && meatOk) {
+        if (localStep.useMeatTemp) {
+            LOG_FMT(LOG_LEVEL_INFO, "Meat target %.1f C reached (rule: %s)",
+                    localStep.tMeatTarget, meatRuleName(localStep.meatRule));
+        }
         // [FIX] g_currentStep++ chroniony mutexem
         if (!state_lock()) return;
         g_currentStep++;
@@ -369,11 +436,106 @@ static void handleAutoMode() {
     state_unlock();
 
     if (step >= 0 && step < count) {
-        if (output_lock()) {
-            ledcWrite(PIN_SMOKE_FAN, smokePwm);
-            output_unlock();
+        setSmokePwm(smokePwm);
+    }
+}
+
+// ======================================================
+// [NEW] PLATEAU MIĘSA (STALL)
+// ======================================================
+
+const char* stallActionName(StallAction action) {
+    switch (action) {
+        case StallAction::RAISE:  return "raise";
+        case StallAction::NOTIFY: return "notify";
+        case StallAction::WRAP:   return "wrap";
+        default:                  return "none";
+    }
+}
+
+/**
+ * checkMeatStall()
+ *
+ * Plateau parowania: komora trzyma setpoint, a mięso (powyżej STALL_MEAT_MIN,
+ * poniżej celu kroku) rośnie wolniej niż STALL_MAX_SLOPE przez całe okno
+ * STALL_WINDOW_SAMPLES * STALL_SAMPLE_MS. Tylko w krokach z warunkiem mięsa
+ * i ustawioną reakcją. Przerwanie warunków (drzwi, komora poza setpointem)
+ * zaczyna okno od nowa; po każdej decyzji też – kolejna najwcześniej po oknie.
+ */
+static void checkMeatStall() {
+    unsigned long now = millis();
+    if (stall.lastSampleMs != 0 && now - stall.lastSampleMs < STALL_SAMPLE_MS) return;
+    stall.lastSampleMs = now;
+
+    TempEstimate meatEst = estimator_get(EST_MEAT);
+    if (!state_lock()) return;
+    int step = g_currentStep;
+    int count = g_stepCount;
+    if (step < 0 || step >= count) {
+        state_unlock();
+        return;
+    }
+    StallAction action = g_profile[step].stallAction;
+    bool useMeat = g_profile[step].useMeatTemp;
+    double target = g_profile[step].tMeatTarget;
+    double tSet = g_tSet;
+    double tc = g_tChamber;
+    double tm = meatEst.valid ? meatEst.temp : g_tMeat;
+    bool door = g_doorOpen;
+    state_unlock();
+
+    if (action == StallAction::NONE || !useMeat) return;
+    if (door || fabs(tSet - tc) > STALL_CHAMBER_BAND || tm < STALL_MEAT_MIN || tm >= target) {
+        stall.count = 0;
+        return;
+    }
+
+    stall.samples[stall.head] = tm;
+    stall.head = (stall.head + 1) % (STALL_WINDOW_SAMPLES + 1);
+    if (stall.count < STALL_WINDOW_SAMPLES + 1) stall.count++;
+    if (stall.count < STALL_WINDOW_SAMPLES + 1) return;
+
+    // Najstarsza próbka = na pozycji head (bufor pełny)
+    double oldest = stall.samples[stall.head];
+    double windowH = STALL_WINDOW_SAMPLES * (STALL_SAMPLE_MS / 3600000.0);
+    double slope = (tm - oldest) / windowH;
+    if (slope > STALL_MAX_SLOPE) return;
+    stall.count = 0;
+
+    LOG_FMT(LOG_LEVEL_WARN, "Meat stall: %.1f C, slope %.2f C/h over %lu min (chamber %.1f/%.1f C) -> %s",
+            tm, slope, (unsigned long)(windowH * 60.0), tc, tSet, stallActionName(action));
+
+    if (action == StallAction::RAISE) {
+        double newSet = min(tSet + STALL_RAISE_STEP, (double)CFG_T_MAX_SET);
+        if (stall.raised + STALL_RAISE_STEP <= STALL_RAISE_MAX && newSet > tSet) {
+            stall.raised += newSet - tSet;
+            if (state_lock()) {
+                g_tSet = newSet;
+                g_stallDetected = true;
+                state_unlock();
+            }
+            LOG_FMT(LOG_LEVEL_INFO, "Stall response: setpoint %.1f -> %.1f C (+%.1f C in step)",
+                    tSet, newSet, stall.raised);
+            buzzerBeep(1, 200, 0);
+            return;
+        }
+        log_msg(LOG_LEVEL_WARN, "Stall response: setpoint raise limit reached - notify only");
+    } else if (action == StallAction::WRAP) {
+        if (step + 1 < count) {
+            log_msg(LOG_LEVEL_INFO, "Stall response: advancing to wrap step");
+            process_force_next_step();
+            return;
         }
+        log_msg(LOG_LEVEL_WARN, "Stall response: no step after current - notify only");
+    }
+
+    bool first = false;
+    if (state_lock()) {
+        first = !g_stallDetected;
+        g_stallDetected = true;
+        state_unlock();
     }
+    if (first) buzzerBeep(3, 300, 200);
 }
 
 // ======================================================
@@ -388,10 +550,7 @@ static void handleManualMode() {
     int smoke = g_manualSmokePwm;
     state_unlock();
 
-    if (output_lock()) {
-        ledcWrite(PIN_SMOKE_FAN, smoke);
-        output_unlock();
-    }
+    setSmokePwm(smoke);
 }
 
 // ======================================================
@@ -421,6 +580,14 @@ void applyCurrentStep() {
         g_stepStartTime = millis();
         state_unlock();
     }
+    meatReachedMask = 0;
+    meatLostMask = 0;
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) meatSeenMs[i] = millis();
+    resetStallMonitor();
+    if (state_lock()) {
+        g_stallDetected = false;
+        state_unlock();
+    }
 
     LOG_FMT(LOG_LEVEL_INFO, "Step %d applied", step);
     ui_force_redraw();
@@ -438,6 +605,7 @@ void process_start_auto() {
     }
     applyCurrentStep();
     initHeaterEnable();
+    meateta_reset();
 
     if (state_lock()) {
         g_processStartTime = millis();
@@ -449,13 +617,28 @@ void process_start_auto() {
         g_processStats.pauseCount = 0;
         g_processStats.avgTemp = 0.0;
         g_processStats.lastUpdate = millis();
-        adaptivePid.currentKp = CFG_Kp;
-        adaptivePid.currentKi = CFG_Ki;
-        adaptivePid.currentKd = CFG_Kd;
-        pid.SetTunings(CFG_Kp, CFG_Ki, CFG_Kd);
         state_unlock();
     }
 
+    // Nastawy dla pierwszego kroku: harmonogram, autotune trybu mocy lub CFG_K*
+    double tSet = 0.0;
+    int pm = CFG_POWERMODE_MIN;
+    if (state_lock()) {
+        tSet = g_tSet;
+        pm = g_powerMode;
+        state_unlock();
+    }
+    PidGains pg;
+    bool scheduled = gainsched_lookup(tSet, pm, &pg);
+    pid.SetTunings(pg.kp, pg.ki, pg.kd);
+    adaptivePid.currentKp = pg.kp;
+    adaptivePid.currentKi = pg.ki;
+    adaptivePid.currentKd = pg.kd;
+    adaptivePid.scheduled = scheduled;
+    adaptivePid.applied = true;
+    LOG_FMT(LOG_LEVEL_INFO, "PID gains (power mode %d, %s): Kp=%.2f Ki=%.4f Kd=%.1f",
+            pm, scheduled ? "schedule" : (pg.tuned ? "autotune" : "default"), pg.kp, pg.ki, pg.kd);
+
     // [NEW] Reset monitora awarii grzałki przy starcie
     resetHeaterFaultMonitor();
 
@@ -471,11 +654,13 @@ void process_start_manual() {
         state_unlock();
     }
     initHeaterEnable();
+    meateta_reset();
 
     if (state_lock()) {
         g_processStartTime = millis();
         g_currentState = ProcessState::RUNNING_MANUAL;
         g_lastRunMode = RunMode::MODE_MANUAL;
+        adaptivePid.applied = false;
         g_processStats.totalRunTime = 0;
         g_processStats.activeHeatingTime = 0;
         g_processStats.stepChanges = 0;
@@ -504,20 +689,369 @@ void process_resume() {
     log_msg(LOG_LEVEL_INFO, "Process resuming...");
 }
 
+// ======================================================
+// AUTOTUNE PID – OSCYLACJA PRZEKAŹNIKOWA (Åström–Hägglund)
+// ======================================================
+//
+// Wyjście przełączane między AT_RELAY_HIGH a AT_RELAY_LOW wokół setpointu
+// (z histerezą ε) wymusza cykl graniczny o okresie Pu i amplitudzie a.
+// Wzmocnienie krytyczne Ku = 4d / (π·√(a² − ε²)), d = połowa skoku przekaźnika.
+// Nastawy wg Tyreusa–Luybena (mniejsze przeregulowanie niż Ziegler–Nichols,
+// odpowiednie dla wolnej komory z dużym opóźnieniem):
+//   Kp = Ku / 2.2,  Ti = 2.2·Pu,  Td = Pu / 6.3
+// Wynik zależy od liczby grzałek, dlatego zapisywany osobno dla trybu mocy
+// (i w harmonogramie nastaw przy setpoincie testu).
+
+enum class AutotuneStatus : uint8_t { NONE, RUNNING, DONE, FAILED };
+
+struct AutotuneRun {
+    AutotuneStatus status;
+    double setpoint;
+    int powerMode;
+    bool relayHigh;
+    unsigned long startMs;
+    unsigned long lastRiseMs;       // przełączenie HIGH→LOW (przecięcie w górę), 0 = brak
+    double peakMax, peakMin;        // ekstrema od ostatniego przecięcia w górę
+    int cycles;                     // pełne cykle (z odrzuconymi)
+    int n;                          // cykle zapisane do uśredniania
+    double amp[AT_MAX_CYCLES];
+    double periodSec[AT_MAX_CYCLES];
+    double ku, pu;
+    PidGains result;
+    char message[48];
+};
+
+static AutotuneRun at = {};
+
+static const char* autotuneStatusName(AutotuneStatus s) {
+    switch (s) {
+        case AutotuneStatus::RUNNING: return "running";
+        case AutotuneStatus::DONE:    return "done";
+        case AutotuneStatus::FAILED:  return "failed";
+        default:                      return "none";
+    }
+}
+
+// Względny rozrzut ostatnich k wartości (max-min)/średnia
+static double relativeSpread(const double* v, int last, int k, double* mean) {
+    double lo = v[last], hi = v[last], sum = 0.0;
+    for (int i = last - k + 1; i <= last; i++) {
+        lo = min(lo, v[i]);
+        hi = max(hi, v[i]);
+        sum += v[i];
+    }
+    *mean = sum / k;
+    return (*mean > 0.0) ? (hi - lo) / *mean : 1.0;
+}
+
+static void autotuneFinish(bool ok, const char* msg) {
+    strncpy(at.message, msg, sizeof(at.message) - 1);
+    at.message[sizeof(at.message) - 1] = '\0';
+    at.status = ok ? AutotuneStatus::DONE : AutotuneStatus::FAILED;
+    pidOutput = 0.0;
+    allOutputsOff();
+
+    if (state_lock()) {
+        if (g_currentState == ProcessState::AUTOTUNE) {
+            g_currentState = ProcessState::IDLE;
+        }
+        if (ok) g_pidGains[at.powerMode - 1] = at.result;
+        state_unlock();
+    }
+
+    if (ok) {
+        storage_save_pid_gains_nvs(at.powerMode);
+        // Wynik trafia też do harmonogramu – punkt węzłowy najbliższy setpointowi testu
+        gainsched_setPoint(at.powerMode, gainsched_nearestBand(at.setpoint),
+                           at.result.kp, at.result.ki, at.result.kd);
+        adaptivePid.applied = false;
+        LOG_FMT(LOG_LEVEL_INFO, "Autotune done (power mode %d): Ku=%.2f Pu=%.0fs -> Kp=%.2f Ki=%.4f Kd=%.1f",
+                at.powerMode, at.ku, at.pu, at.result.kp, at.result.ki, at.result.kd);
+        buzzerBeep(2, 200, 100);
+    } else {
+        LOG_FMT(LOG_LEVEL_WARN, "Autotune failed: %s", at.message);
+        buzzerBeep(3, 150, 150);
+    }
+    ui_force_redraw();
+}
+
+// Po każdym pełnym cyklu: czy ostatnie AT_CYCLES są zgodne → nastawy
+static void autotuneEvaluate() {
+    if (at.n < AT_CYCLES) return;
+    double a, pu;
+    double spreadA = relativeSpread(at.amp, at.n - 1, AT_CYCLES, &a);
+    double spreadP = relativeSpread(at.periodSec, at.n - 1, AT_CYCLES, &pu);
+    if (spreadA > AT_CONSISTENCY || spreadP > AT_CONSISTENCY) return;
+
+    if (a <= AT_HYSTERESIS) {
+        autotuneFinish(false, "amplituda ponizej histerezy");
+        return;
+    }
+    double d = (AT_RELAY_HIGH - AT_RELAY_LOW) / 2.0;
+    at.ku = 4.0 * d / (PI * sqrt(a * a - AT_HYSTERESIS * AT_HYSTERESIS));
+    at.pu = pu;
+
+    double kp = at.ku / 2.2;
+    double ti = 2.2 * pu;
+    double td = pu / 6.3;
+    at.result = {kp, kp / ti, kp * td, true};
+
+    char msg[48];
+    snprintf(msg, sizeof(msg), "a=%.2fC Pu=%.0fs", a, pu);
+    autotuneFinish(true, msg);
+}
+
+static void handleAutotune() {
+    if (!state_lock()) return;
+    bool door = g_doorOpen;
+    bool sensorLost = g_errorSensor || g_chamberVirtual;
+    state_unlock();
+
+    unsigned long now = millis();
+    if (door) { autotuneFinish(false, "otwarte drzwi"); return; }
+    if (sensorLost) { autotuneFinish(false, "blad czujnika komory"); return; }
+    if (now - at.startMs > AT_TIMEOUT_MS) { autotuneFinish(false, "przekroczony czas"); return; }
+
+    double t = pidInput;
+    at.peakMax = max(at.peakMax, t);
+    at.peakMin = min(at.peakMin, t);
+
+    if (at.relayHigh && t > at.setpoint + AT_HYSTERESIS) {
+        at.relayHigh = false;
+        if (at.lastRiseMs == 0) {
+            // Pierwsze dojście do setpointu – początek pomiaru
+            at.lastRiseMs = now;
+            at.peakMax = at.peakMin = t;
+        } else if (now - at.lastRiseMs >= AT_MIN_PERIOD_MS) {
+            at.cycles++;
+            if (at.cycles > AT_DISCARD_CYCLES && at.n < AT_MAX_CYCLES) {
+                at.amp[at.n] = (at.peakMax - at.peakMin) / 2.0;
+                at.periodSec[at.n] = (now - at.lastRiseMs) / 1000.0;
+                LOG_FMT(LOG_LEVEL_INFO, "Autotune cycle %d: a=%.2f C, P=%.0f s",
+                        at.n + 1, at.amp[at.n], at.periodSec[at.n]);
+                at.n++;
+            }
+            at.lastRiseMs = now;
+            at.peakMax = at.peakMin = t;
+            autotuneEvaluate();
+            if (at.status != AutotuneStatus::RUNNING) return;
+            if (at.cycles >= AT_MAX_CYCLES) {
+                autotuneFinish(false, "brak zbieznosci oscylacji");
+                return;
+            }
+        }
+        // krótszy okres = szum na progu; ekstrema zbierane dalej
+    } else if (!at.relayHigh && t < at.setpoint - AT_HYSTERESIS) {
+        at.relayHigh = true;
+    }
+
+    pidFeedforward = 0.0;
+    pidOutput = at.relayHigh ? AT_RELAY_HIGH : AT_RELAY_LOW;
+    applySoftEnable();
+    mapPowerToHeaters();
+    handleFanLogic();
+}
+
+bool process_start_autotune(double setpoint, int powerMode) {
+    if (setpoint < CFG_T_MIN_SET || setpoint > CFG_T_MAX_SET ||
+        powerMode < CFG_POWERMODE_MIN || powerMode > CFG_POWERMODE_MAX) {
+        return false;
+    }
+    if (!state_lock()) return false;
+    if (g_currentState != ProcessState::IDLE || g_doorOpen || g_errorSensor) {
+        state_unlock();
+        log_msg(LOG_LEVEL_WARN, "Autotune rejected - process not idle");
+        return false;
+    }
+    g_tSet = setpoint;
+    g_powerMode = powerMode;
+    g_manualSmokePwm = 0;
+    g_fanMode = 1;
+    g_processStartTime = millis();
+    state_unlock();
+
+    at = {};
+    at.status = AutotuneStatus::RUNNING;
+    at.setpoint = setpoint;
+    at.powerMode = powerMode;
+    at.relayHigh = true;
+    at.startMs = millis();
+    at.peakMax = -1000.0;
+    at.peakMin = 1000.0;
+    strncpy(at.message, "dojscie do setpointu", sizeof(at.message) - 1);
+
+    initHeaterEnable();
+    if (state_lock()) {
+        g_currentState = ProcessState::AUTOTUNE;
+        state_unlock();
+    }
+    setSmokePwm(0);
+
+    LOG_FMT(LOG_LEVEL_INFO, "Autotune started: setpoint %.1f C, power mode %d", setpoint, powerMode);
+    ui_force_redraw();
+    return true;
+}
+
+// Wywoływane z taska WWW – przebieg zamyka pętla sterowania w następnym cyklu
+void process_cancel_autotune() {
+    if (!state_lock()) return;
+    if (g_currentState == ProcessState::AUTOTUNE) {
+        g_currentState = ProcessState::IDLE;
+    }
+    state_unlock();
+}
+
+String process_getAutotuneJSON() {
+    PidGains gains[CFG_POWERMODE_MAX];
+    if (state_lock()) {
+        memcpy(gains, g_pidGains, sizeof(gains));
+        state_unlock();
+    } else {
+        memset(gains, 0, sizeof(gains));
+    }
+
+    char buf[640];
+    int n = snprintf(buf, sizeof(buf),
+        "{\"status\":\"%s\",\"message\":\"%s\",\"setpoint\":%.1f,\"powerMode\":%d,"
+        "\"relay\":%d,\"cycles\":%d,\"elapsedSec\":%lu,\"ku\":%.3f,\"pu\":%.1f,\"gains\":[",
+        autotuneStatusName(at.status), at.message, at.setpoint, at.powerMode,
+        at.relayHigh ? 1 : 0, at.n,
+        at.status == AutotuneStatus::RUNNING ? (millis() - at.startMs) / 1000UL : 0UL,
+        at.ku, at.pu);
+    for (int i = 0; i < CFG_POWERMODE_MAX && n > 0 && n < (int)sizeof(buf); i++) {
+        n += snprintf(buf + n, sizeof(buf) - n,
+            "%s{\"powerMode\":%d,\"kp\":%.3f,\"ki\":%.5f,\"kd\":%.2f,\"tuned\":%s}",
+            i ? "," : "", i + 1, gains[i].kp, gains[i].ki, gains[i].kd,
+            gains[i].tuned ? "true" : "false");
+    }
+    if (n > 0 && n < (int)sizeof(buf)) snprintf(buf + n, sizeof(buf) - n, "]}");
+    return String(buf);
+}
+
 // ======================================================
 // GŁÓWNA LOGIKA STEROWANIA (wywoływana co 100 ms z taskControl)
 // ======================================================
 
+// Wypełnienie zamrożone przy otwarciu drzwi – przywracane w pierwszym obiegu SOFT_RESUME
+static bool pidRestorePending = false;
+static double pidRestoreDuty = 0.0;
+static double pidDoorBoost = 0.0;          // dodatek doorrec z poprzedniego obiegu
+
+// Wyjście = PID + feedforward strat. PID liczy tylko korektę: limity
+// przesunięte o udział ff, więc całka nie nabija się ponad 0..100% sumy.
+// Włączenie/wyłączenie ff bez skoku – suma całki przestawiana o ff.
+// Dodatek powrotu po drzwiach (doorrec) wchodzi tą samą drogą co ff, obcięty
+// do zapasu nad całką (inaczej limity przesunięte o dodatek ścinają całkę),
+// a przy jego końcu wyjście przechodzi w całość do całki.
+// Górny limit PID = sufit z budżetu mocy (powerbudget) – bez nabijania całki.
+// Silnik MPC (model nauczony) zastępuje pid.Compute(); model zawiera straty,
+// więc bez ff. PID stoi wtedy w MANUAL i śledzi wyjście – powrót bez skoku.
+static void computeOutput(double chamberRate, ControlEngine engine) {
+    unsigned long now = millis();
+    double ff = feedforward_update(now, chamberRate);
+    double mpcDuty = (engine == ControlEngine::MPC) ? mpc_getDuty() : NAN;
+    if (!isnan(mpcDuty)) {
+        if (pid.GetMode() == AUTOMATIC) {
+            pid.SetMode(MANUAL);
+            log_msg(LOG_LEVEL_INFO, "Control engine: MPC");
+        }
+        pidRestorePending = false;
+        pidDoorBoost = 0.0;
+        pidFeedforward = 0.0;
+        pidFeedback = mpcDuty;
+        pidOutput = mpcDuty;
+        return;
+    }
+
+    // Sufit z budżetu mocy przyłącza – całka nie nabija się ponad moc dostępną
+    double cap = max(1.0, powerbudget_heaterCapPct());
+    if (pidRestorePending) {
+        // Wypełnienie sprzed otwarcia drzwi minus bieżący ff do całki; Initialize()
+        // ustawia też ostatni pomiar na bieżący – bez kopnięcia pochodnej
+        pidFeedback = constrain(pidRestoreDuty - ff, -ff, cap - ff);
+        pid.SetOutputLimits(-ff, cap - ff);
+        pid.SetMode(MANUAL);
+        pid.SetMode(AUTOMATIC);
+        adaptivePid.lastError = 0.0;
+        pidRestorePending = false;
+    }
+    double boost = min(doorrec_boost(now), max(0.0, cap - ff - pidFeedback));
+    bool boostEnded = (boost <= 0.0 && pidDoorBoost > 0.0);
+    pidDoorBoost = boost;
+    ff = min(ff + boost, 100.0);
+    pid.SetOutputLimits(-ff, cap - ff);
+    if (pid.GetMode() == MANUAL) {
+        pidFeedback = pidOutput - ff;
+        pid.SetMode(AUTOMATIC);
+        log_msg(LOG_LEVEL_INFO, "Control engine: PID");
+    } else if ((ff > 0.0) != (pidFeedforward > 0.0) || boostEnded) {
+        pidFeedback = pidOutput - ff;
+        pid.SetMode(MANUAL);
+        pid.SetMode(AUTOMATIC);
+    }
+    pidFeedforward = ff;
+    adaptPidParameters();
+    if (pid.Compute()) {
+        adaptivePid.lastError = pidSetpoint - pidInput;
+    }
+    pidOutput = constrain(pidFeedback + ff, 0.0, 100.0);
+    doorrec_track(pidOutput);
+}
+
 void process_run_control_logic() {
     extern double pidInput, pidSetpoint;
 
+    // Wejście PID z estymatora – surowy odczyt (krok 0.0625 C) przez Kd
+    // przenosił szum kwantyzacji prosto na wypełnienie SSR. COMPENSATED dodaje
+    // korektę opóźnienia sondy (mniejsze przeregulowanie po zamknięciu drzwi).
+    TempEstimate chamberEst = estimator_get(EST_CHAMBER);
+    double chamberComp = lagcomp_apply(EST_CHAMBER, chamberEst);
+    double chamberRate = chamberEst.valid ? chamberEst.rate : NAN;
+
     if (!state_lock()) return;
     ProcessState st = g_currentState;
-    pidInput = g_tChamber;
-    pidSetpoint = g_tSet;
+    // Sonda komory utracona: wejście z modelu (estymator stoi na ostatnim
+    // pomiarze), setpoint obniżony do interwencji operatora
+    PidInputSource src = g_chamberVirtual ? PidInputSource::RAW : g_pidInputSource;
+    switch (src) {
+        case PidInputSource::RAW:
+            pidInput = g_tChamber;
+            break;
+        case PidInputSource::COMPENSATED:
+            pidInput = chamberEst.valid ? chamberComp : g_tChamber;
+            break;
+        default:
+            pidInput = chamberEst.valid ? chamberEst.temp : g_tChamber;
+            break;
+    }
+    pidSetpoint = vchamber_limitSetpoint(g_tSet);
     unsigned long processStart = g_processStartTime;
+    ControlEngine engine = g_controlEngine;
+    int powerMode = g_powerMode;
     state_unlock();
 
+    // Drzwi: zamrożenie stanu regulatora przy otwarciu, plan powrotu przy zamknięciu
+    static ProcessState prevState = ProcessState::IDLE;
+    unsigned long now = millis();
+    if (st == ProcessState::PAUSE_DOOR && prevState != ProcessState::PAUSE_DOOR) {
+        doorrec_freeze(now, pidInput);
+    } else if (st == ProcessState::SOFT_RESUME && prevState == ProcessState::PAUSE_DOOR) {
+        pidRestorePending = doorrec_begin(now, pidInput, powerMode, &pidRestoreDuty);
+    }
+    prevState = st;
+    if (st == ProcessState::RUNNING_AUTO || st == ProcessState::RUNNING_MANUAL ||
+        st == ProcessState::SOFT_RESUME) {
+        doorrec_observe(now, pidSetpoint - pidInput);
+    }
+
+    // Identyfikacja FOPDT i krok MPC (też w cieniu pod PID i w pauzach)
+    mpc_update(millis(), st);
+
+    // Autotune przerwany z zewnątrz (stop, przegrzanie) – zamknij przebieg
+    if (at.status == AutotuneStatus::RUNNING && st != ProcessState::AUTOTUNE) {
+        autotuneFinish(false, "przerwany");
+    }
+
     // Sprawdzenie maksymalnego czasu procesu
     if ((st == ProcessState::RUNNING_AUTO || st == ProcessState::RUNNING_MANUAL) &&
         (millis() - processStart > CFG_MAX_PROCESS_TIME_MS)) {
@@ -533,26 +1067,28 @@ void process_run_control_logic() {
 
     switch (st) {
         case ProcessState::RUNNING_AUTO:
-            adaptPidParameters();
-            pid.Compute();
+            computeOutput(chamberRate, engine);
             applySoftEnable();
             mapPowerToHeaters();
             handleAutoMode();
+            checkMeatStall();
+            meateta_update(millis());
             updateProcessStats();
             checkHeaterEfficiency();   // [NEW]
             break;
 
         case ProcessState::RUNNING_MANUAL:
-            pid.Compute();
+            computeOutput(chamberRate, engine);
             applySoftEnable();
             mapPowerToHeaters();
             handleManualMode();
+            meateta_update(millis());
             updateProcessStats();
             checkHeaterEfficiency();   // [NEW]
             break;
 
         case ProcessState::SOFT_RESUME:
-            pid.Compute();
+            computeOutput(chamberRate, engine);
             applySoftEnable();
             mapPowerToHeaters();
 
@@ -567,6 +1103,10 @@ void process_run_control_logic() {
             }
             break;
 
+        case ProcessState::AUTOTUNE:
+            handleAutotune();
+            break;
+
         case ProcessState::IDLE:
         case ProcessState::PAUSE_DOOR:
         case ProcessState::PAUSE_SENSOR:
@@ -574,6 +1114,7 @@ void process_run_control_logic() {
         case ProcessState::PAUSE_USER:
         case ProcessState::PAUSE_HEATER_FAULT:   // [NEW]
         case ProcessState::ERROR_PROFILE:
+            pidFeedforward = 0.0;
             allOutputsOff();
             break;
     }
@@ -614,23 +1155,14 @@ void process_force_next_step() {
 String getPidParameters() {
     char buffer[128];
     snprintf(buffer, sizeof(buffer),
-             "Kp=%.2f, Ki=%.2f, Kd=%.2f (base: %.1f,%.1f,%.1f)",
+             "Kp=%.2f, Ki=%.4f, Kd=%.1f (%s)",
              adaptivePid.currentKp, adaptivePid.currentKi, adaptivePid.currentKd,
-             CFG_Kp, CFG_Ki, CFG_Kd);
+             adaptivePid.scheduled ? "schedule" : "default/autotune");
     return String(buffer);
 }
 
+// Następny obieg sterowania ustawi nastawy z harmonogramu od nowa
 void resetAdaptivePid() {
-    adaptivePid.currentKp = CFG_Kp;
-    adaptivePid.currentKi = CFG_Ki;
-    adaptivePid.currentKd = CFG_Kd;
-    pid.SetTunings(CFG_Kp, CFG_Ki, CFG_Kd);
-
-    for (int i = 0; i < 10; i++) {
-        adaptivePid.errorHistory[i] = 0;
-    }
-    adaptivePid.historyIndex = 0;
-    adaptivePid.lastAdaptation = 0;
-
-    log_msg(LOG_LEVEL_INFO, "Adaptive PID reset to defaults");
+    adaptivePid.applied = false;
+    log_msg(LOG_LEVEL_INFO, "PID gains will be reloaded from schedule");
 }
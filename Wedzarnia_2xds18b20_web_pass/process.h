@@ -1,6 +1,7 @@
 // process.h - Zmodernizowana wersja
 #pragma once
 #include <Arduino.h>
+#include "config.h"
 
 // Główne funkcje procesu
 void process_run_control_logic();
@@ -11,11 +12,19 @@ void applyCurrentStep();
 
 // Funkcje kontrolne
 void process_force_next_step();
+const char* meatRuleName(MeatRule rule);   // "min" / "mean" / "all"
+const char* stallActionName(StallAction action);   // "none" / "raise" / "notify" / "wrap"
 
 // Nowe funkcje dla adaptacyjnego PID
 String getPidParameters();
 void resetAdaptivePid();
 
+// Autotune PID (oscylacja przekaźnikowa) – tylko ze stanu IDLE.
+// Wynik zapisywany w NVS dla trybu mocy, używany przez process_start_auto()
+bool process_start_autotune(double setpoint, int powerMode);
+void process_cancel_autotune();
+String process_getAutotuneJSON();
+
 // [NEW] Reset stanu zabezpieczenia awarii grzałki
 // Wywoływane przy process_start_auto(), process_start_manual() i process_resume()
 void resetHeaterFaultMonitor();
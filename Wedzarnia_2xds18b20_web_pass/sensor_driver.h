@@ -0,0 +1,73 @@
+// sensor_driver.h - Wspólny interfejs sterowników czujników temperatury
+// Każdy backend (DS18B20 na OneWire, termopary na SPI) sam planuje swoje
+// konwersje i oddaje odczyty do rdzenia (sensors.cpp), który trzyma
+// zunifikowaną tablicę kanałów i przypisanie ról komora/mięso.
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Role przypisywane do dowolnego kanału. Komora może mieć sondy zapasowe
+// (CHAMBER2/3) – wartość komory to wynik głosowania wszystkich sond komory.
+// Mięso: sonda główna (MEAT) + dodatkowe MEAT2..MEAT8, każda raportowana osobno.
+// AMBIENT: opcjonalna sonda na zewnątrz komory (feedforward strat ciepła).
+enum ProbeRole {
+    PROBE_CHAMBER = 0,
+    PROBE_MEAT = 1,
+    PROBE_CHAMBER2 = 2,
+    PROBE_CHAMBER3 = 3,
+    PROBE_MEAT2 = 4,
+    PROBE_AMBIENT = PROBE_MEAT2 + MEAT_PROBES_MAX - 1,
+    PROBE_COUNT
+};
+
+inline bool isChamberRole(int role) {
+    return role == PROBE_CHAMBER || role == PROBE_CHAMBER2 || role == PROBE_CHAMBER3;
+}
+
+inline bool isMeatRole(int role) {
+    return role == PROBE_MEAT || (role >= PROBE_MEAT2 && role < PROBE_AMBIENT);
+}
+
+// Numer sondy mięsa 0..MEAT_PROBES_MAX-1 (0 = główna) i odwrotnie
+inline int meatProbeNumber(int role) { return role == PROBE_MEAT ? 0 : role - PROBE_MEAT2 + 1; }
+inline int meatProbeRole(int n) { return n == 0 ? PROBE_MEAT : PROBE_MEAT2 + n - 1; }
+
+// Nazwa roli w API (/api/sensors/cal?role=...)
+inline const char* probeRoleKey(int role) {
+    static const char* const keys[PROBE_COUNT] = {"chamber", "meat", "chamber2", "chamber3", "meat2",
+                                                  "meat3", "meat4", "meat5", "meat6", "meat7", "meat8",
+                                                  "ambient"};
+    return (role >= 0 && role < PROBE_COUNT) ? keys[role] : "";
+}
+
+// Przyczyna nieudanego odczytu – osobne liczniki pozwalają odróżnić
+// degradujący się kabel (CRC) od zaników zasilania czujnika (85 C) i odłączenia.
+enum class ReadFault { NONE, DISCONNECTED, CRC, POWER_ON_RESET, RANGE };
+
+// Pozycja w tablicy kanałów. id: DS18B20 = adres ROM; termopara = 0xF1/0xF2,
+// pin CS, zera i CRC8 – ten sam format 8 bajtów dla wszystkich backendów.
+struct SensorChannel {
+    uint8_t id[8];
+    SensorBackend backend;
+    uint8_t slot;                  // indeks kanału wewnątrz sterownika
+};
+
+class TempSensorDriver {
+public:
+    virtual ~TempSensorDriver() {}
+    virtual const char* name() const = 0;
+    // Wykrycie kanałów (start, ponowny skan); zwraca ich liczbę
+    virtual int discover() = 0;
+    // Aktualna liczba kanałów – może się zmienić bez discover() (skan w tle)
+    virtual int size() const = 0;
+    virtual void channelInfo(int slot, SensorChannel& ch) const = 0;
+    // Nieblokujący krok harmonogramu konwersji – co obieg tasku czujników
+    virtual void service(unsigned long now) = 0;
+    // Krok kwantyzacji odczytu [C] – dla estymatora
+    virtual double quantStep(int slot) const = 0;
+};
+
+// Usługi rdzenia dla sterowników
+int sensorRoleSlot(int role, const TempSensorDriver* drv);   // -1 = rola nie na tym sterowniku
+void sensorDeliverReading(int role, double t, ReadFault fault, unsigned long now);
+const char* sensorBackendName(SensorBackend backend);
@@ -3,6 +3,13 @@
 #include "config.h"
 #include "state.h"
 #include "outputs.h"
+#include "onewire_rmt.h"
+#include "estimator.h"
+#include "sensor_driver.h"
+#include "thermocouple.h"
+#include "calibration.h"
+#include "lagcomp.h"
+#include "vchamber.h"
 #include <nvs_flash.h>
 #include <nvs.h>
 
@@ -13,65 +20,501 @@ struct CachedReading {
     int readAttempts;
 };
 
-static unsigned long lastTempRequest = 0;
-static unsigned long lastTempReadPossible = 0;
 static CachedReading cachedChamber = {25.0, 0, false, 0};
 static CachedReading cachedMeat = {25.0, 0, false, 0};
 static int sensorErrorCount = 0;
 
-uint8_t sensorAddresses[2][8];
+// Tablica adresów ROM – wypełniana raz przy starcie i przy ponownym skanowaniu.
+// Odczyt idzie bezpośrednio po adresie (getTempC), bez przeszukiwania magistrali
+// w każdym cyklu (getTempCByIndex robił pełny search() aż do indeksu czujnika).
+uint8_t sensorAddresses[MAX_SENSORS][8];
+static uint8_t sensorBus[MAX_SENSORS];          // magistrala, na której jest czujnik
+static int sensorTableCount = 0;
+
+// Liczniki transakcji per magistrala (diagnostyka kosztu i czasu cyklu odczytu)
+struct BusStats {
+    unsigned long searches;          // kroki search() – tylko start/rescan
+    unsigned long transactions;      // reset + komenda (konwersja, odczyt scratchpada)
+    unsigned long cycles;            // zakończone cykle odczytu (konwersja → wartość)
+    unsigned long cycleTransactions; // transakcje w bieżącym cyklu
+    unsigned long lastCycleTransactions;
+    unsigned long lastCycleMs;       // start konwersji → odczytany scratchpad
+    unsigned long maxCycleMs;
+    unsigned long cycleWireUs;       // zajętość linii w bieżącym cyklu (RMT)
+    unsigned long lastCycleWireUs;
+};
+
+static BusStats busStats[ONEWIRE_BUS_COUNT] = {};
+
+// Analizator magistrali: liczniki błędów i histogramy przebiegu linii per
+// magistrala i per czujnik (po adresie ROM – przetrwa przebudowę tablicy).
+// Zły kabel = błędy / wolne narastanie na wszystkich sondach magistrali,
+// zła sonda = błędy jednej sondy przy zdrowych pozostałych.
+static constexpr int BUS_HIST_BINS = 6;
+static const uint16_t presenceWidthEdges[BUS_HIST_BINS - 1] = {60, 100, 140, 180, 240};
+static const uint16_t riseEdges[BUS_HIST_BINS - 1] = {4, 6, 8, 10, 13};
+
+struct LineDiag {
+    unsigned long transactions;
+    unsigned long presenceFailures;  // brak presence po resecie
+    unsigned long timeouts;          // transakcja bez końca (RMT)
+    unsigned long crcErrors;
+    unsigned long noData;            // scratchpad 00/FF – linia zwarta lub pusta
+    unsigned long retries;           // ponowny odczyt po 85.0
+    uint32_t presenceHist[BUS_HIST_BINS];
+    uint32_t riseHist[BUS_HIST_BINS];
+    uint16_t presenceGapMin, presenceGapMax;
+    uint16_t riseMax;
+    uint16_t zeroLowMin;
+};
+
+struct DeviceDiag {
+    uint8_t rom[8];
+    bool used;
+    LineDiag line;
+};
+
+struct BusAnalyzer {
+    volatile bool enabled;
+    volatile bool resetRequested;    // zerowanie wykonuje task czujników
+    unsigned long sinceMs;
+    LineDiag bus[ONEWIRE_BUS_COUNT];
+    DeviceDiag devices[MAX_SENSORS];
+};
+
+static BusAnalyzer analyzer = {CFG_BUS_ANALYZER, false};
+
+// Skan w tle (hot-plug): search() rozłożony na obiegi tasku – jedno urządzenie
+// na obieg i tylko gdy żaden czujnik nie ma konwersji/odczytu w ciągu
+// SENSOR_SCAN_QUIET_MS. Wynik trafia do tablicy ROM dopiero po pełnym przejściu.
+struct BackgroundScan {
+    bool active;
+    bool applyPending;             // wynik czeka, aż żadna magistrala nie ma transakcji
+    volatile bool forced;          // requestSensorRescan() – bez czekania na interwał
+    int bus;                       // magistrala aktualnie przeszukiwana
+    int found;
+    unsigned long nextScanMs;
+    unsigned long completed;
+    uint8_t roms[MAX_SENSORS][8];
+    uint8_t romBus[MAX_SENSORS];
+};
+
+static BackgroundScan bgScan = {};
+static uint8_t sensorMissCount[MAX_SENSORS];   // kolejne skany bez danego ROM-u
+
+// Sterownik RMT (CFG_ONEWIRE_USE_RMT) – transakcje odpytywane co obieg tasku,
+// bez blokowania na slotach bitów. Każda magistrala ma własny kanał RMT i własną
+// transakcję w toku, więc konwersje i odczyty na różnych pinach idą równolegle,
+// a zwarcie/zły kabel jednej sondy nie blokuje pozostałych.
+// Bit-bang (fallback) obsługuje tylko PIN_ONEWIRE.
+enum class RmtJob { NONE, CONFIG, CONVERT, READ };
+
+struct OneWireBus {
+    OneWireRmt rmt;
+    bool active;
+    RmtJob job;
+    int jobRole;
+    int jobIndex;
+};
+
+static const int onewirePins[ONEWIRE_BUS_COUNT] = {PIN_ONEWIRE, PIN_ONEWIRE2};
+static OneWireBus buses[ONEWIRE_BUS_COUNT];
+static bool useRmt = false;
+
+// Harmonogram per czujnik: każdy ma własną konwersję (MATCH ROM + CONVERT T)
+// i czas oczekiwania wynikający z jego aktualnej rozdzielczości.
+
+struct ProbeSchedule {
+    unsigned long lastConvertMs;   // start ostatniej konwersji
+    unsigned long readyAtMs;       // 0 = brak konwersji w toku
+    bool retried;                  // ponowny odczyt po 85.0
+};
+
+static ProbeSchedule probes[PROBE_COUNT] = {};
+
+// Rozdzielczość wg indeksu w tablicy ROM; 0 = nieznana (wymusza zapis konfiguracji)
+static uint8_t sensorResolution[MAX_SENSORS];
+static uint8_t sensorTargetRes[MAX_SENSORS];
+static uint8_t sensorAlarmRegs[MAX_SENSORS][2];   // TH/TL – przepisywane razem z konfiguracją
+
+struct ResolutionPolicy {
+    double refTemp;
+    unsigned long refMs;
+    bool refValid;
+    double rate;                   // °C/s liczone w oknie RES_RATE_WINDOW
+    unsigned long holdSinceMs;     // od kiedy można wrócić do wyższej rozdzielczości
+};
+
+static ResolutionPolicy resPolicy = {0.0, 0, false, 0.0, 0};
+
+// Jakość odczytów per czujnik + bufor mediany do odrzucania pojedynczych szpilek
+struct ProbeQuality {
+    double ring[MEDIAN_WINDOW];
+    int ringCount;
+    int ringHead;
+    unsigned long goodReads;
+    unsigned long crcErrors;
+    unsigned long powerOnResets;
+    unsigned long disconnects;
+    unsigned long rangeErrors;
+    unsigned long spikesRejected;
+    double errorRate;              // średnia krocząca udziału błędnych odczytów
+    bool degraded;
+};
+
+static ProbeQuality quality[PROBE_COUNT] = {};
+
+// Backend DS18B20 – logika OneWire (RMT / bit-bang) pozostaje w tym pliku
+class Ds18b20Driver : public TempSensorDriver {
+public:
+    const char* name() const override { return "DS18B20"; }
+    int discover() override;
+    void channelInfo(int slot, SensorChannel& ch) const override;
+    void service(unsigned long now) override;
+    double quantStep(int slot) const override;
+    int size() const override { return sensorTableCount; }
+};
+
+static Ds18b20Driver dsDriver;
+static ThermocoupleDriver tcDriver;
+static TempSensorDriver* const drivers[] = {&dsDriver, &tcDriver};
+static constexpr int DRIVER_COUNT = sizeof(drivers) / sizeof(drivers[0]);
+
+// Zunifikowana tablica kanałów: najpierw DS18B20 (kolejność ROM), potem termopary.
+// Indeksy ról (chamberSensorIndex/meatSensorIndex) wskazują pozycję w tej tablicy.
+static SensorChannel channels[MAX_CHANNELS];
+static TempSensorDriver* channelDrivers[MAX_CHANNELS];
+static SensorCal channelCal[MAX_CHANNELS];      // kopia z NVS – wczytywana z tablicą kanałów
+static int channelCount = 0;
+static volatile bool calReloadRequested = false;
+static volatile int calClearRole = -1;           // rola do skasowania kalibracji, -1 = brak
+
 bool sensorsIdentified = false;
 int chamberSensorIndex = DEFAULT_CHAMBER_SENSOR;
 int meatSensorIndex = DEFAULT_MEAT_SENSOR;
+static int chamberBackupIndex[CHAMBER_PROBES_MAX - 1] = {-1, -1};
+static int meatExtraIndex[MEAT_PROBES_MAX - 1] = {-1, -1, -1, -1, -1, -1, -1};
+static_assert(MEAT_PROBES_MAX == 8, "meatExtraIndex initializer");
+static_assert(MAX_SENSORS >= PROBE_COUNT, "każda rola musi móc dostać własny DS18B20");
+static int ambientSensorIndex = -1;
+
+// Indeks kanału przypisanego do roli (-1 = brak)
+static int& roleIndex(int role) {
+    if (role == PROBE_CHAMBER) return chamberSensorIndex;
+    if (role == PROBE_MEAT) return meatSensorIndex;
+    if (role == PROBE_AMBIENT) return ambientSensorIndex;
+    if (role >= PROBE_MEAT2) return meatExtraIndex[role - PROBE_MEAT2];
+    return chamberBackupIndex[role - PROBE_CHAMBER2];
+}
+
+static const char* roleName(int role) {
+    static const char* const names[PROBE_COUNT] = {"CHAMBER", "MEAT", "CHAMBER2", "CHAMBER3", "MEAT2",
+                                                   "MEAT3", "MEAT4", "MEAT5", "MEAT6", "MEAT7", "MEAT8",
+                                                   "AMBIENT"};
+    return (role >= 0 && role < PROBE_COUNT) ? names[role] : "?";
+}
+
+// Ostatni odczyt każdej sondy mięsa (po kalibracji i filtrze szpilek);
+// do state publikowany co MEAT_PUBLISH_MS razem z maską przypisanych sond
+struct MeatProbe {
+    double value;
+    unsigned long timestamp;
+    bool valid;
+};
+
+static MeatProbe meatProbes[MEAT_PROBES_MAX] = {};
+static unsigned long meatPublishMs = 0;
+static constexpr unsigned long MEAT_PUBLISH_MS = 1000;
+
+// Sonda otoczenia – publikowana razem z sondami mięsa
+static MeatProbe ambientProbe = {};
+
+// Głosowanie sond komory: ostatni odczyt każdej sondy (po kalibracji i filtrze
+// szpilek) i wynik ostatniego głosowania
+static constexpr int chamberRoles[CHAMBER_PROBES_MAX] = {PROBE_CHAMBER, PROBE_CHAMBER2, PROBE_CHAMBER3};
+
+struct VoteMember {
+    double value;
+    unsigned long timestamp;
+    bool valid;
+    bool outlier;
+    unsigned long outliers;        // głosowania, w których odstawała od mediany
+};
+
+struct ChamberVote {
+    VoteMember members[CHAMBER_PROBES_MAX];
+    int assigned;                  // sondy przypisane do komory
+    int used;                      // sondy w ostatnim głosowaniu
+    bool disagree;                 // 2 sondy bez zgody / sonda odstająca
+    double lastValue;
+    bool lastValid;
+    uint8_t reported;              // maska sond z odczytem od ostatniego głosowania
+    int source;                    // rola sondy, której odczyt wybrano (krok kwantyzacji)
+    unsigned long votes;
+    unsigned long disagreements;
+    unsigned long failovers;       // spadek liczby głosujących sond
+};
+
+static ChamberVote vote = {};
+
+// Przypisanie ról trzymane po identyfikatorze kanału (adres ROM), nie po
+// indeksie – indeks zmienia się przy każdym dołożeniu/wyjęciu czujnika.
+// NVS "sensor_config": chamber_rom / meat_rom (8 bajtów).
+static uint8_t roleIds[PROBE_COUNT][8];
+static bool roleBound[PROBE_COUNT] = {};
+static const char* const roleNvsKeys[PROBE_COUNT] = {"chamber_rom", "meat_rom", "chamber2_rom", "chamber3_rom",
+                                                     "meat2_rom", "meat3_rom", "meat4_rom", "meat5_rom",
+                                                     "meat6_rom", "meat7_rom", "meat8_rom", "ambient_rom"};
 
 // ======================================================
 // FUNKCJE DO IDENTYFIKACJI I PRZYPISYWANIA CZUJNIKÓW
 // ======================================================
 
-void identifyAndAssignSensors() {
-    if (sensorsIdentified) return;
+// Magistrala dostępna dla pomiaru/wyszukiwania: przed przejęciem przez RMT
+// (skan startowy, self-test) i w trybie bit-bang – tylko PIN_ONEWIRE
+static bool busUsable(int bus) {
+    return useRmt ? buses[bus].active : bus == 0;
+}
 
-    int deviceCount = sensors.getDeviceCount();
-    LOG_FMT(LOG_LEVEL_INFO, "Identifying %d sensor(s)...", deviceCount);
+static void busResetSearch(int bus) {
+    if (useRmt) buses[bus].rmt.resetSearch();
+    else oneWire.reset_search();
+}
 
-    if (deviceCount >= 2) {
-        for (int i = 0; i < deviceCount && i < 2; i++) {
-            if (sensors.getAddress(sensorAddresses[i], i)) {
+static bool busSearch(int bus, uint8_t* addr) {
+    return useRmt ? buses[bus].rmt.search(addr) : oneWire.search(addr);
+}
+
+// Jedno przejście search() po każdej magistrali – zapisuje adresy ROM do tablicy.
+// Wołane przy starcie (hardware_init_sensors) i przy ponownym skanowaniu.
+// Po przejęciu pinów przez RMT wyszukiwanie idzie przez kanały RMT (bit-bang
+// OneWire nie może już sterować linią).
+int Ds18b20Driver::discover() {
+    uint8_t addr[8];
+    int count = 0;
+
+    for (int bus = 0; bus < ONEWIRE_BUS_COUNT; bus++) {
+        if (!busUsable(bus)) continue;
+        busResetSearch(bus);
+        while (count < MAX_SENSORS && busSearch(bus, addr)) {
+            busStats[bus].searches++;
+            if (OneWire::crc8(addr, 7) != addr[7]) {
+                log_msg(LOG_LEVEL_WARN, "Sensor ROM CRC error - skipped");
+                continue;
+            }
+            if (!sensors.validFamily(addr)) continue;
+            memcpy(sensorAddresses[count], addr, sizeof(addr));
+            sensorBus[count] = (uint8_t)bus;
+            count++;
+        }
+    }
+    sensorTableCount = count;
+
+    for (int i = 0; i < count; i++) {
+        sensorResolution[i] = 0;
+        sensorTargetRes[i] = SENSOR_RES_STEADY;
+        sensorAlarmRegs[i][0] = 0x4B;   // wartości fabryczne TH/TL
+        sensorAlarmRegs[i][1] = 0x46;
+        sensorMissCount[i] = 0;
+    }
+    for (int i = 0; i < PROBE_COUNT; i++) {
+        probes[i].readyAtMs = 0;
+        probes[i].retried = false;
+    }
+    bgScan.active = false;
+    bgScan.applyPending = false;
+    bgScan.nextScanMs = millis() + SENSOR_RESCAN_INTERVAL;
+    return count;
+}
+
+void Ds18b20Driver::channelInfo(int slot, SensorChannel& ch) const {
+    memcpy(ch.id, sensorAddresses[slot], sizeof(ch.id));
+    ch.backend = SensorBackend::DS18B20;
+    ch.slot = (uint8_t)slot;
+}
+
+const char* sensorBackendName(SensorBackend backend) {
+    switch (backend) {
+        case SensorBackend::DS18B20:  return "DS18B20";
+        case SensorBackend::MAX31855: return "MAX31855";
+        case SensorBackend::MAX6675:  return "MAX6675";
+        default:                      return "?";
+    }
+}
+
+static void formatChannelId(const uint8_t* id, char* out, size_t len) {
+    snprintf(out, len, "%02X%02X%02X%02X%02X%02X%02X%02X",
+             id[0], id[1], id[2], id[3], id[4], id[5], id[6], id[7]);
+}
+
+// Tablica kanałów z aktualnego stanu sterowników (bez ponownego wykrywania)
+static void buildChannelTable() {
+    channelCount = 0;
+    for (int d = 0; d < DRIVER_COUNT; d++) {
+        int n = drivers[d]->size();
+        for (int slot = 0; slot < n && channelCount < MAX_CHANNELS; slot++) {
+            drivers[d]->channelInfo(slot, channels[channelCount]);
+            channelDrivers[channelCount] = drivers[d];
+            channelCal[channelCount] = calibration_load(channels[channelCount].id);
+            channelCount++;
+        }
+    }
+
+    for (int i = 0; i < channelCount; i++) {
+        char addrStr[24];
+        formatChannelId(channels[i].id, addrStr, sizeof(addrStr));
+        LOG_FMT(LOG_LEVEL_INFO, "Sensor %d: %s %s (cal x%.4f %+.2f)", i,
+                sensorBackendName(channels[i].backend), addrStr, channelCal[i].gain, channelCal[i].offset);
+    }
+
+    LOG_FMT(LOG_LEVEL_INFO, "Sensor table: %d channel(s), %d DS18B20", channelCount, sensorTableCount);
+}
+
+static int findChannelById(const uint8_t* id) {
+    for (int i = 0; i < channelCount; i++) {
+        if (memcmp(channels[i].id, id, 8) == 0) return i;
+    }
+    return -1;
+}
+
+static void saveRoleBindings() {
+    nvs_handle_t nvsHandle;
+    if (nvs_open("sensor_config", NVS_READWRITE, &nvsHandle) != ESP_OK) return;
+    for (int role = 0; role < PROBE_COUNT; role++) {
+        if (roleBound[role]) nvs_set_blob(nvsHandle, roleNvsKeys[role], roleIds[role], 8);
+        else if (role >= PROBE_CHAMBER2) nvs_erase_key(nvsHandle, roleNvsKeys[role]);
+    }
+    // Indeksy zostają dla zgodności ze starszym firmware
+    if (chamberSensorIndex >= 0) nvs_set_u8(nvsHandle, "chamber_idx", chamberSensorIndex);
+    if (meatSensorIndex >= 0) nvs_set_u8(nvsHandle, "meat_idx", meatSensorIndex);
+    nvs_commit(nvsHandle);
+    nvs_close(nvsHandle);
+}
+
+static void bindRoleToChannel(int role, int ch) {
+    roleIndex(role) = ch;
+    roleBound[role] = (ch >= 0 && ch < channelCount);
+    if (roleBound[role]) memcpy(roleIds[role], channels[ch].id, 8);
+}
+
+// Odtworzenie indeksów ról po zmianie tablicy kanałów. Gdy czujnika roli nie ma
+// na magistrali, a jest dokładnie jeden DS18B20 bez roli – to wymieniona sonda:
+// rola przechodzi na nią bez restartu i bez ręcznego przypisania.
+static void resolveRoleBindings() {
+    bool changed = false;
+    bool rebound = false;
+
+    for (int role = 0; role < PROBE_COUNT; role++) {
+        if (!roleBound[role]) continue;
+
+        int ch = findChannelById(roleIds[role]);
+        if (ch < 0 && sensors.validFamily(roleIds[role])) {
+            int candidate = -1;
+            int candidates = 0;
+            for (int i = 0; i < channelCount; i++) {
+                if (channels[i].backend != SensorBackend::DS18B20) continue;
+                bool used = false;
+                for (int r = 0; r < PROBE_COUNT; r++) {
+                    if (r != role && roleBound[r] && memcmp(channels[i].id, roleIds[r], 8) == 0) used = true;
+                }
+                if (!used) {
+                    candidate = i;
+                    candidates++;
+                }
+            }
+            if (candidates == 1) {
+                ch = candidate;
+                memcpy(roleIds[role], channels[ch].id, 8);
+                rebound = true;
                 char addrStr[24];
-                snprintf(addrStr, sizeof(addrStr), "%02X%02X%02X%02X%02X%02X%02X%02X",
-                        sensorAddresses[i][0], sensorAddresses[i][1],
-                        sensorAddresses[i][2], sensorAddresses[i][3],
-                        sensorAddresses[i][4], sensorAddresses[i][5],
-                        sensorAddresses[i][6], sensorAddresses[i][7]);
-                LOG_FMT(LOG_LEVEL_INFO, "Sensor %d: %s", i, addrStr);
+                formatChannelId(channels[ch].id, addrStr, sizeof(addrStr));
+                LOG_FMT(LOG_LEVEL_WARN, "Probe replaced: %s re-bound to %s", roleName(role), addrStr);
+            }
+        }
+
+        int& index = roleIndex(role);
+        if (index != ch) {
+            index = ch;
+            probes[role].readyAtMs = 0;
+            probes[role].retried = false;
+            quality[role].ringCount = 0;
+            quality[role].ringHead = 0;
+            changed = true;
+            if (ch < 0) {
+                LOG_FMT(LOG_LEVEL_WARN, "%s probe missing from bus", roleName(role));
             }
         }
+    }
+
+    if (rebound) saveRoleBindings();
+    if (changed) estimator_reset();
+}
+
+// Odbudowa tablicy kanałów ze wszystkich sterowników
+int rebuildSensorTable() {
+    for (int d = 0; d < DRIVER_COUNT; d++) {
+        drivers[d]->discover();
+    }
+    buildChannelTable();
+
+    for (int i = 0; i < PROBE_COUNT; i++) {
+        quality[i].ringCount = 0;
+        quality[i].ringHead = 0;
+    }
+    if (sensorsIdentified) resolveRoleBindings();
+    return channelCount;
+}
+
+void identifyAndAssignSensors() {
+    if (sensorsIdentified) return;
+
+    int deviceCount = channelCount;
+    LOG_FMT(LOG_LEVEL_INFO, "Identifying %d sensor(s)...", deviceCount);
 
+    if (deviceCount >= 2) {
         nvs_handle_t nvsHandle;
         if (nvs_open("sensor_config", NVS_READONLY, &nvsHandle) == ESP_OK) {
+            size_t chamberLen = 8, meatLen = 8;
+            if (nvs_get_blob(nvsHandle, "chamber_rom", roleIds[PROBE_CHAMBER], &chamberLen) == ESP_OK &&
+                nvs_get_blob(nvsHandle, "meat_rom", roleIds[PROBE_MEAT], &meatLen) == ESP_OK &&
+                chamberLen == 8 && meatLen == 8) {
+
+                // Sondy zapasowe komory – opcjonalne
+                for (int role = PROBE_CHAMBER2; role < PROBE_COUNT; role++) {
+                    size_t len = 8;
+                    roleBound[role] = nvs_get_blob(nvsHandle, roleNvsKeys[role], roleIds[role], &len) == ESP_OK &&
+                                      len == 8;
+                }
+                nvs_close(nvsHandle);
+                roleBound[PROBE_CHAMBER] = true;
+                roleBound[PROBE_MEAT] = true;
+                for (int role = 0; role < PROBE_COUNT; role++) roleIndex(role) = -1;
+                resolveRoleBindings();
+                sensorsIdentified = true;
+                LOG_FMT(LOG_LEVEL_INFO, "Loaded sensor assignments from NVS: Chamber=%d, Meat=%d",
+                        chamberSensorIndex, meatSensorIndex);
+                return;
+            }
+
+            // Migracja: starsze firmware zapisywało tylko indeksy
             uint8_t savedChamberIndex, savedMeatIndex;
             if (nvs_get_u8(nvsHandle, "chamber_idx", &savedChamberIndex) == ESP_OK &&
                 nvs_get_u8(nvsHandle, "meat_idx", &savedMeatIndex) == ESP_OK) {
 
-                chamberSensorIndex = savedChamberIndex;
-                meatSensorIndex = savedMeatIndex;
-                sensorsIdentified = true;
-                log_msg(LOG_LEVEL_INFO, "Loaded sensor assignments from NVS");
                 nvs_close(nvsHandle);
+                bindRoleToChannel(PROBE_CHAMBER, savedChamberIndex);
+                bindRoleToChannel(PROBE_MEAT, savedMeatIndex);
+                saveRoleBindings();
+                sensorsIdentified = true;
+                log_msg(LOG_LEVEL_INFO, "Migrated index sensor assignments to ROM codes");
                 return;
             }
             nvs_close(nvsHandle);
         }
 
-        chamberSensorIndex = DEFAULT_CHAMBER_SENSOR;
-        meatSensorIndex = DEFAULT_MEAT_SENSOR;
-
-        if (nvs_open("sensor_config", NVS_READWRITE, &nvsHandle) == ESP_OK) {
-            nvs_set_u8(nvsHandle, "chamber_idx", chamberSensorIndex);
-            nvs_set_u8(nvsHandle, "meat_idx", meatSensorIndex);
-            nvs_commit(nvsHandle);
-            nvs_close(nvsHandle);
-        }
+        bindRoleToChannel(PROBE_CHAMBER, DEFAULT_CHAMBER_SENSOR);
+        bindRoleToChannel(PROBE_MEAT, DEFAULT_MEAT_SENSOR);
+        saveRoleBindings();
 
         sensorsIdentified = true;
         LOG_FMT(LOG_LEVEL_INFO, "Assigned: Sensor %d = CHAMBER", chamberSensorIndex);
@@ -84,25 +527,98 @@ void identifyAndAssignSensors() {
     }
 }
 
+// Zmiana przypisań z web servera: cały wniosek sprawdzany od razu (przy błędzie
+// nic nie jest zmieniane), zastosowanie w tasku czujników (serviceSensors) –
+// indeksy ról, NVS, harmonogram sond i estymator należą do tego tasku
+static SensorAssignment pendingAssign;
+static volatile bool assignRequested = false;
+static portMUX_TYPE assignMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Docelowe indeksy wszystkich ról po zastosowaniu wniosku; false = indeks poza
+// tablicą kanałów albo ten sam kanał w dwóch rolach
+static bool buildRoleMap(const SensorAssignment& req, int* roles) {
+    for (int role = 0; role < PROBE_COUNT; role++) roles[role] = roleIndex(role);
+    roles[PROBE_CHAMBER] = req.chamber;
+    roles[PROBE_MEAT] = req.meat;
+    // Sonda dodatkowa spoza wniosku nie może dublować nowej komory/mięsa
+    for (int role = PROBE_CHAMBER2; role < PROBE_COUNT; role++) {
+        if (roles[role] >= 0 && (roles[role] == req.chamber || roles[role] == req.meat)) roles[role] = -1;
+    }
+    if (req.setBackups) {
+        for (int i = 0; i < CHAMBER_PROBES_MAX - 1; i++) roles[PROBE_CHAMBER2 + i] = req.backup[i];
+    }
+    if (req.setMeatExtra) {
+        for (int i = 0; i < MEAT_PROBES_MAX - 1; i++) roles[PROBE_MEAT2 + i] = req.meatExtra[i];
+    }
+    if (req.setAmbient) roles[PROBE_AMBIENT] = req.ambient;
+
+    if (roles[PROBE_CHAMBER] < 0 || roles[PROBE_MEAT] < 0) return false;
+    for (int role = 0; role < PROBE_COUNT; role++) {
+        int idx = roles[role];
+        if (idx < -1 || idx >= channelCount) return false;
+        if (idx < 0) continue;
+        for (int r = 0; r < role; r++) {
+            if (roles[r] == idx) return false;
+        }
+    }
+    return true;
+}
+
+bool requestSensorAssignment(const SensorAssignment& req) {
+    int roles[PROBE_COUNT];
+    if (!buildRoleMap(req, roles)) {
+        log_msg(LOG_LEVEL_ERROR, "Invalid sensor assignment - nothing changed");
+        return false;
+    }
+    portENTER_CRITICAL(&assignMux);
+    pendingAssign = req;
+    assignRequested = true;
+    portEXIT_CRITICAL(&assignMux);
+    return true;
+}
+
 void reassignSensors(int newChamberIndex, int newMeatIndex) {
-    if (newChamberIndex == newMeatIndex) {
-        log_msg(LOG_LEVEL_ERROR, "Cannot assign same sensor to both chamber and meat!");
+    SensorAssignment req = {};
+    req.chamber = newChamberIndex;
+    req.meat = newMeatIndex;
+    requestSensorAssignment(req);
+}
+
+// Wołane z serviceSensors(): tablica kanałów mogła się zmienić od złożenia
+// wniosku (skan w tle), więc walidacja jeszcze raz
+static void applySensorAssignment(const SensorAssignment& req) {
+    int roles[PROBE_COUNT];
+    if (!buildRoleMap(req, roles)) {
+        log_msg(LOG_LEVEL_WARN, "Sensor assignment dropped - channel table changed");
         return;
     }
 
-    chamberSensorIndex = newChamberIndex;
-    meatSensorIndex = newMeatIndex;
-
-    nvs_handle_t nvsHandle;
-    if (nvs_open("sensor_config", NVS_READWRITE, &nvsHandle) == ESP_OK) {
-        nvs_set_u8(nvsHandle, "chamber_idx", chamberSensorIndex);
-        nvs_set_u8(nvsHandle, "meat_idx", meatSensorIndex);
-        nvs_commit(nvsHandle);
-        nvs_close(nvsHandle);
+    bool mainChanged = false;
+    for (int role = 0; role < PROBE_COUNT; role++) {
+        if (roles[role] == roleIndex(role)) continue;
+        bindRoleToChannel(role, roles[role]);
+        probes[role].readyAtMs = 0;
+        probes[role].retried = false;
+        quality[role].ringCount = 0;
+        quality[role].ringHead = 0;
+        for (int i = 0; i < CHAMBER_PROBES_MAX; i++) {
+            if (chamberRoles[i] == role) vote.members[i].valid = false;
+        }
+        if (isMeatRole(role)) meatProbes[meatProbeNumber(role)].valid = false;
+        if (role == PROBE_AMBIENT) ambientProbe.valid = false;
+        if (role == PROBE_CHAMBER || role == PROBE_MEAT) mainChanged = true;
     }
+    saveRoleBindings();
+    meatPublishMs = 0;
+    if (mainChanged) estimator_reset();
 
-    LOG_FMT(LOG_LEVEL_INFO, "Reassigned sensors: Chamber=%d, Meat=%d",
-            chamberSensorIndex, meatSensorIndex);
+    int extra = 0;
+    for (int i = 0; i < MEAT_PROBES_MAX - 1; i++) {
+        if (meatExtraIndex[i] >= 0) extra++;
+    }
+    LOG_FMT(LOG_LEVEL_INFO, "Reassigned sensors: Chamber=%d (backup %d, %d), Meat=%d (+%d), Ambient=%d",
+            chamberSensorIndex, chamberBackupIndex[0], chamberBackupIndex[1], meatSensorIndex, extra,
+            ambientSensorIndex);
     buzzerBeep(2, 100, 100);
 }
 
@@ -110,67 +626,951 @@ void reassignSensors(int newChamberIndex, int newMeatIndex) {
 // GŁÓWNE FUNKCJE CZUJNIKÓW
 // ======================================================
 
-void requestTemperature() {
-    unsigned long now = millis();
-    if (now - lastTempRequest >= TEMP_REQUEST_INTERVAL) {
-        sensors.setWaitForConversion(false);
-        if (sensors.requestTemperatures()) {
-            lastTempRequest = now;
-            lastTempReadPossible = now + TEMP_CONVERSION_TIME;
-        } else {
-            log_msg(LOG_LEVEL_WARN, "Temperature request failed");
+// Współczynniki zmienione z web servera – przeładowanie w tasku czujników
+void requestSensorCalReload() {
+    calReloadRequested = true;
+}
+
+bool startSensorCalibration(int role) {
+    if (role < 0 || role >= PROBE_COUNT) return false;
+    int ch = roleIndex(role);
+    if (ch < 0 || ch >= channelCount) return false;
+    return calibration_begin(role, channels[ch].id);
+}
+
+// Kasowanie w tasku czujników – rola może w międzyczasie zmienić kanał
+bool clearSensorCalibration(int role) {
+    if (role < 0 || role >= PROBE_COUNT) return false;
+    int ch = roleIndex(role);
+    if (ch < 0 || ch >= channelCount) return false;
+    calClearRole = role;
+    return true;
+}
+
+// [TIMING] czas cyklu per magistrala – z tasku Monitor (CFG_TIMING_MEASUREMENT)
+void logSensorBusTiming() {
+    for (int bus = 0; bus < ONEWIRE_BUS_COUNT; bus++) {
+        if (!busUsable(bus)) continue;
+        const BusStats& bs = busStats[bus];
+        LOG_FMT(LOG_LEVEL_INFO, "[TIMING] OneWire bus %d (GPIO %d): cycle %lu ms, max %lu ms, wire %lu us",
+                bus, onewirePins[bus], bs.lastCycleMs, bs.maxCycleMs, bs.lastCycleWireUs);
+    }
+}
+
+// Skan w tle od razu, bez czekania na SENSOR_RESCAN_INTERVAL
+void requestSensorRescan() {
+    bgScan.forced = true;
+}
+
+// Przejęcie magistrali przez RMT – wołane z tasku czujników, po skanie
+// startowym i self-teście (te jeszcze używają DallasTemperature).
+void initSensorDriver() {
+    if (!CFG_ONEWIRE_USE_RMT) {
+        log_msg(LOG_LEVEL_INFO, "OneWire driver: bit-bang");
+        return;
+    }
+
+    useRmt = true;
+    int extraBuses = 0;
+    for (int bus = 0; bus < ONEWIRE_BUS_COUNT; bus++) {
+        if (onewirePins[bus] < 0) continue;
+        buses[bus].active = buses[bus].rmt.begin(onewirePins[bus]);
+        if (!buses[bus].active) useRmt = false;
+        else if (bus > 0) extraBuses++;
+    }
+
+    if (!useRmt) {
+        for (int bus = 0; bus < ONEWIRE_BUS_COUNT; bus++) {
+            buses[bus].rmt.end();
+            buses[bus].active = false;
         }
+        log_msg(LOG_LEVEL_WARN, "OneWire RMT unavailable - falling back to bit-bang (PIN_ONEWIRE only)");
+        return;
     }
+
+    // Skan startowy widział tylko PIN_ONEWIRE – czujniki z pozostałych magistral
+    // muszą być w tablicy przed identyfikacją ról (inaczej wyglądałyby na wyjęte)
+    if (extraBuses > 0) rebuildSensorTable();
 }
 
+bool isSensorDriverRmt() {
+    return useRmt;
+}
+
+// 85.0 (power-on reset DS18B20) wykrywa dekoder scratchpada – termopara
+// może legalnie pokazać 85.00 C
 static bool isValidTemperature(double t) {
     return (t != DEVICE_DISCONNECTED_C &&
-            t != 85.0 &&
             t != 127.0 &&
             t >= -20.0 &&
             t <= 200.0);
 }
 
+static void ensureSensorsIdentified() {
+    if (!sensorsIdentified) {
+        identifyAndAssignSensors();
+        if (!sensorsIdentified) {
+            log_msg(LOG_LEVEL_WARN, "Sensors not identified, using defaults");
+            chamberSensorIndex = DEFAULT_CHAMBER_SENSOR;
+            meatSensorIndex = DEFAULT_MEAT_SENSOR;
+        }
+    }
+}
+
+static void processReadings(double tChamber, double tMeat, unsigned long now);
+
+int sensorRoleSlot(int role, const TempSensorDriver* drv) {
+    int ch = roleIndex(role);
+    if (ch < 0 || ch >= channelCount || channelDrivers[ch] != drv) return -1;
+    return channels[ch].slot;
+}
+
+// Indeks w tablicy ROM, jeśli rola jest przypisana do DS18B20
+static int probeSensorIndex(int role) {
+    return sensorRoleSlot(role, &dsDriver);
+}
+
+// Czas konwersji skaluje się 2x na bit (DS18B20: 94/188/375/750 ms + zapas)
+static unsigned long conversionTimeMs(uint8_t resolution) {
+    if (resolution < 9 || resolution > 12) resolution = 12;
+    return TEMP_CONVERSION_TIME >> (12 - resolution);
+}
+
+// Okres pomiaru = czas konwersji + stały zapas z TEMP_REQUEST_INTERVAL.
+// Dodatkowe sondy mięsa rzadziej – przy 8+ czujnikach na magistrali komora
+// (pierwsza w kolejności ról) zachowuje swój okres. Otoczenie zmienia się
+// najwolniej – co AMBIENT_PROBE_INTERVAL_MS.
+static unsigned long probeInterval(int role, int idx) {
+    unsigned long base = TEMP_REQUEST_INTERVAL - TEMP_CONVERSION_TIME + conversionTimeMs(sensorResolution[idx]);
+    if (role == PROBE_AMBIENT) return base < AMBIENT_PROBE_INTERVAL_MS ? AMBIENT_PROBE_INTERVAL_MS : base;
+    return (role >= PROBE_MEAT2 && base < MEAT_PROBE_INTERVAL_MS) ? MEAT_PROBE_INTERVAL_MS : base;
+}
+
+// Krok kwantyzacji odczytu: 0.5 C przy 9 bitach, 0.0625 C przy 12
+double Ds18b20Driver::quantStep(int slot) const {
+    uint8_t res = (slot >= 0 && slot < sensorTableCount) ? sensorResolution[slot] : 0;
+    if (res < 9 || res > 12) res = 12;
+    return 0.5 / (1 << (res - 9));
+}
+
+static double quantStep(int role) {
+    int ch = roleIndex(role);
+    if (ch < 0 || ch >= channelCount) return 0.0625;
+    return channelDrivers[ch]->quantStep(channels[ch].slot);
+}
+
+static void countTransaction(int bus) {
+    busStats[bus].transactions++;
+    busStats[bus].cycleTransactions++;
+}
+
+// --- Analizator magistrali ---
+
+static void histAdd(uint32_t* hist, const uint16_t* edges, uint16_t value) {
+    int bin = 0;
+    while (bin < BUS_HIST_BINS - 1 && value >= edges[bin]) bin++;
+    hist[bin]++;
+}
+
+// Diagnostyka czujnika o indeksie w tablicy ROM; slot po adresie, wolny
+// albo po czujniku, którego już nie ma w tablicy
+static LineDiag* deviceDiag(int idx) {
+    if (idx < 0 || idx >= sensorTableCount) return nullptr;
+    const uint8_t* rom = sensorAddresses[idx];
+    for (int i = 0; i < MAX_SENSORS; i++) {
+        if (analyzer.devices[i].used && memcmp(analyzer.devices[i].rom, rom, 8) == 0) return &analyzer.devices[i].line;
+    }
+    int slot = -1;
+    for (int i = 0; i < MAX_SENSORS && slot < 0; i++) {
+        if (!analyzer.devices[i].used) slot = i;
+    }
+    for (int i = 0; i < MAX_SENSORS && slot < 0; i++) {
+        bool present = false;
+        for (int j = 0; j < sensorTableCount; j++) {
+            if (memcmp(analyzer.devices[i].rom, sensorAddresses[j], 8) == 0) present = true;
+        }
+        if (!present) slot = i;
+    }
+    if (slot < 0) return nullptr;
+    DeviceDiag& dd = analyzer.devices[slot];
+    memset(&dd, 0, sizeof(dd));
+    memcpy(dd.rom, rom, 8);
+    dd.used = true;
+    return &dd.line;
+}
+
+static void lineRecord(LineDiag& ld, OwStatus st, const OwTiming* timing) {
+    ld.transactions++;
+    if (st == OwStatus::NO_PRESENCE) ld.presenceFailures++;
+    else if (st == OwStatus::ERROR) ld.timeouts++;
+    if (!timing) return;
+    if (timing->presenceWidthUs > 0) {
+        histAdd(ld.presenceHist, presenceWidthEdges, timing->presenceWidthUs);
+        if (ld.presenceGapMax == 0 || timing->presenceGapUs < ld.presenceGapMin) ld.presenceGapMin = timing->presenceGapUs;
+        if (timing->presenceGapUs > ld.presenceGapMax) ld.presenceGapMax = timing->presenceGapUs;
+    }
+    if (timing->readSlots) {
+        histAdd(ld.riseHist, riseEdges, timing->maxOneLowUs);
+        if (timing->maxOneLowUs > ld.riseMax) ld.riseMax = timing->maxOneLowUs;
+        if (timing->minZeroLowUs && (ld.zeroLowMin == 0 || timing->minZeroLowUs < ld.zeroLowMin))
+            ld.zeroLowMin = timing->minZeroLowUs;
+    }
+}
+
+// Wynik transakcji adresowanej do czujnika idx; timing = nullptr przy bit-bang / timeout
+static void analyzerRecord(int bus, int idx, OwStatus st, const OwTiming* timing) {
+    if (!analyzer.enabled) return;
+    lineRecord(analyzer.bus[bus], st, timing);
+    LineDiag* dd = deviceDiag(idx);
+    if (dd) lineRecord(*dd, st, timing);
+}
+
+// Błąd treści scratchpada (transakcja zakończona poprawnie elektrycznie)
+static void analyzerFault(int bus, int idx, ReadFault fault) {
+    if (!analyzer.enabled || (fault != ReadFault::CRC && fault != ReadFault::DISCONNECTED)) return;
+    LineDiag* dd = deviceDiag(idx);
+    if (fault == ReadFault::CRC) {
+        analyzer.bus[bus].crcErrors++;
+        if (dd) dd->crcErrors++;
+    } else {
+        analyzer.bus[bus].noData++;
+        if (dd) dd->noData++;
+    }
+}
+
+static void analyzerRetry(int bus, int idx) {
+    if (!analyzer.enabled) return;
+    analyzer.bus[bus].retries++;
+    LineDiag* dd = deviceDiag(idx);
+    if (dd) dd->retries++;
+}
+
+static unsigned long lineErrors(const LineDiag& ld) {
+    return ld.presenceFailures + ld.timeouts + ld.crcErrors + ld.noData;
+}
+
+// Koniec cyklu odczytu jednego czujnika na magistrali
+static void busCycleDone(int bus, int role, unsigned long now) {
+    BusStats& bs = busStats[bus];
+    bs.lastCycleMs = now - probes[role].lastConvertMs;
+    if (bs.lastCycleMs > bs.maxCycleMs) bs.maxCycleMs = bs.lastCycleMs;
+    bs.cycles++;
+    bs.lastCycleTransactions = bs.cycleTransactions;
+    bs.cycleTransactions = 0;
+    bs.lastCycleWireUs = bs.cycleWireUs;
+    bs.cycleWireUs = 0;
+}
+
+static double ringMedian(const ProbeQuality& q) {
+    double sorted[MEDIAN_WINDOW];
+    memcpy(sorted, q.ring, q.ringCount * sizeof(double));
+    std::sort(sorted, sorted + q.ringCount);
+    return sorted[q.ringCount / 2];
+}
+
+// Liczniki jakości + filtr Hampla: próbka odbiegająca od mediany okna o więcej
+// niż MEDIAN_SPIKE_LIMIT jest zastępowana medianą. Surowa wartość i tak trafia
+// do bufora, więc rzeczywisty skok przechodzi po ~N/2 odczytach.
+static double filterReading(int role, double t, ReadFault fault) {
+    ProbeQuality& q = quality[role];
+    if (fault == ReadFault::NONE && !isValidTemperature(t)) fault = ReadFault::RANGE;
+
+    switch (fault) {
+        case ReadFault::NONE:           q.goodReads++; break;
+        case ReadFault::CRC:            q.crcErrors++; break;
+        case ReadFault::POWER_ON_RESET: q.powerOnResets++; break;
+        case ReadFault::DISCONNECTED:   q.disconnects++; break;
+        case ReadFault::RANGE:          q.rangeErrors++; break;
+    }
+
+    bool bad = (fault != ReadFault::NONE);
+    q.errorRate = (1.0 - QUALITY_RATE_ALPHA) * q.errorRate + (bad ? QUALITY_RATE_ALPHA : 0.0);
+    if (!q.degraded && q.errorRate > QUALITY_WARN_RATE) {
+        q.degraded = true;
+        LOG_FMT(LOG_LEVEL_WARN, "%s probe degraded: %.0f%% bad reads (crc %lu, por %lu, disc %lu)",
+                roleName(role), q.errorRate * 100.0,
+                q.crcErrors, q.powerOnResets, q.disconnects);
+    } else if (q.degraded && q.errorRate < QUALITY_WARN_RATE / 2) {
+        q.degraded = false;
+        LOG_FMT(LOG_LEVEL_INFO, "%s probe quality recovered", roleName(role));
+    }
+
+    if (bad) return DEVICE_DISCONNECTED_C;
+
+    q.ring[q.ringHead] = t;
+    q.ringHead = (q.ringHead + 1) % MEDIAN_WINDOW;
+    if (q.ringCount < MEDIAN_WINDOW) q.ringCount++;
+    if (q.ringCount < MEDIAN_WINDOW) return t;
+
+    double median = ringMedian(q);
+    if (fabs(t - median) > MEDIAN_SPIKE_LIMIT) {
+        q.spikesRejected++;
+        return median;
+    }
+    return t;
+}
+
+// Głosowanie sond komory raz na rundę odczytów: gdy każda przypisana sonda
+// oddała odczyt od poprzedniego głosowania albo któraś odczytuje drugi raz
+// przed pozostałymi (zawieszona sonda nie wstrzymuje wyniku). Poza końcem
+// rundy NAN – estymator i kompensacja bezwładności dostają jedną próbkę na okres.
+// 3 sondy: mediana (jedna uszkodzona/odstająca nie wpływa na wynik);
+// 2 sondy: średnia, a przy niezgodności – bliższa poprzedniemu wynikowi;
+// 1 sonda: jej odczyt. Zła sonda wypada z głosowania od razu – bez czekania
+// na SENSOR_ERROR_THRESHOLD i bez PAUSE_SENSOR, dopóki głosuje choć jedna.
+static double voteChamber(int role, double t, unsigned long now) {
+    int m = 0;
+    while (m < CHAMBER_PROBES_MAX && chamberRoles[m] != role) m++;
+    if (m == CHAMBER_PROBES_MAX) return DEVICE_DISCONNECTED_C;
+    vote.members[m].value = t;
+    vote.members[m].timestamp = now;
+    vote.members[m].valid = (t != DEVICE_DISCONNECTED_C);
+
+    uint8_t due = 0;
+    for (int i = 0; i < CHAMBER_PROBES_MAX; i++) {
+        if (roleIndex(chamberRoles[i]) >= 0) due |= (uint8_t)(1 << i);
+    }
+    bool repeat = vote.reported & (1 << m);
+    vote.reported |= (uint8_t)(1 << m);
+    if (!repeat && (vote.reported & due) != due) return NAN;
+    // Odczyt, który zamknął rundę powtórką, liczy się też do następnej
+    vote.reported = repeat ? (uint8_t)(1 << m) : 0;
+
+    double vals[CHAMBER_PROBES_MAX];
+    int who[CHAMBER_PROBES_MAX];
+    int n = 0, assigned = 0;
+    for (int i = 0; i < CHAMBER_PROBES_MAX; i++) {
+        VoteMember& vm = vote.members[i];
+        vm.outlier = false;
+        if (roleIndex(chamberRoles[i]) < 0) continue;
+        assigned++;
+        if (vm.valid && now - vm.timestamp <= VOTE_MAX_AGE_MS) {
+            vals[n] = vm.value;
+            who[n] = i;
+            n++;
+        }
+    }
+
+    if (n < vote.used && n > 0) {
+        vote.failovers++;
+        LOG_FMT(LOG_LEVEL_WARN, "Chamber vote: %d of %d probe(s) left", n, assigned);
+    }
+    vote.assigned = assigned;
+    vote.used = n;
+    vote.votes++;
+
+    bool disagree = false;
+    double result = DEVICE_DISCONNECTED_C;
+    int source = (n > 0) ? who[0] : 0;
+    if (n == 1) {
+        result = vals[0];
+    } else if (n == 2) {
+        if (fabs(vals[0] - vals[1]) <= VOTE_DISAGREE_LIMIT) {
+            result = (vals[0] + vals[1]) / 2.0;
+        } else {
+            disagree = true;
+            int pick = (vote.lastValid && fabs(vals[1] - vote.lastValue) < fabs(vals[0] - vote.lastValue)) ? 1 : 0;
+            result = vals[pick];
+            source = who[pick];
+            vote.members[who[1 - pick]].outlier = true;
+            vote.members[who[1 - pick]].outliers++;
+        }
+    } else if (n == 3) {
+        double sorted[3] = {vals[0], vals[1], vals[2]};
+        std::sort(sorted, sorted + 3);
+        result = sorted[1];
+        for (int i = 0; i < n; i++) {
+            if (vals[i] == result) source = who[i];
+        }
+        for (int i = 0; i < n; i++) {
+            if (fabs(vals[i] - result) > VOTE_DISAGREE_LIMIT) {
+                disagree = true;
+                vote.members[who[i]].outlier = true;
+                vote.members[who[i]].outliers++;
+            }
+        }
+    }
+
+    if (disagree && !vote.disagree) {
+        vote.disagreements++;
+        LOG_FMT(LOG_LEVEL_WARN, "Chamber probes disagree (>%.1f C) - voted %.2f C", VOTE_DISAGREE_LIMIT, result);
+    }
+    vote.disagree = disagree;
+    vote.source = chamberRoles[source];
+    vote.lastValid = (n > 0);
+    if (n > 0) vote.lastValue = result;
+    return result;
+}
+
+void sensorDeliverReading(int role, double t, ReadFault fault, unsigned long now) {
+    // Kalibracja przed filtrem – mediana i estymator widzą już skorygowaną skalę
+    if (fault == ReadFault::NONE && isValidTemperature(t)) {
+        calibration_feed(role, t);
+        int ch = roleIndex(role);
+        if (ch >= 0 && ch < channelCount) t = calibration_apply(channelCal[ch], t);
+    }
+    t = filterReading(role, t, fault);
+    if (isChamberRole(role)) {
+        double voted = voteChamber(role, t, now);
+        if (!isnan(voted)) processReadings(voted, NAN, now);
+        return;
+    }
+    if (role == PROBE_AMBIENT) {
+        ambientProbe.valid = isValidTemperature(t);
+        if (ambientProbe.valid) {
+            ambientProbe.value = t;
+            ambientProbe.timestamp = now;
+        }
+        return;
+    }
+
+    MeatProbe& mp = meatProbes[meatProbeNumber(role)];
+    mp.valid = isValidTemperature(t);
+    if (mp.valid) {
+        mp.value = t;
+        mp.timestamp = now;
+    }
+    // Sonda główna zasila estymator, cache i g_tMeat jak dotąd
+    if (role == PROBE_MEAT) processReadings(NAN, t, now);
+}
+
+// Wartości wszystkich sond mięsa do state (NAN = brak/nieświeży odczyt)
+static void publishMeatProbes(unsigned long now) {
+    if (meatPublishMs != 0 && now - meatPublishMs < MEAT_PUBLISH_MS) return;
+    meatPublishMs = now;
+    double values[MEAT_PROBES_MAX];
+    uint16_t mask = 0;
+    for (int n = 0; n < MEAT_PROBES_MAX; n++) {
+        const MeatProbe& mp = meatProbes[n];
+        bool assigned = roleIndex(meatProbeRole(n)) >= 0;
+        if (assigned) mask |= (uint16_t)(1 << n);
+        values[n] = (assigned && mp.valid && now - mp.timestamp <= MEAT_MAX_AGE_MS) ? mp.value : NAN;
+    }
+    bool ambientFresh = ambientSensorIndex >= 0 && ambientProbe.valid &&
+                        now - ambientProbe.timestamp <= AMBIENT_MAX_AGE_MS;
+    if (!state_lock()) return;
+    for (int n = 0; n < MEAT_PROBES_MAX; n++) g_tMeatProbes[n] = values[n];
+    g_meatProbeMask = mask;
+    g_tAmbient = ambientFresh ? ambientProbe.value : NAN;
+    state_unlock();
+}
+
+// Scratchpad DS18B20 → °C; bity poniżej ustawionej rozdzielczości są nieokreślone.
+// Wspólne dla RMT i bit-bang (readScratchPad), żeby klasyfikacja błędów była jedna.
+static ReadFault decodeScratchpad(const uint8_t* sp, double* tOut, uint8_t* resolutionOut) {
+    bool allZero = true, allOnes = true;
+    for (int i = 0; i < 9; i++) {
+        if (sp[i] != 0x00) allZero = false;
+        if (sp[i] != 0xFF) allOnes = false;
+    }
+    *tOut = DEVICE_DISCONNECTED_C;
+    // Linia zwarta do masy / nikt nie odpowiada
+    if (allZero || allOnes) return ReadFault::DISCONNECTED;
+    if (OneWire::crc8(sp, 8) != sp[8]) return ReadFault::CRC;
+
+    int16_t raw = (int16_t)((sp[1] << 8) | sp[0]);
+    uint8_t resolution = ((sp[4] >> 5) & 0x03) + 9;
+    raw &= (int16_t)~((1 << (12 - resolution)) - 1);
+    if (resolutionOut) *resolutionOut = resolution;
+    *tOut = raw / 16.0;
+
+    if (*tOut == 85.0) return ReadFault::POWER_ON_RESET;
+    return ReadFault::NONE;
+}
+
+// Polityka rozdzielczości komory: szybkie zmiany (drzwi, nagrzewanie) → 9/10 bit,
+// stan ustalony → 12 bit. Obniżenie natychmiast, powrót dopiero po RES_STEADY_HOLD_MS.
+static void updateResolutionPolicy(double tChamber, unsigned long now, bool doorActive) {
+    if (!resPolicy.refValid) {
+        resPolicy.refTemp = tChamber;
+        resPolicy.refMs = now;
+        resPolicy.refValid = true;
+    } else if (now - resPolicy.refMs >= RES_RATE_WINDOW) {
+        resPolicy.rate = (tChamber - resPolicy.refTemp) * 1000.0 / (double)(now - resPolicy.refMs);
+        resPolicy.refTemp = tChamber;
+        resPolicy.refMs = now;
+    }
+
+    // Decyzja wg pierwszej przypisanej sondy komory, ustawienie dla wszystkich
+    int idx = -1;
+    for (int m = 0; m < CHAMBER_PROBES_MAX && idx < 0; m++) idx = probeSensorIndex(chamberRoles[m]);
+    if (idx < 0) return;
+
+    double absRate = fabs(resPolicy.rate);
+    uint8_t wanted = SENSOR_RES_STEADY;
+    if (absRate >= RES_RATE_FASTEST) wanted = SENSOR_RES_FASTEST;
+    else if (absRate >= RES_RATE_FAST || doorActive) wanted = SENSOR_RES_FAST;
+
+    uint8_t current = sensorTargetRes[idx];
+    uint8_t target = current;
+    if (wanted < current) {
+        target = wanted;
+        resPolicy.holdSinceMs = 0;
+        LOG_FMT(LOG_LEVEL_INFO, "Chamber sensor -> %u bit (rate %.3f C/s)", wanted, resPolicy.rate);
+    } else if (wanted > current) {
+        if (resPolicy.holdSinceMs == 0) {
+            resPolicy.holdSinceMs = now;
+        } else if (now - resPolicy.holdSinceMs >= RES_STEADY_HOLD_MS) {
+            target = wanted;
+            resPolicy.holdSinceMs = 0;
+            LOG_FMT(LOG_LEVEL_INFO, "Chamber sensor -> %u bit (steady)", wanted);
+        }
+    } else {
+        resPolicy.holdSinceMs = 0;
+    }
+
+    for (int m = 0; m < CHAMBER_PROBES_MAX; m++) {
+        int probeIdx = probeSensorIndex(chamberRoles[m]);
+        if (probeIdx >= 0) sensorTargetRes[probeIdx] = target;
+    }
+}
+
+// ======================================================
+// STEROWNIK RMT – jedna transakcja naraz na magistralę, odpytywana co obieg tasku
+// ======================================================
+
+// MATCH ROM + komenda (+ dane) – wspólna ramka dla transakcji adresowanych
+static bool startAddressed(int bus, int idx, uint8_t command, const uint8_t* data, uint8_t dataLen,
+                           uint16_t rxBits) {
+    uint8_t cmd[13];
+    cmd[0] = 0x55;
+    memcpy(&cmd[1], sensorAddresses[idx], 8);
+    cmd[9] = command;
+    if (dataLen > 3) return false;
+    if (dataLen) memcpy(&cmd[10], data, dataLen);
+    if (!buses[bus].rmt.startTransaction(true, cmd, (10 + dataLen) * 8, rxBits)) return false;
+    countTransaction(bus);
+    return true;
+}
+
+static void setRmtJob(OneWireBus& ow, RmtJob job, int role, int idx) {
+    ow.job = job;
+    ow.jobRole = role;
+    ow.jobIndex = idx;
+}
+
+static bool startRmtJob(int bus, unsigned long now) {
+    OneWireBus& ow = buses[bus];
+    for (int role = 0; role < PROBE_COUNT; role++) {
+        int idx = probeSensorIndex(role);
+        if (idx < 0 || sensorBus[idx] != bus) continue;
+        ProbeSchedule& p = probes[role];
+
+        if (p.readyAtMs != 0) {
+            // READ SCRATCHPAD po upływie czasu konwersji tego czujnika
+            if ((long)(now - p.readyAtMs) >= 0 && startAddressed(bus, idx, 0xBE, nullptr, 0, 9 * 8)) {
+                setRmtJob(ow, RmtJob::READ, role, idx);
+                return true;
+            }
+            continue;
+        }
+
+        if (now - p.lastConvertMs < probeInterval(role, idx)) continue;
+
+        if (sensorResolution[idx] != sensorTargetRes[idx]) {
+            // WRITE SCRATCHPAD: TH, TL, konfiguracja (bez kopiowania do EEPROM)
+            uint8_t data[3] = {sensorAlarmRegs[idx][0], sensorAlarmRegs[idx][1],
+                               (uint8_t)(((sensorTargetRes[idx] - 9) << 5) | 0x1F)};
+            if (startAddressed(bus, idx, 0x4E, data, 3, 0)) {
+                setRmtJob(ow, RmtJob::CONFIG, role, idx);
+                return true;
+            }
+            continue;
+        }
+
+        if (role == PROBE_CHAMBER) ensureSensorsIdentified();
+        if (startAddressed(bus, idx, 0x44, nullptr, 0, 0)) {
+            p.lastConvertMs = now;
+            setRmtJob(ow, RmtJob::CONVERT, role, idx);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void finishRmtJob(int bus, OwStatus st, unsigned long now) {
+    OneWireBus& ow = buses[bus];
+    RmtJob job = ow.job;
+    int role = ow.jobRole;
+    int idx = ow.jobIndex;
+    ProbeSchedule& p = probes[role];
+    ow.job = RmtJob::NONE;
+
+    switch (job) {
+        case RmtJob::CONFIG:
+            if (st == OwStatus::DONE) {
+                // Weryfikacja przy najbliższym odczycie scratchpada
+                sensorResolution[idx] = sensorTargetRes[idx];
+            } else {
+                p.lastConvertMs = now;
+                sensorDeliverReading(role, DEVICE_DISCONNECTED_C, ReadFault::DISCONNECTED, now);
+            }
+            break;
+
+        case RmtJob::CONVERT:
+            if (st == OwStatus::DONE) {
+                p.readyAtMs = now + conversionTimeMs(sensorResolution[idx]);
+            } else {
+                // Brak presence = brak czujnika na linii – liczy się jako błąd odczytu
+                LOG_FMT(LOG_LEVEL_WARN, "Temperature request failed (bus %d)", bus);
+                sensorDeliverReading(role, DEVICE_DISCONNECTED_C, ReadFault::DISCONNECTED, now);
+            }
+            break;
+
+        case RmtJob::READ: {
+            uint8_t resolution = 0;
+            double t = DEVICE_DISCONNECTED_C;
+            ReadFault fault = ReadFault::DISCONNECTED;
+            if (st == OwStatus::DONE) {
+                const uint8_t* sp = ow.rmt.rxData();
+                fault = decodeScratchpad(sp, &t, &resolution);
+                if (resolution) {
+                    sensorResolution[idx] = resolution;
+                    sensorAlarmRegs[idx][0] = sp[2];
+                    sensorAlarmRegs[idx][1] = sp[3];
+                }
+                analyzerFault(bus, idx, fault);
+            }
+            // 85.0 = wartość po power-on reset – jeden ponowny odczyt
+            if (fault == ReadFault::POWER_ON_RESET && !p.retried) {
+                p.retried = true;
+                quality[role].powerOnResets++;
+                analyzerRetry(bus, idx);
+                return;
+            }
+            busCycleDone(bus, role, now);
+            p.readyAtMs = 0;
+            p.retried = false;
+            sensorDeliverReading(role, t, fault, now);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+static void serviceRmtBuses() {
+    unsigned long now = millis();
+    for (int bus = 0; bus < ONEWIRE_BUS_COUNT; bus++) {
+        OneWireBus& ow = buses[bus];
+        if (!ow.active) continue;
+        if (ow.job != RmtJob::NONE) {
+            OwStatus st = ow.rmt.poll();
+            if (st == OwStatus::BUSY) continue;
+            if (st != OwStatus::ERROR) busStats[bus].cycleWireUs += ow.rmt.lastWireTimeUs();
+            analyzerRecord(bus, ow.jobIndex, st, st != OwStatus::ERROR ? &ow.rmt.lastTiming() : nullptr);
+            finishRmtJob(bus, st, now);
+        }
+        startRmtJob(bus, now);
+    }
+}
+
+// ======================================================
+// STEROWNIK BIT-BANG (DallasTemperature)
+// ======================================================
+
 // [FIX] Uproszczony readTempWithTimeout - konwersja już się zakończyła,
 // wystarczy jeden odczyt. Pętla retry tylko jeśli pierwszy odczyt to 85.0 (power-on reset)
-static double readTempWithTimeout(uint8_t sensorIndex) {
-    double temp = sensors.getTempCByIndex(sensorIndex);
+// Odczyt po adresie ROM z tablicy – jedna transakcja na czujnik, bez search().
+// Surowy scratchpad zamiast getTempC(), żeby rozróżnić CRC / odłączenie / 85 C.
+static ReadFault readTempWithTimeout(int role, uint8_t sensorIndex, double* tOut) {
+    *tOut = DEVICE_DISCONNECTED_C;
+    if (sensorIndex >= sensorTableCount) return ReadFault::DISCONNECTED;
+    const uint8_t* rom = sensorAddresses[sensorIndex];
+    uint8_t sp[9];
+    uint8_t resolution = 0;
+
+    // Bit-bang: bez przebiegu linii – brak odpowiedzi liczony jako brak presence
+    countTransaction(0);
+    bool answered = sensors.readScratchPad(rom, sp);
+    analyzerRecord(0, sensorIndex, answered ? OwStatus::DONE : OwStatus::NO_PRESENCE, nullptr);
+    if (!answered) return ReadFault::DISCONNECTED;
+    ReadFault fault = decodeScratchpad(sp, tOut, &resolution);
+    analyzerFault(0, sensorIndex, fault);
 
     // Jeśli odczytaliśmy 85.0 (power-on reset value), spróbuj jeszcze raz po chwili
-    if (temp == 85.0) {
+    if (fault == ReadFault::POWER_ON_RESET) {
+        quality[role].powerOnResets++;
+        analyzerRetry(0, sensorIndex);
         delay(10);
-        temp = sensors.getTempCByIndex(sensorIndex);
+        countTransaction(0);
+        answered = sensors.readScratchPad(rom, sp);
+        analyzerRecord(0, sensorIndex, answered ? OwStatus::DONE : OwStatus::NO_PRESENCE, nullptr);
+        if (!answered) return ReadFault::DISCONNECTED;
+        fault = decodeScratchpad(sp, tOut, &resolution);
+        analyzerFault(0, sensorIndex, fault);
     }
 
-    return temp;
+    if (resolution) sensorResolution[sensorIndex] = resolution;
+    return fault;
 }
 
-void readTemperature() {
-    unsigned long now = millis();
-    if (lastTempReadPossible == 0 || now < lastTempReadPossible) return;
-    lastTempReadPossible = 0;
+static void requestConversionsLegacy(unsigned long now) {
+    for (int role = 0; role < PROBE_COUNT; role++) {
+        int idx = probeSensorIndex(role);
+        if (idx < 0 || sensorBus[idx] != 0) continue;
+        ProbeSchedule& p = probes[role];
+        if (p.readyAtMs != 0 || now - p.lastConvertMs < probeInterval(role, idx)) continue;
 
-    if (!sensorsIdentified) {
-        identifyAndAssignSensors();
-        if (!sensorsIdentified) {
-            log_msg(LOG_LEVEL_WARN, "Sensors not identified, using defaults");
-            chamberSensorIndex = DEFAULT_CHAMBER_SENSOR;
-            meatSensorIndex = DEFAULT_MEAT_SENSOR;
+        const uint8_t* rom = sensorAddresses[idx];
+        if (sensorResolution[idx] != sensorTargetRes[idx]) {
+            sensors.setResolution(rom, sensorTargetRes[idx]);
+            sensorResolution[idx] = sensors.getResolution(rom);
+            countTransaction(0);
+            countTransaction(0);
+        }
+
+        if (role == PROBE_CHAMBER) ensureSensorsIdentified();
+        sensors.setWaitForConversion(false);
+        p.lastConvertMs = now;
+        countTransaction(0);
+        bool started = sensors.requestTemperaturesByAddress(rom);
+        analyzerRecord(0, idx, started ? OwStatus::DONE : OwStatus::NO_PRESENCE, nullptr);
+        if (started) {
+            p.readyAtMs = now + conversionTimeMs(sensorResolution[idx]);
+        } else {
+            log_msg(LOG_LEVEL_WARN, "Temperature request failed");
+            sensorDeliverReading(role, DEVICE_DISCONNECTED_C, ReadFault::DISCONNECTED, now);
+        }
+    }
+}
+
+static void readConversionsLegacy(unsigned long now) {
+    for (int role = 0; role < PROBE_COUNT; role++) {
+        ProbeSchedule& p = probes[role];
+        if (p.readyAtMs == 0 || (long)(now - p.readyAtMs) < 0) continue;
+        p.readyAtMs = 0;
+        int idx = probeSensorIndex(role);
+        double t = DEVICE_DISCONNECTED_C;
+        ReadFault fault = (idx >= 0) ? readTempWithTimeout(role, idx, &t) : ReadFault::DISCONNECTED;
+        busCycleDone(0, role, now);
+        sensorDeliverReading(role, t, fault, now);
+    }
+}
+
+// --- Skan w tle (hot-plug) ---
+
+// Okno ciszy: żaden odczyt ani start konwersji nie wypada w ciągu
+// SENSOR_SCAN_QUIET_MS, więc krok search() nie opóźnia pomiaru
+static bool busQuiet(int bus, unsigned long now) {
+    if (buses[bus].job != RmtJob::NONE) return false;
+    for (int role = 0; role < PROBE_COUNT; role++) {
+        int idx = probeSensorIndex(role);
+        if (idx < 0 || sensorBus[idx] != bus) continue;
+        const ProbeSchedule& p = probes[role];
+        unsigned long due = p.readyAtMs ? p.readyAtMs : p.lastConvertMs + probeInterval(role, idx);
+        if ((long)(due - now) < (long)SENSOR_SCAN_QUIET_MS) return false;
+    }
+    return true;
+}
+
+// Scalenie wyniku skanu z tablicą ROM: znane czujniki zachowują pozycję
+// (i stan rozdzielczości), nowe dochodzą na koniec, brakujący wypada dopiero
+// po SENSOR_MISS_LIMIT kolejnych skanach (pojedynczy błąd search() to nie wyjęcie)
+static void applyBackgroundScan() {
+    uint8_t addr[MAX_SENSORS][8];
+    uint8_t res[MAX_SENSORS], target[MAX_SENSORS], alarm[MAX_SENSORS][2], miss[MAX_SENSORS];
+    uint8_t busOf[MAX_SENSORS];
+    int n = 0;
+    bool changed = false;
+
+    for (int i = 0; i < sensorTableCount; i++) {
+        int seenBus = -1;
+        for (int j = 0; j < bgScan.found; j++) {
+            if (memcmp(sensorAddresses[i], bgScan.roms[j], 8) == 0) seenBus = bgScan.romBus[j];
         }
+        sensorMissCount[i] = (seenBus >= 0) ? 0 : sensorMissCount[i] + 1;
+        if (sensorMissCount[i] >= SENSOR_MISS_LIMIT) {
+            char addrStr[24];
+            formatChannelId(sensorAddresses[i], addrStr, sizeof(addrStr));
+            LOG_FMT(LOG_LEVEL_WARN, "Sensor removed: %s", addrStr);
+            changed = true;
+            continue;
+        }
+        memcpy(addr[n], sensorAddresses[i], 8);
+        busOf[n] = sensorBus[i];
+        if (seenBus >= 0 && seenBus != sensorBus[i]) {
+            // Sonda przełożona na inną magistralę – ROM ten sam, przypisanie zostaje
+            LOG_FMT(LOG_LEVEL_INFO, "Sensor %d moved: bus %u -> %d", i, sensorBus[i], seenBus);
+            busOf[n] = (uint8_t)seenBus;
+            changed = true;
+        }
+        res[n] = sensorResolution[i];
+        target[n] = sensorTargetRes[i];
+        alarm[n][0] = sensorAlarmRegs[i][0];
+        alarm[n][1] = sensorAlarmRegs[i][1];
+        miss[n] = sensorMissCount[i];
+        n++;
     }
 
-    double tChamber = readTempWithTimeout(chamberSensorIndex);
-    double tMeat = readTempWithTimeout(meatSensorIndex);
+    for (int j = 0; j < bgScan.found && n < MAX_SENSORS; j++) {
+        bool known = false;
+        for (int i = 0; i < n; i++) {
+            if (memcmp(addr[i], bgScan.roms[j], 8) == 0) known = true;
+        }
+        if (known) continue;
+        memcpy(addr[n], bgScan.roms[j], 8);
+        busOf[n] = bgScan.romBus[j];
+        res[n] = 0;
+        target[n] = SENSOR_RES_STEADY;
+        alarm[n][0] = 0x4B;
+        alarm[n][1] = 0x46;
+        miss[n] = 0;
+        n++;
+        char addrStr[24];
+        formatChannelId(bgScan.roms[j], addrStr, sizeof(addrStr));
+        LOG_FMT(LOG_LEVEL_INFO, "Sensor added: %s (bus %u)", addrStr, bgScan.romBus[j]);
+        changed = true;
+    }
 
-    bool t1Valid = isValidTemperature(tChamber);
-    bool t2Valid = isValidTemperature(tMeat);
+    if (!changed) return;
+
+    memcpy(sensorAddresses, addr, sizeof(addr[0]) * n);
+    memcpy(sensorBus, busOf, n);
+    memcpy(sensorResolution, res, n);
+    memcpy(sensorTargetRes, target, n);
+    memcpy(sensorAlarmRegs, alarm, sizeof(alarm[0]) * n);
+    memcpy(sensorMissCount, miss, n);
+    sensorTableCount = n;
+
+    buildChannelTable();
+    if (sensorsIdentified) resolveRoleBindings();
+}
+
+static bool anyBusJob() {
+    for (int bus = 0; bus < ONEWIRE_BUS_COUNT; bus++) {
+        if (buses[bus].job != RmtJob::NONE) return true;
+    }
+    return false;
+}
+
+static int nextUsableBus(int from) {
+    for (int bus = from; bus < ONEWIRE_BUS_COUNT; bus++) {
+        if (busUsable(bus)) return bus;
+    }
+    return -1;
+}
+
+// Jeden krok skanu: co najwyżej jedno urządzenie (pełne przejście search())
+// na bieżącej magistrali; magistrale przeszukiwane po kolei
+static void backgroundScanStep(unsigned long now) {
+    if (bgScan.applyPending) {
+        // Scalenie przesuwa indeksy tablicy ROM – nie w trakcie transakcji
+        if (anyBusJob()) return;
+        bgScan.applyPending = false;
+        applyBackgroundScan();
+        return;
+    }
+
+    if (!bgScan.active) {
+        if (!bgScan.forced && (long)(now - bgScan.nextScanMs) < 0) return;
+        int first = nextUsableBus(0);
+        if (first < 0 || !busQuiet(first, now)) return;
+        bgScan.active = true;
+        bgScan.forced = false;
+        bgScan.found = 0;
+        bgScan.bus = first;
+        busResetSearch(first);
+    }
+    // Stan wyszukiwania przeżywa transakcje pomiarowe między krokami
+    if (!busQuiet(bgScan.bus, now)) return;
+
+    uint8_t addr[8];
+    if (busSearch(bgScan.bus, addr)) {
+        busStats[bgScan.bus].searches++;
+        if (OneWire::crc8(addr, 7) == addr[7] && sensors.validFamily(addr) &&
+            bgScan.found < MAX_SENSORS) {
+            bgScan.romBus[bgScan.found] = (uint8_t)bgScan.bus;
+            memcpy(bgScan.roms[bgScan.found++], addr, 8);
+        }
+        return;
+    }
+
+    int next = nextUsableBus(bgScan.bus + 1);
+    if (next >= 0) {
+        bgScan.bus = next;
+        busResetSearch(next);
+        return;
+    }
+
+    bgScan.active = false;
+    bgScan.applyPending = true;
+    bgScan.completed++;
+    bgScan.nextScanMs = millis() + SENSOR_RESCAN_INTERVAL;
+}
+
+void Ds18b20Driver::service(unsigned long now) {
+    backgroundScanStep(now);
+    if (useRmt) {
+        serviceRmtBuses();
+        return;
+    }
+    requestConversionsLegacy(now);
+    readConversionsLegacy(millis());
+}
+
+// Jeden obieg tasku czujników: krok harmonogramu każdego sterownika
+void serviceSensors() {
+    if (assignRequested) {
+        SensorAssignment req;
+        portENTER_CRITICAL(&assignMux);
+        req = pendingAssign;
+        assignRequested = false;
+        portEXIT_CRITICAL(&assignMux);
+        applySensorAssignment(req);
+    }
+    int clearRole = calClearRole;
+    if (clearRole >= 0) {
+        calClearRole = -1;
+        int ch = roleIndex(clearRole);
+        if (ch >= 0 && ch < channelCount && calibration_erase(channels[ch].id)) {
+            calReloadRequested = true;
+        } else {
+            LOG_FMT(LOG_LEVEL_WARN, "Cannot clear calibration of %s probe", roleName(clearRole));
+        }
+    }
+    if (calReloadRequested) {
+        calReloadRequested = false;
+        for (int i = 0; i < channelCount; i++) {
+            channelCal[i] = calibration_load(channels[i].id);
+        }
+        for (int i = 0; i < PROBE_COUNT; i++) {
+            quality[i].ringCount = 0;
+            quality[i].ringHead = 0;
+        }
+        log_msg(LOG_LEVEL_INFO, "Sensor calibration reloaded");
+    }
+    if (analyzer.resetRequested) {
+        analyzer.resetRequested = false;
+        memset(analyzer.bus, 0, sizeof(analyzer.bus));
+        memset(analyzer.devices, 0, sizeof(analyzer.devices));
+        analyzer.sinceMs = millis();
+        log_msg(LOG_LEVEL_INFO, "OneWire bus analyzer reset");
+    }
+
+    for (int d = 0; d < DRIVER_COUNT; d++) {
+        drivers[d]->service(millis());
+    }
+    publishMeatProbes(millis());
+    vchamber_update(millis(), getSensorCacheAge());
+}
+
+// Walidacja, cache i reakcja na błędy – wspólne dla wszystkich sterowników.
+// NAN = brak nowego odczytu danego czujnika w tym wywołaniu.
+static void processReadings(double tChamber, double tMeat, unsigned long now) {
+    bool hasChamber = !isnan(tChamber);
+    bool hasMeat = !isnan(tMeat);
+    bool t1Valid = hasChamber && isValidTemperature(tChamber);
+    bool t2Valid = hasMeat && isValidTemperature(tMeat);
 
     // Aktualizacja cache dla czujnika komory
-    if (!t1Valid) {
+    if (hasChamber && !t1Valid) {
         sensorErrorCount++;
         cachedChamber.readAttempts++;
 
-        if (sensorErrorCount >= SENSOR_ERROR_THRESHOLD) {
+        // Model komory przejmuje zamiast pauzy, jeśli zdążył się nauczyć
+        if (sensorErrorCount >= SENSOR_ERROR_THRESHOLD && !vchamber_engage(now, cachedChamber.value)) {
             if (state_lock()) {
                 g_errorSensor = true;
                 if (g_currentState == ProcessState::RUNNING_AUTO ||
@@ -182,19 +1582,28 @@ void readTemperature() {
             }
         }
 
-        if (cachedChamber.valid) {
+        if (cachedChamber.valid && !vchamber_active()) {
             if (state_lock()) {
                 g_tChamber = cachedChamber.value;
                 state_unlock();
             }
             LOG_FMT(LOG_LEVEL_WARN, "Using cached chamber temp: %.1f", cachedChamber.value);
         }
-    } else {
+    } else if (t1Valid) {
         sensorErrorCount = 0;
+        vchamber_release(tChamber);
         cachedChamber.value = tChamber;
         cachedChamber.timestamp = now;
         cachedChamber.valid = true;
         cachedChamber.readAttempts = 0;
+        TempEstimate est = estimator_update(EST_CHAMBER, tChamber, quantStep(vote.source), now);
+        // tau kompensacji należy do sondy głównej – identyfikacja i korekta tylko,
+        // gdy głosują wszystkie przypisane sondy i są zgodne
+        bool voteClean = vote.used == vote.assigned && !vote.disagree;
+        lagcomp_hold(EST_CHAMBER, !voteClean);
+        if (voteClean && chamberSensorIndex >= 0 && chamberSensorIndex < channelCount) {
+            lagcomp_update(EST_CHAMBER, channels[chamberSensorIndex].id, est, now);
+        }
 
         if (state_lock()) {
             g_tChamber = tChamber;
@@ -207,18 +1616,22 @@ void readTemperature() {
     }
 
     // Aktualizacja cache dla czujnika mięsa
-    if (!t2Valid) {
+    if (hasMeat && !t2Valid) {
         if (cachedMeat.valid) {
             if (state_lock()) {
                 g_tMeat = cachedMeat.value;
                 state_unlock();
             }
         }
-    } else {
+    } else if (t2Valid) {
         cachedMeat.value = tMeat;
         cachedMeat.timestamp = now;
         cachedMeat.valid = true;
         cachedMeat.readAttempts = 0;
+        TempEstimate est = estimator_update(EST_MEAT, tMeat, quantStep(PROBE_MEAT), now);
+        if (meatSensorIndex >= 0 && meatSensorIndex < channelCount) {
+            lagcomp_update(EST_MEAT, channels[meatSensorIndex].id, est, now);
+        }
 
         if (state_lock()) {
             g_tMeat = tMeat;
@@ -227,14 +1640,20 @@ void readTemperature() {
     }
 
     // Sprawdzenie przegrzania (BEZ auto-recovery - zgodnie z wymaganiem)
+    bool doorActive = false;
     if (state_lock()) {
         if (g_tChamber > CFG_T_MAX_SOFT) {
             g_errorOverheat = true;
             g_currentState = ProcessState::PAUSE_OVERHEAT;
             LOG_FMT(LOG_LEVEL_ERROR, "OVERHEAT detected: %.1f C", g_tChamber);
         }
+        doorActive = g_doorOpen ||
+                     g_currentState == ProcessState::PAUSE_DOOR ||
+                     g_currentState == ProcessState::SOFT_RESUME;
         state_unlock();
     }
+
+    if (t1Valid) updateResolutionPolicy(tChamber, now, doorActive);
 }
 
 void checkDoor() {
@@ -277,21 +1696,86 @@ unsigned long getSensorCacheAge() {
 }
 
 void forceSensorRead() {
-    lastTempRequest = 0;
-    lastTempReadPossible = 0;
+    unsigned long now = millis();
+    for (int i = 0; i < PROBE_COUNT; i++) {
+        probes[i].lastConvertMs = now - TEMP_REQUEST_INTERVAL;
+    }
 }
 
 String getSensorDiagnostics() {
-    char buffer[256];
-    snprintf(buffer, sizeof(buffer),
+    int ci = probeSensorIndex(PROBE_CHAMBER);
+    int mi = probeSensorIndex(PROBE_MEAT);
+    unsigned chamberRes = ci >= 0 ? sensorResolution[ci] : 0;
+    unsigned chamberTarget = ci >= 0 ? sensorTargetRes[ci] : 0;
+    unsigned meatRes = mi >= 0 ? sensorResolution[mi] : 0;
+    const ProbeQuality& qc = quality[PROBE_CHAMBER];
+    const ProbeQuality& qm = quality[PROBE_MEAT];
+
+    unsigned long searches = 0;
+    for (int bus = 0; bus < ONEWIRE_BUS_COUNT; bus++) searches += busStats[bus].searches;
+
+    char buffer[1280];
+    int offset = snprintf(buffer, sizeof(buffer),
         "Chamber: %.1f C (sensor: %d, age: %lus, valid: %d)\n"
         "Meat: %.1f C (sensor: %d, age: %lus, valid: %d)\n"
-        "Error count: %d, Identified: %s",
+        "Error count: %d, Identified: %s\n"
+        "Channels: %d (DS18B20: %d), searches: %lu, bg scans: %lu\n"
+        "Driver: %s\n"
+        "Resolution: chamber %u bit (target %u), meat %u bit, rate: %.3f C/s\n"
+        "Chamber quality: ok %lu, crc %lu, por %lu, disc %lu, range %lu, spikes %lu, bad %.1f%%%s\n"
+        "Meat quality: ok %lu, crc %lu, por %lu, disc %lu, range %lu, spikes %lu, bad %.1f%%%s",
         cachedChamber.value, chamberSensorIndex, getSensorCacheAge()/1000, cachedChamber.valid,
         cachedMeat.value, meatSensorIndex, cachedMeat.valid ? (millis() - cachedMeat.timestamp)/1000 : 0,
         cachedMeat.valid,
         sensorErrorCount,
-        sensorsIdentified ? "YES" : "NO");
+        sensorsIdentified ? "YES" : "NO",
+        channelCount, sensorTableCount, searches, bgScan.completed,
+        useRmt ? "RMT" : "bit-bang",
+        chamberRes, chamberTarget, meatRes, resPolicy.rate,
+        qc.goodReads, qc.crcErrors, qc.powerOnResets, qc.disconnects, qc.rangeErrors,
+        qc.spikesRejected, qc.errorRate * 100.0, qc.degraded ? " DEGRADED" : "",
+        qm.goodReads, qm.crcErrors, qm.powerOnResets, qm.disconnects, qm.rangeErrors,
+        qm.spikesRejected, qm.errorRate * 100.0, qm.degraded ? " DEGRADED" : "");
+
+    // Czas cyklu per magistrala: start konwersji → odczyt scratchpada
+    for (int bus = 0; bus < ONEWIRE_BUS_COUNT && offset < (int)sizeof(buffer); bus++) {
+        if (!busUsable(bus)) continue;
+        int onBus = 0;
+        for (int i = 0; i < sensorTableCount; i++) {
+            if (sensorBus[i] == bus) onBus++;
+        }
+        const BusStats& bs = busStats[bus];
+        offset += snprintf(buffer + offset, sizeof(buffer) - offset,
+            "\nBus %d (GPIO %d): sensors %d, cycle %lu ms (max %lu), wire %lu us/cycle, "
+            "transactions/cycle %lu, cycles %lu",
+            bus, onewirePins[bus], onBus, bs.lastCycleMs, bs.maxCycleMs, bs.lastCycleWireUs,
+            bs.lastCycleTransactions, bs.cycles);
+    }
+
+    int meatAssigned = 0, meatValid = 0;
+    for (int n = 0; n < MEAT_PROBES_MAX; n++) {
+        if (roleIndex(meatProbeRole(n)) < 0) continue;
+        meatAssigned++;
+        if (meatProbes[n].valid && millis() - meatProbes[n].timestamp <= MEAT_MAX_AGE_MS) meatValid++;
+    }
+    if (meatAssigned > 1 && offset < (int)sizeof(buffer)) {
+        offset += snprintf(buffer + offset, sizeof(buffer) - offset,
+            "\nMeat probes: %d/%d reading (extra every %lu s)", meatValid, meatAssigned,
+            MEAT_PROBE_INTERVAL_MS / 1000);
+    }
+    if (ambientSensorIndex >= 0 && offset < (int)sizeof(buffer)) {
+        bool fresh = ambientProbe.valid && millis() - ambientProbe.timestamp <= AMBIENT_MAX_AGE_MS;
+        offset += snprintf(buffer + offset, sizeof(buffer) - offset,
+            "\nAmbient: %.1f C (sensor: %d, valid: %d)", fresh ? ambientProbe.value : 0.0,
+            ambientSensorIndex, fresh);
+    }
+
+    if (vote.assigned > 1 && offset < (int)sizeof(buffer)) {
+        snprintf(buffer + offset, sizeof(buffer) - offset,
+            "\nChamber vote: %d/%d probes (backup %d, %d), disagreements %lu, failovers %lu%s",
+            vote.used, vote.assigned, chamberBackupIndex[0], chamberBackupIndex[1],
+            vote.disagreements, vote.failovers, vote.disagree ? " DISAGREE" : "");
+    }
     return String(buffer);
 }
 
@@ -300,13 +1784,13 @@ String getSensorAssignmentInfo() {
     char buffer[128];
     snprintf(buffer, sizeof(buffer),
         "Sensor Assignments:\n  Chamber: Sensor %d\n  Meat: Sensor %d\n  Total sensors: %d\n  Identified: %s",
-        chamberSensorIndex, meatSensorIndex, sensors.getDeviceCount(),
+        chamberSensorIndex, meatSensorIndex, channelCount,
         sensorsIdentified ? "YES" : "NO");
     return String(buffer);
 }
 
 bool autoDetectAndAssignSensors() {
-    int deviceCount = sensors.getDeviceCount();
+    int deviceCount = rebuildSensorTable();
     if (deviceCount < 2) {
         log_msg(LOG_LEVEL_ERROR, "Need at least 2 sensors for auto-detection");
         return false;
@@ -314,6 +1798,7 @@ bool autoDetectAndAssignSensors() {
 
     sensorsIdentified = false;
     identifyAndAssignSensors();
+    estimator_reset();
 
     return sensorsIdentified;
 }
@@ -331,7 +1816,197 @@ int getMeatSensorIndex() {
 }
 
 int getTotalSensorCount() {
-    return sensors.getDeviceCount();
+    return channelCount;
+}
+
+int getDs18b20Count() {
+    return sensorTableCount;
+}
+
+// Lista kanałów dla /api/sensors: indeks, backend, identyfikator
+String getSensorChannelsJson() {
+    char json[64 + MAX_CHANNELS * 112];
+    int offset = snprintf(json, sizeof(json), "[");
+    for (int i = 0; i < channelCount; i++) {
+        char idStr[24];
+        formatChannelId(channels[i].id, idStr, sizeof(idStr));
+        // Magistrala OneWire tylko dla DS18B20; termopary = -1
+        int bus = (channels[i].backend == SensorBackend::DS18B20) ? sensorBus[channels[i].slot] : -1;
+        offset += snprintf(json + offset, sizeof(json) - offset,
+                           "%s{\"index\":%d,\"type\":\"%s\",\"id\":\"%s\",\"bus\":%d,"
+                           "\"gain\":%.4f,\"offset\":%.2f}",
+                           i ? "," : "", i, sensorBackendName(channels[i].backend), idStr, bus,
+                           channelCal[i].gain, channelCal[i].offset);
+    }
+    snprintf(json + offset, sizeof(json) - offset, "]");
+    return String(json);
+}
+
+// Analizator magistrali dla /api/sensors/bus
+static int histJson(char* out, size_t len, const uint32_t* hist) {
+    return snprintf(out, len, "[%lu,%lu,%lu,%lu,%lu,%lu]",
+                    (unsigned long)hist[0], (unsigned long)hist[1], (unsigned long)hist[2],
+                    (unsigned long)hist[3], (unsigned long)hist[4], (unsigned long)hist[5]);
+}
+
+static int lineJson(char* out, size_t len, const LineDiag& ld) {
+    char presence[80], rise[80];
+    histJson(presence, sizeof(presence), ld.presenceHist);
+    histJson(rise, sizeof(rise), ld.riseHist);
+    return snprintf(out, len,
+        "\"transactions\":%lu,\"presenceFail\":%lu,\"timeouts\":%lu,\"crc\":%lu,\"noData\":%lu,"
+        "\"retries\":%lu,\"errorRate\":%.2f,\"presenceGapUs\":[%u,%u],\"presenceWidthHist\":%s,"
+        "\"riseMaxUs\":%u,\"zeroLowMinUs\":%u,\"riseHist\":%s",
+        ld.transactions, ld.presenceFailures, ld.timeouts, ld.crcErrors, ld.noData, ld.retries,
+        ld.transactions ? lineErrors(ld) * 100.0 / ld.transactions : 0.0,
+        ld.presenceGapMin, ld.presenceGapMax, presence, ld.riseMax, ld.zeroLowMin, rise);
+}
+
+String getSensorBusJson() {
+    char buf[640];
+    snprintf(buf, sizeof(buf),
+        "{\"enabled\":%s,\"sinceSec\":%lu,\"rmt\":%s,\"riseWarnUs\":%u,"
+        "\"presenceWidthEdges\":[%u,%u,%u,%u,%u],\"riseEdges\":[%u,%u,%u,%u,%u],\"buses\":[",
+        analyzer.enabled ? "true" : "false", (millis() - analyzer.sinceMs) / 1000, useRmt ? "true" : "false",
+        BUS_RISE_WARN_US, presenceWidthEdges[0], presenceWidthEdges[1], presenceWidthEdges[2],
+        presenceWidthEdges[3], presenceWidthEdges[4], riseEdges[0], riseEdges[1], riseEdges[2],
+        riseEdges[3], riseEdges[4]);
+    String json = buf;
+
+    for (int bus = 0; bus < ONEWIRE_BUS_COUNT; bus++) {
+        // Werdykt: ile sond magistrali ma błędy i czy zbocza są wolne
+        int devices = 0, bad = 0, badIdx = -1;
+        for (int i = 0; i < MAX_SENSORS; i++) {
+            const DeviceDiag& dd = analyzer.devices[i];
+            if (!dd.used || dd.line.transactions == 0) continue;
+            int idx = -1;
+            for (int j = 0; j < sensorTableCount; j++) {
+                if (memcmp(dd.rom, sensorAddresses[j], 8) == 0) idx = j;
+            }
+            if (idx < 0 || sensorBus[idx] != bus) continue;
+            devices++;
+            if (lineErrors(dd.line) > BUS_ERROR_RATE_WARN * dd.line.transactions) {
+                bad++;
+                badIdx = idx;
+            }
+        }
+        const LineDiag& ld = analyzer.bus[bus];
+        bool slowEdges = ld.riseMax >= BUS_RISE_WARN_US;
+        const char* verdict;
+        if (ld.transactions == 0) verdict = "idle";
+        else if (bad == 0) verdict = slowEdges ? "marginal" : "ok";
+        else if (bad == 1 && devices > 1 && !slowEdges) verdict = "probe";
+        else if (bad == 1 && devices == 1) verdict = "probe_or_cable";
+        else verdict = "cable";
+
+        const BusStats& bs = busStats[bus];
+        int n = snprintf(buf, sizeof(buf),
+            "%s{\"bus\":%d,\"gpio\":%d,\"active\":%s,\"verdict\":\"%s\",\"suspect\":%d,\"devices\":%d,"
+            "\"cycleMs\":%lu,\"maxCycleMs\":%lu,\"wireUs\":%lu,",
+            bus ? "," : "", bus, onewirePins[bus], busUsable(bus) ? "true" : "false", verdict,
+            (bad == 1) ? badIdx : -1, devices, bs.lastCycleMs, bs.maxCycleMs, bs.lastCycleWireUs);
+        lineJson(buf + n, sizeof(buf) - n, ld);
+        json += buf;
+        json += "}";
+    }
+
+    json += "],\"devices\":[";
+    bool first = true;
+    for (int i = 0; i < MAX_SENSORS; i++) {
+        const DeviceDiag& dd = analyzer.devices[i];
+        if (!dd.used) continue;
+        int idx = -1;
+        for (int j = 0; j < sensorTableCount; j++) {
+            if (memcmp(dd.rom, sensorAddresses[j], 8) == 0) idx = j;
+        }
+        const char* role = "";
+        for (int r = 0; r < PROBE_COUNT && idx >= 0; r++) {
+            if (probeSensorIndex(r) == idx) role = roleName(r);
+        }
+        char idStr[24];
+        formatChannelId(dd.rom, idStr, sizeof(idStr));
+        int n = snprintf(buf, sizeof(buf), "%s{\"id\":\"%s\",\"index\":%d,\"bus\":%d,\"role\":\"%s\",",
+                         first ? "" : ",", idStr, idx, idx >= 0 ? sensorBus[idx] : -1, role);
+        lineJson(buf + n, sizeof(buf) - n, dd.line);
+        json += buf;
+        json += "}";
+        first = false;
+    }
+    json += "]}";
+    return json;
+}
+
+void setBusAnalyzerEnabled(bool enabled) {
+    analyzer.enabled = enabled;
+    LOG_FMT(LOG_LEVEL_INFO, "OneWire bus analyzer %s", enabled ? "enabled" : "disabled");
+}
+
+void resetBusAnalyzer() {
+    analyzer.resetRequested = true;
+}
+
+// Głosowanie sond komory dla /api/sensors: stan każdej sondy i statystyki
+String getSensorVoteJson() {
+    char json[160 + CHAMBER_PROBES_MAX * 176];
+    int offset = snprintf(json, sizeof(json),
+        "{\"used\":%d,\"assigned\":%d,\"disagree\":%s,\"votes\":%lu,"
+        "\"disagreements\":%lu,\"failovers\":%lu,\"limit\":%.1f,\"members\":[",
+        vote.used, vote.assigned, vote.disagree ? "true" : "false", vote.votes,
+        vote.disagreements, vote.failovers, VOTE_DISAGREE_LIMIT);
+    unsigned long now = millis();
+    for (int m = 0; m < CHAMBER_PROBES_MAX; m++) {
+        int role = chamberRoles[m];
+        const VoteMember& vm = vote.members[m];
+        const ProbeQuality& q = quality[role];
+        bool fresh = vm.valid && now - vm.timestamp <= VOTE_MAX_AGE_MS;
+        offset += snprintf(json + offset, sizeof(json) - offset,
+            "%s{\"role\":\"%s\",\"index\":%d,\"value\":%.2f,\"voting\":%s,\"outlier\":%s,"
+            "\"outliers\":%lu,\"good\":%lu,\"errorRate\":%.1f,\"degraded\":%s}",
+            m ? "," : "", roleName(role), roleIndex(role), fresh ? vm.value : 0.0,
+            (fresh && roleIndex(role) >= 0) ? "true" : "false", vm.outlier ? "true" : "false",
+            vm.outliers, q.goodReads, q.errorRate * 100.0, q.degraded ? "true" : "false");
+    }
+    snprintf(json + offset, sizeof(json) - offset, "]}");
+    return String(json);
+}
+
+void getChamberVoteSummary(int& used, int& assigned, bool& disagree) {
+    used = vote.used;
+    assigned = vote.assigned;
+    disagree = vote.disagree;
+}
+
+// Sondy mięsa dla /api/sensors: wartość, wiek i jakość każdej przypisanej sondy
+String getMeatProbesJson() {
+    char json[32 + MEAT_PROBES_MAX * 128];
+    int offset = snprintf(json, sizeof(json), "[");
+    unsigned long now = millis();
+    for (int n = 0; n < MEAT_PROBES_MAX; n++) {
+        int role = meatProbeRole(n);
+        const MeatProbe& mp = meatProbes[n];
+        const ProbeQuality& q = quality[role];
+        bool fresh = mp.valid && now - mp.timestamp <= MEAT_MAX_AGE_MS;
+        offset += snprintf(json + offset, sizeof(json) - offset,
+            "%s{\"probe\":%d,\"index\":%d,\"value\":%.2f,\"valid\":%s,\"age\":%lu,"
+            "\"good\":%lu,\"errorRate\":%.1f,\"degraded\":%s}",
+            n ? "," : "", n + 1, roleIndex(role), fresh ? mp.value : 0.0, fresh ? "true" : "false",
+            mp.timestamp ? (now - mp.timestamp) / 1000 : 0, q.goodReads, q.errorRate * 100.0,
+            q.degraded ? "true" : "false");
+    }
+    snprintf(json + offset, sizeof(json) - offset, "]");
+    return String(json);
+}
+
+int getMeatProbeIndex(int n) {
+    return (n >= 0 && n < MEAT_PROBES_MAX) ? roleIndex(meatProbeRole(n)) : -1;
+}
+
+int getAmbientProbeIndex() {
+    return ambientSensorIndex;
+}
+
+int getChamberBackupIndex(int n) {
+    return (n >= 0 && n < CHAMBER_PROBES_MAX - 1) ? chamberBackupIndex[n] : -1;
 }
 
 bool areSensorsIdentified() {
@@ -1,17 +1,45 @@
 // sensors.h - Zmodernizowana wersja z funkcjami przypisywania
 #pragma once
 #include <Arduino.h>
+#include "config.h"
 
 // Podstawowe funkcje
-void requestTemperature();
-void readTemperature();
+void initSensorDriver();      // przejęcie magistrali przez RMT (CFG_ONEWIRE_USE_RMT)
+bool isSensorDriverRmt();     // sterownik faktycznie użyty (po ewentualnym powrocie do bit-bang)
+void serviceSensors();        // krok harmonogramu wszystkich sterowników (co obieg tasku)
 void checkDoor();
 
 // Funkcje przypisywania czujników
 void identifyAndAssignSensors();
 void reassignSensors(int newChamberIndex, int newMeatIndex);
+// Zmiana przypisań ról (web server): walidacja całości od razu, zastosowanie
+// w tasku czujników; false = nieprawidłowe indeksy, nic nie zmienione
+struct SensorAssignment {
+    int chamber;
+    int meat;
+    bool setBackups;                       // sondy zapasowe komory, -1 = brak
+    int backup[CHAMBER_PROBES_MAX - 1];
+    bool setMeatExtra;                     // dodatkowe sondy mięsa (MEAT2..), -1 = brak
+    int meatExtra[MEAT_PROBES_MAX - 1];
+    bool setAmbient;                       // sonda otoczenia, -1 = brak
+    int ambient;
+};
+bool requestSensorAssignment(const SensorAssignment& req);
 bool autoDetectAndAssignSensors();
 
+// Tablica kanałów (DS18B20 + termopary) – wypełniana przy starcie i przy ponownym skanowaniu
+int rebuildSensorTable();
+void requestSensorRescan();   // skan wykona task czujników (bez wyścigu na magistrali)
+void logSensorBusTiming();
+// Analizator magistrali OneWire (/api/sensors/bus)
+String getSensorBusJson();
+void setBusAnalyzerEnabled(bool enabled);
+void resetBusAnalyzer();     // zerowanie wykona task czujników
+// Kalibracja czujnika przypisanego do roli (PROBE_CHAMBER / PROBE_MEAT / PROBE_CHAMBER2/3)
+bool startSensorCalibration(int role);
+bool clearSensorCalibration(int role);
+void requestSensorCalReload();
+
 // Funkcje diagnostyczne
 unsigned long getSensorCacheAge();
 void forceSensorRead();
@@ -22,10 +50,18 @@ String getSensorAssignmentInfo();
 int getChamberSensorIndex();
 int getMeatSensorIndex();
 int getTotalSensorCount();
+int getDs18b20Count();
+String getSensorChannelsJson();
+String getSensorVoteJson();
+void getChamberVoteSummary(int& used, int& assigned, bool& disagree);
+int getChamberBackupIndex(int n);
+String getMeatProbesJson();
+int getMeatProbeIndex(int n);               // n = 0 (główna) .. MEAT_PROBES_MAX-1
+int getAmbientProbeIndex();
 bool areSensorsIdentified();
 
 // Funkcje do zmiennych globalnych (jeśli potrzebne bezpośrednio)
-extern uint8_t sensorAddresses[2][8];
+extern uint8_t sensorAddresses[MAX_SENSORS][8];
 extern int chamberSensorIndex;     // Dodajemy extern
 extern int meatSensorIndex;        // Dodajemy extern
 extern bool sensorsIdentified;     // Dodajemy extern
\ No newline at end of file
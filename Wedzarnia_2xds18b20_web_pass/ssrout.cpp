@@ -0,0 +1,269 @@
+// ssrout.cpp - Burst-fire / okno czasowe SSR: takt połówek z detektora zera lub timera
+#include "ssrout.h"
+#include "config.h"
+#include <driver/gpio.h>
+
+static const int ssrPins[SSR_CHANNELS] = {PIN_SSR1, PIN_SSR2, PIN_SSR3};
+
+// Stan taktu – zmieniany tylko w przerwaniach (pod ssrMux)
+static portMUX_TYPE ssrMux = portMUX_INITIALIZER_UNLOCKED;
+static uint16_t acc[SSR_CHANNELS];
+static bool pinOn[SSR_CHANNELS];
+static uint16_t windowOn[SSR_CHANNELS];
+static uint16_t windowCount = 0;
+static SsrMode mode = SsrMode::BURST;
+// Okno czasowe (WINDOW) w połówkach: długość, pozycja, zatrzaśnięte fazy
+static uint16_t winLen = SSR_WINDOW_DEFAULT_MS * 1000UL / SSR_HALF_CYCLE_US;
+static uint16_t winPos = 0;
+static uint16_t winStart[SSR_CHANNELS];
+static uint16_t winOnLen[SSR_CHANNELS];
+static uint32_t winRem[SSR_CHANNELS];          // reszta [promile * połówki] na kolejne okno
+// Równoczesne przewodzenie: histogram liczby załączonych kanałów w połówce
+static uint32_t concHist[SSR_CHANNELS + 1];
+static uint8_t concPeak = 0;
+static uint32_t stackedStarts = 0;             // połówki z załączeniem >1 kanału naraz
+
+// Zadane wypełnienie [promile] – zapis 16-bit atomowy, bez blokady
+static volatile uint16_t dutyPm[SSR_CHANNELS];
+// Moc oddana w ostatnim pełnym oknie pomiaru [promile]
+static volatile uint16_t deliveredPm[SSR_CHANNELS];
+
+static volatile uint32_t halfCycles = 0;
+static volatile uint32_t zcEdges = 0;
+static volatile uint32_t zcRejected = 0;
+static volatile uint32_t zcLossCount = 0;
+static volatile unsigned long lastZcUs = 0;
+static volatile unsigned long zcPeriodUs = SSR_HALF_CYCLE_US;   // wygładzony okres połówki
+static volatile bool zcActive = false;
+
+static hw_timer_t* ssrTimer = nullptr;
+static bool started = false;
+
+static void IRAM_ATTR setPin(int ch, bool on) {
+    if (pinOn[ch] == on) return;
+    pinOn[ch] = on;
+    gpio_set_level((gpio_num_t)ssrPins[ch], on ? 1 : 0);
+}
+
+// Fazy startowe: akumulatory BURST przesunięte o 1/SSR_CHANNELS, okno od początku
+static void resetPhases() {
+    for (int ch = 0; ch < SSR_CHANNELS; ch++) {
+        acc[ch] = (uint16_t)(ch * SSR_DUTY_FULL / SSR_CHANNELS);
+        winRem[ch] = 0;
+        winOnLen[ch] = 0;
+        winStart[ch] = 0;
+        windowOn[ch] = 0;
+    }
+    winPos = 0;
+    windowCount = 0;
+}
+
+static bool IRAM_ATTR burstOn(int ch) {
+    acc[ch] += dutyPm[ch];
+    if (acc[ch] < SSR_DUTY_FULL) return false;
+    acc[ch] -= SSR_DUTY_FULL;
+    return true;
+}
+
+// Początek okna: czasy załączenia z reszty poprzedniego okna, fazy kolejno po sobie
+static void IRAM_ATTR latchWindow() {
+    uint32_t sumDuty = 0, total = 0;
+    for (int ch = 0; ch < SSR_CHANNELS; ch++) {
+        sumDuty += dutyPm[ch];
+        winRem[ch] += (uint32_t)dutyPm[ch] * winLen;
+        winOnLen[ch] = winRem[ch] / SSR_DUTY_FULL;
+        winRem[ch] -= (uint32_t)winOnLen[ch] * SSR_DUTY_FULL;
+        total += winOnLen[ch];
+    }
+    // Suma <= 100 %: reszty nie mogą wymusić nakładania – nadmiar wraca do reszty
+    for (int ch = SSR_CHANNELS - 1; sumDuty <= SSR_DUTY_FULL && total > winLen && ch >= 0; ch--) {
+        uint32_t cut = min((uint32_t)winOnLen[ch], total - winLen);
+        winOnLen[ch] -= cut;
+        winRem[ch] += cut * SSR_DUTY_FULL;
+        total -= cut;
+    }
+    uint16_t start = 0;
+    for (int ch = 0; ch < SSR_CHANNELS; ch++) {
+        winStart[ch] = start;
+        start = (start + winOnLen[ch]) % winLen;
+    }
+}
+
+static bool IRAM_ATTR windowOnAt(int ch) {
+    return (uint16_t)((winPos + winLen - winStart[ch]) % winLen) < winOnLen[ch];
+}
+
+static void IRAM_ATTR halfCycleTick() {
+    portENTER_CRITICAL_ISR(&ssrMux);
+    halfCycles++;
+    if (mode == SsrMode::WINDOW && winPos == 0) latchWindow();
+    uint8_t active = 0, starts = 0;
+    for (int ch = 0; ch < SSR_CHANNELS; ch++) {
+        bool on = (mode == SsrMode::WINDOW) ? windowOnAt(ch) : burstOn(ch);
+        if (on) {
+            windowOn[ch]++;
+            active++;
+            if (!pinOn[ch]) starts++;
+        }
+        setPin(ch, on);
+    }
+    if (mode == SsrMode::WINDOW && ++winPos >= winLen) winPos = 0;
+    concHist[active]++;
+    if (active > concPeak) concPeak = active;
+    if (starts > 1) stackedStarts++;
+    // Pomiar mocy oddanej: w trybie WINDOW na pełnych oknach
+    uint16_t measLen = (mode == SsrMode::WINDOW) ? winLen : SSR_WINDOW_HALF_CYCLES;
+    if (++windowCount >= measLen) {
+        for (int ch = 0; ch < SSR_CHANNELS; ch++) {
+            deliveredPm[ch] = (uint32_t)windowOn[ch] * SSR_DUTY_FULL / windowCount;
+            windowOn[ch] = 0;
+        }
+        windowCount = 0;
+    }
+    portEXIT_CRITICAL_ISR(&ssrMux);
+}
+
+static void IRAM_ATTR onZeroCross() {
+    unsigned long now = micros();
+    unsigned long gap = now - lastZcUs;
+    if (gap < SSR_ZC_MIN_GAP_US) {
+        zcRejected++;                  // zakłócenie / drugie zbocze impulsu detektora
+        return;
+    }
+    lastZcUs = now;
+    zcEdges++;
+    if (gap < SSR_HALF_CYCLE_US * 3 / 2) {
+        zcPeriodUs = zcPeriodUs + ((long)gap - (long)zcPeriodUs) / 16;
+    }
+    zcActive = true;
+    halfCycleTick();
+}
+
+// Podstawa czasu: bez detektora zawsze, z detektorem – dopiero po zaniku zboczy
+static void IRAM_ATTR onTimer() {
+    if (zcActive) {
+        if (micros() - lastZcUs < SSR_ZC_LOSS_HALF_CYCLES * SSR_HALF_CYCLE_US) return;
+        zcActive = false;
+        zcLossCount++;
+    }
+    halfCycleTick();
+}
+
+void ssrout_begin() {
+    for (int ch = 0; ch < SSR_CHANNELS; ch++) {
+        dutyPm[ch] = 0;
+        pinOn[ch] = false;
+        digitalWrite(ssrPins[ch], LOW);
+    }
+    resetPhases();
+
+    if (PIN_ZERO_CROSS >= 0) {
+        pinMode(PIN_ZERO_CROSS, INPUT);
+        attachInterrupt(digitalPinToInterrupt(PIN_ZERO_CROSS), onZeroCross, RISING);
+    }
+
+    ssrTimer = timerBegin(1000000);
+    if (ssrTimer == nullptr) {
+        log_msg(LOG_LEVEL_ERROR, "SSR burst timer init failed!");
+    } else {
+        timerAttachInterrupt(ssrTimer, &onTimer);
+        timerAlarm(ssrTimer, SSR_HALF_CYCLE_US, true, 0);
+    }
+    started = true;
+
+    LOG_FMT(LOG_LEVEL_INFO, "SSR burst-fire initialized (%s, %d Hz)",
+            PIN_ZERO_CROSS >= 0 ? "zero-cross input" : "timer time base", CFG_MAINS_HZ);
+}
+
+void ssrout_setMode(SsrMode newMode, unsigned long windowMs) {
+    windowMs = constrain(windowMs, SSR_WINDOW_MIN_MS, SSR_WINDOW_MAX_MS);
+    uint16_t len = (uint16_t)(windowMs * 1000UL / SSR_HALF_CYCLE_US);
+    if (newMode == mode && len == winLen) return;
+
+    portENTER_CRITICAL(&ssrMux);
+    mode = newMode;
+    winLen = len;
+    resetPhases();
+    portEXIT_CRITICAL(&ssrMux);
+
+    LOG_FMT(LOG_LEVEL_INFO, "SSR mode: %s (window %lu ms = %u half-cycles)",
+            newMode == SsrMode::WINDOW ? "window" : "burst", windowMs, (unsigned)len);
+}
+
+void ssrout_setDuty(int channel, double percent) {
+    if (channel < 0 || channel >= SSR_CHANNELS) return;
+    dutyPm[channel] = (uint16_t)lround(constrain(percent, 0.0, 100.0) * SSR_DUTY_FULL / 100.0);
+}
+
+void ssrout_allOff() {
+    portENTER_CRITICAL(&ssrMux);
+    for (int ch = 0; ch < SSR_CHANNELS; ch++) {
+        dutyPm[ch] = 0;
+        pinOn[ch] = false;
+        gpio_set_level((gpio_num_t)ssrPins[ch], 0);
+    }
+    resetPhases();
+    portEXIT_CRITICAL(&ssrMux);
+}
+
+bool ssrout_zeroCrossActive() {
+    return zcActive;
+}
+
+void ssrout_resetStats() {
+    portENTER_CRITICAL(&ssrMux);
+    for (int i = 0; i <= SSR_CHANNELS; i++) concHist[i] = 0;
+    concPeak = 0;
+    stackedStarts = 0;
+    portEXIT_CRITICAL(&ssrMux);
+}
+
+String ssrout_getStatusJSON() {
+    if (!CFG_SSR_BURST || !started) {
+        return "{\"mode\":\"pwm\"}";
+    }
+    bool zc = zcActive;
+    unsigned long period = zcPeriodUs;
+    double hz = (zc && period > 0) ? 500000.0 / period : (double)CFG_MAINS_HZ;
+
+    // Migawka statystyk; minimum = ceil(suma wypełnień) – lepiej się nie da
+    uint32_t hist[SSR_CHANNELS + 1];
+    uint32_t total = 0, sumDuty = 0;
+    portENTER_CRITICAL(&ssrMux);
+    for (int i = 0; i <= SSR_CHANNELS; i++) hist[i] = concHist[i];
+    uint8_t peak = concPeak;
+    uint32_t stacked = stackedStarts;
+    SsrMode m = mode;
+    uint16_t len = winLen;
+    portEXIT_CRITICAL(&ssrMux);
+    double avg = 0.0;
+    for (int i = 0; i <= SSR_CHANNELS; i++) {
+        total += hist[i];
+        avg += (double)i * hist[i];
+    }
+    if (total > 0) avg /= total;
+    for (int ch = 0; ch < SSR_CHANNELS; ch++) sumDuty += dutyPm[ch];
+    int minPeak = (sumDuty + SSR_DUTY_FULL - 1) / SSR_DUTY_FULL;
+
+    char buf[768];
+    int n = snprintf(buf, sizeof(buf),
+        "{\"mode\":\"%s\",\"windowMs\":%lu,\"source\":\"%s\",\"zcPin\":%d,\"mainsHz\":%.2f,"
+        "\"halfCycles\":%lu,\"zcEdges\":%lu,\"zcRejected\":%lu,\"zcLoss\":%lu,"
+        "\"concurrency\":{\"peak\":%u,\"minPossible\":%d,\"avg\":%.2f,\"stackedStarts\":%lu,\"hist\":[",
+        m == SsrMode::WINDOW ? "window" : "burst", (unsigned long)len * SSR_HALF_CYCLE_US / 1000UL,
+        zc ? "zc" : "timer", PIN_ZERO_CROSS, hz,
+        (unsigned long)halfCycles, (unsigned long)zcEdges,
+        (unsigned long)zcRejected, (unsigned long)zcLossCount,
+        (unsigned)peak, minPeak, avg, (unsigned long)stacked);
+    for (int i = 0; i <= SSR_CHANNELS && n < (int)sizeof(buf); i++) {
+        n += snprintf(buf + n, sizeof(buf) - n, "%s%.1f", i ? "," : "",
+                      total ? hist[i] * 100.0 / total : 0.0);
+    }
+    if (n < (int)sizeof(buf)) n += snprintf(buf + n, sizeof(buf) - n, "]},\"channels\":[");
+    for (int ch = 0; ch < SSR_CHANNELS && n < (int)sizeof(buf); ch++) {
+        n += snprintf(buf + n, sizeof(buf) - n, "%s{\"set\":%.1f,\"delivered\":%.1f}",
+                      ch ? "," : "", dutyPm[ch] * 100.0 / SSR_DUTY_FULL, deliveredPm[ch] * 100.0 / SSR_DUTY_FULL);
+    }
+    if (n < (int)sizeof(buf)) snprintf(buf + n, sizeof(buf) - n, "]}");
+    return String(buf);
+}
@@ -0,0 +1,32 @@
+// ssrout.h - Pakietowe sterowanie SSR grzałek (całe połówki sieci)
+// Takt: przerwanie z detektora zera (PIN_ZERO_CROSS) lub – bez detektora albo
+// po zaniku zboczy – timer sprzętowy co SSR_HALF_CYCLE_US. SSR z przełączaniem
+// w zerze sam dosynchronizuje się do sieci: N taktów stanu wysokiego = N połówek.
+// Tryby (SsrMode):
+//  BURST  – każda połówka: akumulator kanału += wypełnienie [promile],
+//           przepełnienie = połówka załączona (Bresenham, równomiernie);
+//           akumulatory startują przesunięte o 1/3, więc równe wypełnienia
+//           nie trafiają w te same połówki.
+//  WINDOW – okno g_ssrWindowMs: czas załączenia kanału = wypełnienie * okno
+//           (reszta przenoszona na kolejne okno), fazy ułożone kolejno
+//           SSR1 -> SSR2 -> SSR3 z zawinięciem; równocześnie przewodzi
+//           najwyżej ceil(suma wypełnień) grzałek.
+// Moc oddana liniowa względem wypełnienia z dokładnością 1 połówki na okno.
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+constexpr int SSR_CHANNELS = 3;
+
+void ssrout_begin();
+// Tryb i długość okna (WINDOW); bez zmian = bez efektu – wołane co obieg
+void ssrout_setMode(SsrMode mode, unsigned long windowMs);
+// Wypełnienie kanału 0..SSR_CHANNELS-1 [%]; stosowane od najbliższej połówki
+void ssrout_setDuty(int channel, double percent);
+// Natychmiastowe wyłączenie wszystkich kanałów (wypełnienie 0, piny LOW)
+void ssrout_allOff();
+// true = takt z detektora zera, false = podstawa czasu z timera
+bool ssrout_zeroCrossActive();
+// Zerowanie statystyk równoczesnego przewodzenia
+void ssrout_resetStats();
+String ssrout_getStatusJSON();
@@ -9,7 +9,9 @@ DallasTemperature sensors(&oneWire);
 
 double pidInput, pidSetpoint;
 double pidOutput = 0;
-PID pid(&pidInput, &pidOutput, &pidSetpoint, CFG_Kp, CFG_Ki, CFG_Kd, DIRECT);
+double pidFeedback = 0;
+double pidFeedforward = 0;
+PID pid(&pidInput, &pidFeedback, &pidSetpoint, CFG_Kp, CFG_Ki, CFG_Kd, DIRECT);
 
 SemaphoreHandle_t stateMutex = NULL;
 SemaphoreHandle_t outputMutex = NULL;
@@ -24,10 +26,33 @@ volatile double g_tMeat = 25.0;
 volatile int g_powerMode = 1;
 volatile int g_manualSmokePwm = 0;
 volatile int g_fanMode = 1;
+volatile PidInputSource g_pidInputSource = PidInputSource::FILTERED;
+volatile ControlEngine g_controlEngine = ControlEngine::PID;
+volatile SsrMode g_ssrMode = SsrMode::BURST;
+volatile unsigned long g_ssrWindowMs = SSR_WINDOW_DEFAULT_MS;
 volatile unsigned long g_fanOnTime = CFG_FAN_ON_DEFAULT_MS;
 volatile unsigned long g_fanOffTime = CFG_FAN_OFF_DEFAULT_MS;
 volatile bool g_doorOpen = false;
 volatile bool g_errorSensor = false;
+volatile bool g_chamberVirtual = false;
+volatile double g_tMeatProbes[MEAT_PROBES_MAX];
+volatile uint16_t g_meatProbeMask = 0x01;
+volatile double g_tAmbient = NAN;
+volatile bool g_stallDetected = false;
+volatile bool g_ffEnabled = true;
+volatile double g_ffLossCoeff = 0.0;
+PidGains g_pidGains[CFG_POWERMODE_MAX] = {
+    {CFG_Kp, CFG_Ki, CFG_Kd, false},
+    {CFG_Kp, CFG_Ki, CFG_Kd, false},
+    {CFG_Kp, CFG_Ki, CFG_Kd, false}
+};
+double g_heaterRuntimeSec[HEATER_COUNT] = {0.0, 0.0, 0.0};
+volatile double g_heaterPower = 0.0;
+PowerBudget g_powerBudget = {
+    {POWER_HEATER_W_DEFAULT, POWER_HEATER_W_DEFAULT, POWER_HEATER_W_DEFAULT},
+    POWER_SMOKE_W_DEFAULT, POWER_LIMIT_W_DEFAULT, true
+};
+PidGains g_gainSchedule[CFG_POWERMODE_MAX][GS_BANDS] = {};
 volatile bool g_errorOverheat = false;
 volatile bool g_errorProfile = false;
 
@@ -38,7 +63,7 @@ unsigned long g_processStartTime = 0;
 unsigned long g_stepStartTime = 0;
 
 // Statystyki procesu
-ProcessStats g_processStats = {0, 0, 0, 0, 0.0, 0, 0, 0};
+ProcessStats g_processStats = {0, 0, 0, 0, 0.0, 0, 0, 0, -1, false};
 
 // Funkcje blokowania z timeoutami
 bool state_lock(TickType_t timeout_ms) {
@@ -102,6 +127,8 @@ void init_state() {
     g_processStats.pauseCount = 0;
     g_processStats.avgTemp = 0.0;
     g_processStats.lastUpdate = millis();
+
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) g_tMeatProbes[i] = NAN;
     
     log_msg(LOG_LEVEL_INFO, "State initialized successfully");
 }
@@ -16,8 +16,10 @@ extern SemaphoreHandle_t stateMutex;
 extern SemaphoreHandle_t outputMutex;
 extern SemaphoreHandle_t heaterMutex;
 
-// PID output
+// PID output = część regulatora (pidFeedback) + feedforward strat ciepła
 extern double pidOutput;
+extern double pidFeedback;
+extern double pidFeedforward;
 extern double pidInput;
 extern double pidSetpoint;
 
@@ -30,10 +32,26 @@ extern volatile double g_tMeat;
 extern volatile int g_powerMode;
 extern volatile int g_manualSmokePwm;
 extern volatile int g_fanMode;
+extern volatile PidInputSource g_pidInputSource;
+extern volatile ControlEngine g_controlEngine;
+extern volatile SsrMode g_ssrMode;
+extern volatile unsigned long g_ssrWindowMs;
 extern volatile unsigned long g_fanOnTime;
 extern volatile unsigned long g_fanOffTime;
 extern volatile bool g_doorOpen;
 extern volatile bool g_errorSensor;
+extern volatile bool g_chamberVirtual;     // g_tChamber z modelu (sonda komory utracona)
+extern volatile double g_tMeatProbes[MEAT_PROBES_MAX];  // NAN = brak świeżego odczytu
+extern volatile uint16_t g_meatProbeMask;  // bit n = sonda mięsa n przypisana
+extern volatile double g_tAmbient;         // NAN = brak sondy otoczenia / nieświeży odczyt
+extern volatile bool g_stallDetected;      // plateau mięsa w bieżącym kroku
+extern volatile bool g_ffEnabled;          // feedforward strat ciepła (NVS)
+extern volatile double g_ffLossCoeff;      // straty [grzałka/C], 0 = nienauczone (NVS)
+extern PidGains g_pidGains[CFG_POWERMODE_MAX];  // indeks = tryb mocy - 1 (NVS)
+extern double g_heaterRuntimeSec[HEATER_COUNT];  // czas pracy grzałek przy 100 % [s] (NVS)
+extern PowerBudget g_powerBudget;
+extern volatile double g_heaterPower;      // moc oddana przez SSR po budżecie [grzałki] – do uczenia modeli
+extern PidGains g_gainSchedule[CFG_POWERMODE_MAX][GS_BANDS];  // tuned = punkt ustawiony (NVS)
 extern volatile bool g_errorOverheat;
 extern volatile bool g_errorProfile;
 
@@ -44,6 +44,21 @@ const char* storage_get_auth_pass() {
     return (authPass[0] != '\0') ? authPass : CFG_AUTH_DEFAULT_PASS;
 }
 
+static MeatRule parseMeatRule(const char* s) {
+    while (*s == ' ') s++;
+    if (strncasecmp(s, "mean", 4) == 0 || strcmp(s, "1") == 0) return MeatRule::MEAN;
+    if (strncasecmp(s, "all", 3) == 0 || strcmp(s, "2") == 0) return MeatRule::ALL;
+    return MeatRule::MIN;
+}
+
+static StallAction parseStallAction(const char* s) {
+    while (*s == ' ') s++;
+    if (strncasecmp(s, "raise", 5) == 0 || strcmp(s, "1") == 0) return StallAction::RAISE;
+    if (strncasecmp(s, "notify", 6) == 0 || strcmp(s, "2") == 0) return StallAction::NOTIFY;
+    if (strncasecmp(s, "wrap", 4) == 0 || strcmp(s, "3") == 0) return StallAction::WRAP;
+    return StallAction::NONE;
+}
+
 static bool parseProfileLine(char* line, Step& step) {
     while (*line == ' ' || *line == '\t') line++;
 
@@ -54,10 +69,12 @@ static bool parseProfileLine(char* line, Step& step) {
 
     if (len == 0 || line[0] == '#') return false;
 
-    char* fields[10];
+    // Pole 11 (opcjonalne): reguła sond mięsa min / mean / all
+    // Pole 12 (opcjonalne): reakcja na plateau mięsa none / raise / notify / wrap
+    char* fields[12];
     int fieldCount = 0;
     char* token = strtok(line, ";");
-    while (token && fieldCount < 10) {
+    while (token && fieldCount < 12) {
         fields[fieldCount++] = token;
         token = strtok(NULL, ";");
     }
@@ -78,6 +95,8 @@ static bool parseProfileLine(char* line, Step& step) {
     step.fanOnTime    = max(1000UL, (unsigned long)(atoi(fields[7])) * 1000UL);
     step.fanOffTime   = max(1000UL, (unsigned long)(atoi(fields[8])) * 1000UL);
     step.useMeatTemp  = parseBool(fields[9]);
+    step.meatRule     = (fieldCount > 10) ? parseMeatRule(fields[10]) : MeatRule::MIN;
+    step.stallAction  = (fieldCount > 11) ? parseStallAction(fields[11]) : StallAction::NONE;
 
     return true;
 }
@@ -188,6 +207,71 @@ void storage_load_config_nvs() {
         if (nvs_get_i32(nvsHandle, "manual_fan", &tmp_i) == ESP_OK)
             g_fanMode = tmp_i;
 
+        if (nvs_get_i32(nvsHandle, "pid_input", &tmp_i) == ESP_OK &&
+            tmp_i >= (int)PidInputSource::RAW && tmp_i <= (int)PidInputSource::COMPENSATED)
+            g_pidInputSource = (PidInputSource)tmp_i;
+
+        if (nvs_get_i32(nvsHandle, "ctl_engine", &tmp_i) == ESP_OK &&
+            tmp_i >= (int)ControlEngine::PID && tmp_i <= (int)ControlEngine::MPC)
+            g_controlEngine = (ControlEngine)tmp_i;
+
+        if (nvs_get_i32(nvsHandle, "ssr_mode", &tmp_i) == ESP_OK &&
+            tmp_i >= (int)SsrMode::BURST && tmp_i <= (int)SsrMode::WINDOW)
+            g_ssrMode = (SsrMode)tmp_i;
+
+        if (nvs_get_i32(nvsHandle, "ssr_win", &tmp_i) == ESP_OK &&
+            tmp_i >= (int32_t)SSR_WINDOW_MIN_MS && tmp_i <= (int32_t)SSR_WINDOW_MAX_MS)
+            g_ssrWindowMs = tmp_i;
+
+        if (nvs_get_i32(nvsHandle, "ff_on", &tmp_i) == ESP_OK)
+            g_ffEnabled = (tmp_i != 0);
+
+        len = sizeof(tmp_d);
+        if (nvs_get_blob(nvsHandle, "ff_kloss", &tmp_d, &len) == ESP_OK &&
+            tmp_d >= FF_K_MIN && tmp_d <= FF_K_MAX)
+            g_ffLossCoeff = tmp_d;
+
+        // Nastawy z autotune: "pid_at1".."pid_at3" = {Kp, Ki, Kd}
+        for (int pm = CFG_POWERMODE_MIN; pm <= CFG_POWERMODE_MAX; pm++) {
+            char key[12];
+            snprintf(key, sizeof(key), "pid_at%d", pm);
+            double g[3];
+            len = sizeof(g);
+            if (nvs_get_blob(nvsHandle, key, g, &len) == ESP_OK && len == sizeof(g) &&
+                g[0] > 0.0 && g[1] >= 0.0 && g[2] >= 0.0 &&
+                isfinite(g[0]) && isfinite(g[1]) && isfinite(g[2])) {
+                g_pidGains[pm - 1] = {g[0], g[1], g[2], true};
+            }
+
+            // Harmonogram nastaw: "gs_pm1".."gs_pm3" = GS_BANDS x {Kp, Ki, Kd}, Kp = 0 – brak punktu
+            double row[GS_BANDS][3];
+            snprintf(key, sizeof(key), "gs_pm%d", pm);
+            len = sizeof(row);
+            if (nvs_get_blob(nvsHandle, key, row, &len) == ESP_OK && len == sizeof(row)) {
+                for (int i = 0; i < GS_BANDS; i++) {
+                    bool ok = row[i][0] > 0.0 && row[i][1] >= 0.0 && row[i][2] >= 0.0 &&
+                              isfinite(row[i][0]) && isfinite(row[i][1]) && isfinite(row[i][2]);
+                    g_gainSchedule[pm - 1][i] = {row[i][0], row[i][1], row[i][2], ok};
+                }
+            }
+        }
+
+        // Czas pracy grzałek (wyrównanie zużycia): "heat_rt" = HEATER_COUNT x [s]
+        double rt[HEATER_COUNT];
+        len = sizeof(rt);
+        if (nvs_get_blob(nvsHandle, "heat_rt", rt, &len) == ESP_OK && len == sizeof(rt)) {
+            for (int i = 0; i < HEATER_COUNT; i++) {
+                if (isfinite(rt[i]) && rt[i] >= 0.0) g_heaterRuntimeSec[i] = rt[i];
+            }
+        }
+
+        PowerBudget pb;
+        len = sizeof(pb);
+        if (nvs_get_blob(nvsHandle, "pwr_budget", &pb, &len) == ESP_OK && len == sizeof(pb) &&
+            pb.heaterW[0] <= POWER_W_MAX && pb.heaterW[1] <= POWER_W_MAX && pb.heaterW[2] <= POWER_W_MAX &&
+            pb.smokeW <= POWER_W_MAX && pb.limitW <= POWER_W_MAX)
+            g_powerBudget = pb;
+
         state_unlock();
     }
 
@@ -248,6 +332,123 @@ void storage_save_manual_settings_nvs() {
     log_msg(LOG_LEVEL_DEBUG, "Manual settings saved to NVS");
 }
 
+void storage_save_pid_input_nvs() {
+    if (!state_lock()) return;
+    int32_t src = (int32_t)g_pidInputSource;
+    state_unlock();
+
+    nvs_save_generic([=](nvs_handle_t handle){
+        nvs_set_i32(handle, "pid_input", src);
+    });
+
+    LOG_FMT(LOG_LEVEL_INFO, "PID input source saved: %d", (int)src);
+}
+
+void storage_save_control_engine_nvs() {
+    if (!state_lock()) return;
+    int32_t engine = (int32_t)g_controlEngine;
+    state_unlock();
+
+    nvs_save_generic([=](nvs_handle_t handle){
+        nvs_set_i32(handle, "ctl_engine", engine);
+    });
+
+    LOG_FMT(LOG_LEVEL_INFO, "Control engine saved: %d", (int)engine);
+}
+
+void storage_save_ssr_mode_nvs() {
+    if (!state_lock()) return;
+    int32_t mode = (int32_t)g_ssrMode;
+    int32_t windowMs = (int32_t)g_ssrWindowMs;
+    state_unlock();
+
+    nvs_save_generic([=](nvs_handle_t handle){
+        nvs_set_i32(handle, "ssr_mode", mode);
+        nvs_set_i32(handle, "ssr_win", windowMs);
+    });
+
+    LOG_FMT(LOG_LEVEL_INFO, "SSR mode saved: %d, window %ld ms", (int)mode, (long)windowMs);
+}
+
+void storage_save_feedforward_nvs() {
+    if (!state_lock()) return;
+    int32_t on = g_ffEnabled ? 1 : 0;
+    double k = g_ffLossCoeff;
+    state_unlock();
+
+    nvs_save_generic([=](nvs_handle_t handle){
+        nvs_set_i32(handle, "ff_on", on);
+        nvs_set_blob(handle, "ff_kloss", &k, sizeof(k));
+    });
+
+    log_msg(LOG_LEVEL_DEBUG, "Feedforward settings saved to NVS");
+}
+
+void storage_save_pid_gains_nvs(int powerMode) {
+    if (powerMode < CFG_POWERMODE_MIN || powerMode > CFG_POWERMODE_MAX) return;
+    if (!state_lock()) return;
+    const PidGains& pg = g_pidGains[powerMode - 1];
+    double g[3] = {pg.kp, pg.ki, pg.kd};
+    bool tuned = pg.tuned;
+    state_unlock();
+
+    char key[12];
+    snprintf(key, sizeof(key), "pid_at%d", powerMode);
+    nvs_save_generic([&](nvs_handle_t handle){
+        if (tuned) nvs_set_blob(handle, key, g, sizeof(g));
+        else nvs_erase_key(handle, key);
+    });
+
+    LOG_FMT(LOG_LEVEL_INFO, "PID gains saved for power mode %d", powerMode);
+}
+
+void storage_save_gain_schedule_nvs(int powerMode) {
+    if (powerMode < CFG_POWERMODE_MIN || powerMode > CFG_POWERMODE_MAX) return;
+    double row[GS_BANDS][3];
+    if (!state_lock()) return;
+    for (int i = 0; i < GS_BANDS; i++) {
+        const PidGains& g = g_gainSchedule[powerMode - 1][i];
+        row[i][0] = g.tuned ? g.kp : 0.0;
+        row[i][1] = g.tuned ? g.ki : 0.0;
+        row[i][2] = g.tuned ? g.kd : 0.0;
+    }
+    state_unlock();
+
+    char key[12];
+    snprintf(key, sizeof(key), "gs_pm%d", powerMode);
+    nvs_save_generic([&](nvs_handle_t handle){
+        nvs_set_blob(handle, key, row, sizeof(row));
+    });
+
+    LOG_FMT(LOG_LEVEL_DEBUG, "Gain schedule saved for power mode %d", powerMode);
+}
+
+void storage_save_heater_runtime_nvs() {
+    double rt[HEATER_COUNT];
+    if (!state_lock()) return;
+    for (int i = 0; i < HEATER_COUNT; i++) rt[i] = g_heaterRuntimeSec[i];
+    state_unlock();
+
+    nvs_save_generic([&](nvs_handle_t handle){
+        nvs_set_blob(handle, "heat_rt", rt, sizeof(rt));
+    });
+
+    LOG_FMT(LOG_LEVEL_DEBUG, "Heater runtime saved: %.0f / %.0f / %.0f s", rt[0], rt[1], rt[2]);
+}
+
+void storage_save_power_budget_nvs() {
+    if (!state_lock()) return;
+    PowerBudget pb = g_powerBudget;
+    state_unlock();
+
+    nvs_save_generic([&](nvs_handle_t handle){
+        nvs_set_blob(handle, "pwr_budget", &pb, sizeof(pb));
+    });
+
+    LOG_FMT(LOG_LEVEL_INFO, "Power budget saved: limit %u W, heaters %u/%u/%u W, smoke %u W",
+            pb.limitW, pb.heaterW[0], pb.heaterW[1], pb.heaterW[2], pb.smokeW);
+}
+
 // ======================================================
 // [NEW] AUTORYZACJA – zapis i reset w NVS
 // ======================================================
@@ -378,14 +579,18 @@ String storage_get_profile_as_json(const char* profileName) {
         strncpy(lineCopy, line, sizeof(lineCopy));
         lineCopy[sizeof(lineCopy) - 1] = '\0';
 
-        char* fields[10];
+        char* fields[12];
         int fieldCount = 0;
         char* token = strtok(lineCopy, ";");
-        while (token && fieldCount < 10) {
+        while (token && fieldCount < 12) {
             fields[fieldCount++] = token;
             token = strtok(NULL, ";");
         }
         if (fieldCount < 10) continue;
+        static const char* const ruleNames[] = {"min", "mean", "all"};
+        const char* meatRule = ruleNames[(int)((fieldCount > 10) ? parseMeatRule(fields[10]) : MeatRule::MIN)];
+        static const char* const stallNames[] = {"none", "raise", "notify", "wrap"};
+        const char* stall = stallNames[(int)((fieldCount > 11) ? parseStallAction(fields[11]) : StallAction::NONE)];
 
         if (!firstStep) {
             offset += snprintf(json + offset, sizeof(json) - offset, ",");
@@ -393,10 +598,10 @@ String storage_get_profile_as_json(const char* profileName) {
         offset += snprintf(json + offset, sizeof(json) - offset,
             "{\"name\":\"%s\",\"tSet\":%s,\"tMeat\":%s,\"minTime\":%s,"
             "\"powerMode\":%s,\"smoke\":%s,\"fanMode\":%s,"
-            "\"fanOn\":%s,\"fanOff\":%s,\"useMeatTemp\":%s}",
+            "\"fanOn\":%s,\"fanOff\":%s,\"useMeatTemp\":%s,\"meatRule\":\"%s\",\"stall\":\"%s\"}",
             fields[0], fields[1], fields[2], fields[3],
             fields[4], fields[5], fields[6],
-            fields[7], fields[8], fields[9]);
+            fields[7], fields[8], fields[9], meatRule, stall);
         firstStep = false;
 
         if (offset >= (int)sizeof(json) - 50) break;
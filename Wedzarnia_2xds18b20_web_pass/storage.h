@@ -11,6 +11,14 @@ void storage_load_config_nvs();
 void storage_save_wifi_nvs(const char* ssid, const char* pass);
 void storage_save_profile_path_nvs(const char* path);
 void storage_save_manual_settings_nvs();
+void storage_save_pid_input_nvs();
+void storage_save_control_engine_nvs();
+void storage_save_ssr_mode_nvs();
+void storage_save_feedforward_nvs();
+void storage_save_pid_gains_nvs(int powerMode);   // wynik autotune dla trybu mocy 1..3
+void storage_save_gain_schedule_nvs(int powerMode);  // wiersz harmonogramu nastaw
+void storage_save_heater_runtime_nvs();   // czas pracy grzałek (wyrównanie zużycia)
+void storage_save_power_budget_nvs();
 String storage_list_profiles_json();
 bool storage_reinit_sd();
 String storage_get_profile_as_json(const char* profileName);
@@ -35,6 +35,41 @@ static TaskWatchdog taskWatchdogs[] = {
     {0, false, "Monitor"}
 };
 
+// Pomiar opóźnień (CFG_TIMING_MEASUREMENT) – porównanie sterowników OneWire.
+// Blokowanie: czas jednego obiegu odczytu w tasku czujników.
+// Jitter: spóźnienie wybudzenia tasku względem zaplanowanego vTaskDelay.
+struct TimingStats {
+    unsigned long samples;
+    unsigned long maxUs;
+    unsigned long long sumUs;
+};
+
+static TimingStats sensorBlockStats = {0, 0, 0};
+static TimingStats controlJitterStats = {0, 0, 0};
+static TimingStats uiJitterStats = {0, 0, 0};
+
+static void timingRecord(TimingStats& s, unsigned long us) {
+    s.samples++;
+    s.sumUs += us;
+    if (us > s.maxUs) s.maxUs = us;
+}
+
+// Wołane na początku obiegu; expectedUs = micros() przed vTaskDelay + okres
+static void timingRecordWake(TimingStats& s, unsigned long& expectedUs) {
+    unsigned long nowUs = micros();
+    if (expectedUs != 0) {
+        long late = (long)(nowUs - expectedUs);
+        timingRecord(s, late > 0 ? (unsigned long)late : 0);
+    }
+}
+
+static void timingLog(const char* name, TimingStats& s) {
+    if (s.samples == 0) return;
+    LOG_FMT(LOG_LEVEL_INFO, "[TIMING] %s: avg %lu us, max %lu us (%lu samples)",
+            name, (unsigned long)(s.sumUs / s.samples), s.maxUs, s.samples);
+    s = {0, 0, 0};
+}
+
 static void watchdog_init() {
     esp_task_wdt_config_t wdt_config = {
         .timeout_ms = WDT_TIMEOUT * 1000,
@@ -67,11 +102,14 @@ void taskControl(void* pv) {
     int taskIndex = 0;
     taskWatchdogs[taskIndex].lastReset = xTaskGetTickCount();
     log_msg(LOG_LEVEL_INFO, "Control task started");
+    unsigned long expectedWakeUs = 0;
     for (;;) {
+        if (CFG_TIMING_MEASUREMENT) timingRecordWake(controlJitterStats, expectedWakeUs);
         esp_task_wdt_reset();
         taskWatchdogs[taskIndex].lastReset = xTaskGetTickCount();
         process_run_control_logic();
         checkTaskWatchdog(taskIndex);
+        expectedWakeUs = micros() + 100000UL;
         vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
@@ -81,11 +119,13 @@ void taskSensors(void* pv) {
     int taskIndex = 1;
     taskWatchdogs[taskIndex].lastReset = xTaskGetTickCount();
     log_msg(LOG_LEVEL_INFO, "Sensors task started");
+    initSensorDriver();
     for (;;) {
         esp_task_wdt_reset();
         taskWatchdogs[taskIndex].lastReset = xTaskGetTickCount();
-        requestTemperature();
-        readTemperature();
+        unsigned long t0 = micros();
+        serviceSensors();
+        if (CFG_TIMING_MEASUREMENT) timingRecord(sensorBlockStats, micros() - t0);
         checkDoor();
         checkTaskWatchdog(taskIndex);
         vTaskDelay(pdMS_TO_TICKS(100));
@@ -97,13 +137,16 @@ void taskUI(void* pv) {
     int taskIndex = 2;
     taskWatchdogs[taskIndex].lastReset = xTaskGetTickCount();
     log_msg(LOG_LEVEL_INFO, "UI task started");
+    unsigned long expectedWakeUs = 0;
     for (;;) {
+        if (CFG_TIMING_MEASUREMENT) timingRecordWake(uiJitterStats, expectedWakeUs);
         esp_task_wdt_reset();
         taskWatchdogs[taskIndex].lastReset = xTaskGetTickCount();
         ui_handle_buttons();
         handleBuzzer();
         ui_update_display();
         checkTaskWatchdog(taskIndex);
+        expectedWakeUs = micros() + 50000UL;
         vTaskDelay(pdMS_TO_TICKS(50));
     }
 }
@@ -153,10 +196,20 @@ void taskMonitor(void* pv) {
     unsigned long lastHeapLog = 0;
     unsigned long lastStatsLog = 0;
     unsigned long lastWatchdogCheck = 0;
+    unsigned long lastTimingLog = 0;
     for (;;) {
         esp_task_wdt_reset();
         taskWatchdogs[taskIndex].lastReset = xTaskGetTickCount();
         unsigned long now = millis();
+        if (CFG_TIMING_MEASUREMENT && now - lastTimingLog > TIMING_REPORT_INTERVAL) {
+            lastTimingLog = now;
+            LOG_FMT(LOG_LEVEL_INFO, "[TIMING] OneWire driver: %s",
+                    isSensorDriverRmt() ? "RMT" : "bit-bang");
+            timingLog("Sensors block", sensorBlockStats);
+            timingLog("Control wake jitter", controlJitterStats);
+            timingLog("UI wake jitter", uiJitterStats);
+            logSensorBusTiming();
+        }
         if (now - lastHeapLog > 60000) {
             lastHeapLog = now;
             uint32_t freeHeap = ESP.getFreeHeap();
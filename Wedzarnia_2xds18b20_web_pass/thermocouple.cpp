@@ -0,0 +1,87 @@
+// thermocouple.cpp - Termopary typu K przez MAX31855 / MAX6675 (SPI)
+// Magistrala SPI jest wspólna z TFT i kartą SD. Każdy odczyt to jedna
+// transakcja beginTransaction()/endTransaction() – blokada magistrali w HAL
+// ESP32 serializuje ją z rysowaniem na ekranie i zapisem na SD.
+#include "thermocouple.h"
+#include <SPI.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>   // DEVICE_DISCONNECTED_C – wspólny znacznik braku odczytu
+
+static const int TC_PINS[MAX_THERMOCOUPLES] = {PIN_TC1_CS, PIN_TC2_CS};
+static const SensorBackend TC_TYPES[MAX_THERMOCOUPLES] = {TC1_TYPE, TC2_TYPE};
+
+int ThermocoupleDriver::discover() {
+    count = 0;
+    for (int i = 0; i < MAX_THERMOCOUPLES; i++) {
+        if (TC_PINS[i] < 0) continue;
+        pinMode(TC_PINS[i], OUTPUT);
+        digitalWrite(TC_PINS[i], HIGH);
+        tcs[count].csPin = TC_PINS[i];
+        tcs[count].type = TC_TYPES[i];
+        tcs[count].lastReadMs = 0;
+        LOG_FMT(LOG_LEVEL_INFO, "Thermocouple %d: %s on CS %d",
+                count, sensorBackendName(TC_TYPES[i]), TC_PINS[i]);
+        count++;
+    }
+    return count;
+}
+
+void ThermocoupleDriver::channelInfo(int slot, SensorChannel& ch) const {
+    memset(ch.id, 0, sizeof(ch.id));
+    ch.id[0] = (tcs[slot].type == SensorBackend::MAX31855) ? 0xF1 : 0xF2;
+    ch.id[1] = (uint8_t)tcs[slot].csPin;
+    ch.id[7] = OneWire::crc8(ch.id, 7);
+    ch.backend = tcs[slot].type;
+    ch.slot = (uint8_t)slot;
+}
+
+ReadFault ThermocoupleDriver::readRaw(const Thermocouple& tc, double* tOut) {
+    *tOut = DEVICE_DISCONNECTED_C;
+    uint32_t raw;
+
+    SPI.beginTransaction(SPISettings(TC_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+    digitalWrite(tc.csPin, LOW);
+    if (tc.type == SensorBackend::MAX31855) raw = SPI.transfer32(0);
+    else raw = SPI.transfer16(0);
+    digitalWrite(tc.csPin, HIGH);
+    SPI.endTransaction();
+
+    if (tc.type == SensorBackend::MAX31855) {
+        // Brak układu: MISO stale 0 lub 1
+        if (raw == 0 || raw == 0xFFFFFFFF) return ReadFault::DISCONNECTED;
+        if (raw & 0x00010000) {
+            // D0 = termopara rozwarta, D1/D2 = zwarcie do GND/VCC
+            return (raw & 0x01) ? ReadFault::DISCONNECTED : ReadFault::RANGE;
+        }
+        int32_t v = (int32_t)raw >> 18;        // 14 bitów ze znakiem, 0.25 C
+        *tOut = v * 0.25;
+    } else {
+        if (raw == 0 || raw == 0xFFFF) return ReadFault::DISCONNECTED;
+        if (raw & 0x04) return ReadFault::DISCONNECTED;   // termopara rozwarta
+        *tOut = ((raw >> 3) & 0x0FFF) * 0.25;
+    }
+    return ReadFault::NONE;
+}
+
+void ThermocoupleDriver::service(unsigned long now) {
+    for (int slot = 0; slot < count; slot++) {
+        Thermocouple& tc = tcs[slot];
+        unsigned long interval = (tc.type == SensorBackend::MAX31855)
+                                 ? TC_READ_INTERVAL_MAX31855 : TC_READ_INTERVAL_MAX6675;
+        if (now - tc.lastReadMs < interval) continue;
+
+        // Odczyt tylko dla przypisanych ról – każdy odczyt restartuje konwersję
+        bool assigned = false;
+        for (int role = 0; role < PROBE_COUNT; role++) {
+            if (sensorRoleSlot(role, this) == slot) assigned = true;
+        }
+        if (!assigned) continue;
+
+        tc.lastReadMs = now;
+        double t;
+        ReadFault fault = readRaw(tc, &t);
+        for (int role = 0; role < PROBE_COUNT; role++) {
+            if (sensorRoleSlot(role, this) == slot) sensorDeliverReading(role, t, fault, now);
+        }
+    }
+}
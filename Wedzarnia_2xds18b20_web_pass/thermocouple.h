@@ -0,0 +1,25 @@
+// thermocouple.h - Termopary typu K przez MAX31855 / MAX6675 (SPI)
+#pragma once
+#include "sensor_driver.h"
+
+class ThermocoupleDriver : public TempSensorDriver {
+public:
+    const char* name() const override { return "Thermocouple"; }
+    int discover() override;
+    int size() const override { return count; }
+    void channelInfo(int slot, SensorChannel& ch) const override;
+    void service(unsigned long now) override;
+    double quantStep(int slot) const override { return 0.25; }
+
+private:
+    struct Thermocouple {
+        int csPin;
+        SensorBackend type;
+        unsigned long lastReadMs;
+    };
+
+    ReadFault readRaw(const Thermocouple& tc, double* tOut);
+
+    Thermocouple tcs[MAX_THERMOCOUPLES];
+    int count = 0;
+};
@@ -48,12 +48,15 @@ static unsigned long infoTimeout;
 // Struktura cache dla wyswietlacza
 struct DisplayCache {
     double chamberTemp = -99.0;
+    bool chamberVirtual = false;
     double meatTemp = -99.0;
+    String meatStr = "";
     double setTemp = -99.0;
     String stateString = "";
     String stepName = "";
     String elapsedStr = "";
     String remainingStr = "";
+    String profileStr = "";
     unsigned long lastUpdate = 0;
     bool needsRedraw = true;
 };
@@ -131,6 +134,7 @@ const char* getStateStringForDisplay(ProcessState st) {
         case ProcessState::PAUSE_USER:         return "PAUZA";
         case ProcessState::ERROR_PROFILE:      return "Blad Profilu";
         case ProcessState::SOFT_RESUME:        return "Wznawianie...";
+        case ProcessState::AUTOTUNE:           return "Autotune PID";
         default:                               return "Nieznany";
     }
 }
@@ -420,7 +424,7 @@ static void handleSystemSettingsAction() {
                 display.setCursor(10, 95);
                 display.print("WiFi: " + String(WiFi.status() == WL_CONNECTED ? "OK" : "OFF"));
                 display.setCursor(10, 110);
-                display.print("Czujniki: " + String(sensors.getDeviceCount()));
+                display.print("Czujniki: " + String(getTotalSensorCount()));
                 display.setCursor(10, 125);
                 display.print("Wersja: " FW_VERSION);
                 display.setCursor(10, 140);
@@ -943,16 +947,22 @@ void ui_update_display() {
         display.fillScreen(ST77XX_BLACK);
         displayCache.chamberTemp = -99.0;
         displayCache.meatTemp = -99.0;
+        displayCache.meatStr = "";
         displayCache.setTemp = -99.0;
         displayCache.stateString = "";
         displayCache.stepName = "";
         displayCache.elapsedStr = "";
         displayCache.remainingStr = "";
+        displayCache.profileStr = "";
     }
     
     state_lock();
     double tc = g_tChamber;
+    bool tcVirtual = g_chamberVirtual;
     double tm = g_tMeat;
+    uint16_t meatMask = g_meatProbeMask;
+    double meatProbes[MEAT_PROBES_MAX];
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) meatProbes[i] = g_tMeatProbes[i];
     double ts = g_tSet;
     int pm = g_powerMode;
     int fm = g_fanMode;
@@ -964,7 +974,9 @@ void ui_update_display() {
     char stepName[32];
     strncpy(stepName, (currentStep < stepCount) ? g_profile[currentStep].name : "", sizeof(stepName));
     stepName[sizeof(stepName)-1] = '\0';
-    unsigned long stepTotalTimeMs = (currentStep < stepCount) ? g_profile[currentStep].minTimeMs : 0;
+    long stepEtaSec = g_processStats.stepEtaSec;
+    unsigned long profileRemainingSec = g_processStats.remainingProcessTimeSec;
+    bool etaPredicted = g_processStats.etaPredicted;
     state_unlock();
     
     char buf[32];
@@ -982,23 +994,42 @@ void ui_update_display() {
         display.drawFastHLine(0, 72, SCREEN_WIDTH, ST77XX_DARKGREY);
     }
     
-    // Temperatura komory
+    // Temperatura komory – z modelu (sonda utracona): "~" + "M", inny kolor
     updateTextAutoSize(48, 5, 80, 
-                      String(displayCache.chamberTemp, 1) + " C", 
-                      String(tc, 1) + " C", 
-                      ST77XX_ORANGE);
+                      String(displayCache.chamberVirtual ? "~" : "") + String(displayCache.chamberTemp, 1) +
+                          (displayCache.chamberVirtual ? " M" : " C"),
+                      String(tcVirtual ? "~" : "") + String(tc, 1) + (tcVirtual ? " M" : " C"),
+                      tcVirtual ? ST77XX_MAGENTA : ST77XX_ORANGE);
     displayCache.chamberTemp = tc;
+    displayCache.chamberVirtual = tcVirtual;
     
-    // Temperatura miesa
+    // Temperatura miesa – przy kilku sondach kolejno każda, co 2 s: "3:54.2C"
+    String meatStr = String(tm, 1) + " C";
+    int meatProbeCount = 0;
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) {
+        if (meatMask & (1 << i)) meatProbeCount++;
+    }
+    if (meatProbeCount > 1) {
+        int shown = (now / 2000) % meatProbeCount;
+        for (int i = 0; i < MEAT_PROBES_MAX; i++) {
+            if (!(meatMask & (1 << i))) continue;
+            if (shown-- == 0) {
+                meatStr = String(i + 1) + ":" + (isnan(meatProbes[i]) ? String("--") : String(meatProbes[i], 1)) + "C";
+                break;
+            }
+        }
+    }
     updateTextAutoSize(48, 27, 80, 
-                      String(displayCache.meatTemp, 1) + " C", 
-                      String(tm, 1) + " C", 
+                      displayCache.meatStr, 
+                      meatStr, 
                       ST77XX_YELLOW);
     displayCache.meatTemp = tm;
+    displayCache.meatStr = meatStr;
     
     // Status i temperatura zadana
     const char* stateNameStr = getStateStringForDisplay(st);
-    if (st == ProcessState::RUNNING_AUTO || st == ProcessState::RUNNING_MANUAL) {
+    if (st == ProcessState::RUNNING_AUTO || st == ProcessState::RUNNING_MANUAL ||
+        st == ProcessState::AUTOTUNE) {
         if(force_redraw || displayCache.needsRedraw) { 
             display.setTextSize(1); 
             display.setCursor(0, 53); 
@@ -1043,15 +1074,26 @@ void ui_update_display() {
                           ST77XX_WHITE, 1);
                 displayCache.elapsedStr = String("Uplynelo: ") + buf;
 
-                // Czas pozostaly
-                unsigned long totalSec = stepTotalTimeMs / 1000;
-                unsigned long remainingSec = (totalSec > elapsedSec) ? totalSec - elapsedSec : 0;
-                formatTime(buf, sizeof(buf), remainingSec);
+                // Czas pozostaly – z ETA mięsa; "?" gdy model jeszcze się uczy
+                String remainingStr = String("Zostalo:  ") + "?";
+                if (stepEtaSec >= 0) {
+                    formatTime(buf, sizeof(buf), (unsigned long)stepEtaSec);
+                    remainingStr = String("Zostalo:  ") + buf;
+                }
                 updateText(0, 110, 128, 8, 
                           displayCache.remainingStr, 
-                          String("Zostalo:  ") + buf, 
+                          remainingStr, 
+                          ST77XX_WHITE, 1);
+                displayCache.remainingStr = remainingStr;
+
+                // Koniec profilu; ">" = dolna granica (krok mięsa bez predykcji)
+                formatTime(buf, sizeof(buf), profileRemainingSec);
+                String profileStr = String("Profil: ") + (etaPredicted ? " " : ">") + buf;
+                updateText(0, 120, 128, 8, 
+                          displayCache.profileStr, 
+                          profileStr, 
                           ST77XX_WHITE, 1);
-                displayCache.remainingStr = String("Zostalo:  ") + buf;
+                displayCache.profileStr = profileStr;
                 
                 // DODANE: Instrukcje bez ikon dla trybu AUTO
                 display.setCursor(5, 130);
@@ -0,0 +1,250 @@
+// vchamber.cpp - Wirtualny czujnik komory: uczenie modelu i praca awaryjna
+#include "vchamber.h"
+#include "config.h"
+#include "state.h"
+#include "estimator.h"
+#include "outputs.h"
+
+// Regresory znormalizowane do O(1): temperatura względem VCH_T_NORM,
+// pochodna w C/min – RLS bez problemów numerycznych na double
+static constexpr int VCH_NPARAM = 3;
+
+struct VirtualChamber {
+    // Model komory: theta = {a, b, c}, P = kowariancja RLS
+    double theta[VCH_NPARAM];
+    double P[VCH_NPARAM][VCH_NPARAM];
+    unsigned long samples;
+    // Sprzężenie komora→mięso (RLS skalarny)
+    double kmNum, kmDen;
+    unsigned long meatSamples;
+    // Uśrednianie wymuszenia między próbkami
+    double uSum;
+    unsigned long uCount;
+    unsigned long lastSampleMs;
+    // Praca awaryjna
+    bool engaged;
+    double tVirtual;
+    double setpointCap;            // pod state_lock() – czyta task sterowania
+    unsigned long engagedMs;
+    unsigned long engagements;
+    double lastError;              // model - sonda przy powrocie sondy
+    bool lastErrorValid;
+};
+
+static VirtualChamber vc;
+static bool vcInit = false;
+
+static void resetModel() {
+    // Model startowy: tau VCH_TAU_DEFAULT_MIN, otoczenie VCH_AMBIENT_DEFAULT,
+    // VCH_GAIN_DEFAULT C przyrostu na grzałkę przy pełnym wypełnieniu
+    double b = -VCH_T_NORM / VCH_TAU_DEFAULT_MIN;
+    memset(&vc, 0, sizeof(vc));
+    vc.theta[0] = VCH_GAIN_DEFAULT / VCH_TAU_DEFAULT_MIN;
+    vc.theta[1] = b;
+    vc.theta[2] = -b * (VCH_AMBIENT_DEFAULT - VCH_T_NORM) / VCH_T_NORM;
+    for (int i = 0; i < VCH_NPARAM; i++) vc.P[i][i] = VCH_RLS_P0;
+    vcInit = true;
+}
+
+static double modelRate(double t, double u) {
+    return vc.theta[0] * u + vc.theta[1] * (t - VCH_T_NORM) / VCH_T_NORM + vc.theta[2];
+}
+
+// Parametry fizyczne z theta: tau [min], wzmocnienie [C/grzałkę], otoczenie [C]
+static double modelTau() {
+    return vc.theta[1] < 0.0 ? -VCH_T_NORM / vc.theta[1] : 0.0;
+}
+
+static double modelAmbient() {
+    return vc.theta[1] < 0.0 ? VCH_T_NORM * (1.0 - vc.theta[2] / vc.theta[1]) : 0.0;
+}
+
+static bool modelTrained() {
+    double tau = modelTau();
+    return vc.samples >= VCH_MIN_SAMPLES && tau >= VCH_TAU_MIN_MIN && tau <= VCH_TAU_MAX_MIN &&
+           vc.theta[0] > 0.0;
+}
+
+static void rlsUpdate(const double phi[VCH_NPARAM], double y) {
+    double Pphi[VCH_NPARAM];
+    double denom = VCH_RLS_LAMBDA;
+    for (int i = 0; i < VCH_NPARAM; i++) {
+        Pphi[i] = 0.0;
+        for (int j = 0; j < VCH_NPARAM; j++) Pphi[i] += vc.P[i][j] * phi[j];
+        denom += phi[i] * Pphi[i];
+    }
+    double err = y;
+    for (int i = 0; i < VCH_NPARAM; i++) err -= vc.theta[i] * phi[i];
+    for (int i = 0; i < VCH_NPARAM; i++) vc.theta[i] += Pphi[i] * err / denom;
+    for (int i = 0; i < VCH_NPARAM; i++) {
+        for (int j = 0; j < VCH_NPARAM; j++) {
+            vc.P[i][j] = (vc.P[i][j] - Pphi[i] * Pphi[j] / denom) / VCH_RLS_LAMBDA;
+        }
+    }
+}
+
+static bool isRunning(ProcessState st) {
+    return st == ProcessState::RUNNING_AUTO || st == ProcessState::RUNNING_MANUAL ||
+           st == ProcessState::SOFT_RESUME || st == ProcessState::AUTOTUNE;
+}
+
+static void disengage() {
+    vc.engaged = false;
+    if (state_lock()) {
+        g_chamberVirtual = false;
+        state_unlock();
+    }
+}
+
+static void learn(double u, const TempEstimate& chamber, const TempEstimate& meat) {
+    if (!chamber.valid || chamber.confidence < VCH_MIN_CONFIDENCE) return;
+    double phi[VCH_NPARAM] = {u, (chamber.temp - VCH_T_NORM) / VCH_T_NORM, 1.0};
+    rlsUpdate(phi, chamber.rate * 60.0);
+    vc.samples++;
+
+    // Sprzężenie z mięsem tylko przy wyraźnej różnicy temperatur
+    double diff = chamber.temp - meat.temp;
+    if (meat.valid && diff > VCH_MEAT_MIN_DIFF) {
+        vc.kmNum = VCH_RLS_LAMBDA * vc.kmNum + diff * meat.rate * 60.0;
+        vc.kmDen = VCH_RLS_LAMBDA * vc.kmDen + diff * diff;
+        vc.meatSamples++;
+    }
+}
+
+static void integrate(double u, double dtMin, const TempEstimate& meat) {
+    vc.tVirtual += modelRate(vc.tVirtual, u) * dtMin;
+
+    // Korekta sondą mięsa: Tc = Tm + (dTm/dt)/km; mięso nie bywa cieplejsze
+    // od komory, gdy się nagrzewa
+    double km = vc.kmDen > 0.0 ? vc.kmNum / vc.kmDen : 0.0;
+    if (meat.valid) {
+        if (vc.meatSamples >= VCH_MIN_SAMPLES && km > VCH_KM_MIN) {
+            double fromMeat = meat.temp + meat.rate * 60.0 / km;
+            vc.tVirtual += VCH_MEAT_BLEND * (fromMeat - vc.tVirtual);
+        }
+        if (meat.rate > 0.0 && vc.tVirtual < meat.temp) vc.tVirtual = meat.temp;
+    }
+    vc.tVirtual = constrain(vc.tVirtual, VCH_AMBIENT_MIN, CFG_T_MAX_SOFT);
+}
+
+void vchamber_update(unsigned long nowMs, unsigned long chamberAgeMs) {
+    if (!vcInit) resetModel();
+    if (!state_lock()) return;
+    ProcessState st = g_currentState;
+    double u = isRunning(st) ? g_heaterPower : 0.0;
+    state_unlock();
+
+    vc.uSum += u;
+    vc.uCount++;
+    if (vc.lastSampleMs == 0) vc.lastSampleMs = nowMs;
+
+    // Sonda zniknęła z magistrali (brak jakichkolwiek odczytów) – też przejęcie
+    bool chamberFresh = chamberAgeMs < VCH_FRESH_MS;
+    if (!vc.engaged && isRunning(st) && chamberAgeMs >= VCH_STALE_MS && chamberAgeMs != 0xFFFFFFFF) {
+        TempEstimate est = estimator_get(EST_CHAMBER);
+        if (est.valid) vchamber_engage(nowMs, est.temp);
+    }
+
+    if (nowMs - vc.lastSampleMs < VCH_SAMPLE_MS) return;
+    double dtMin = (nowMs - vc.lastSampleMs) / 60000.0;
+    double uAvg = vc.uSum / vc.uCount;
+    vc.uSum = 0.0;
+    vc.uCount = 0;
+    vc.lastSampleMs = nowMs;
+
+    TempEstimate chamber = estimator_get(EST_CHAMBER);
+    TempEstimate meat = estimator_get(EST_MEAT);
+
+    if (!vc.engaged) {
+        if (chamberFresh && isRunning(st)) learn(uAvg, chamber, meat);
+        return;
+    }
+
+    // Operator przejął (pauza, stop) – model przestaje sterować
+    if (!isRunning(st)) {
+        log_msg(LOG_LEVEL_WARN, "Virtual chamber: process stopped by operator");
+        disengage();
+        return;
+    }
+
+    if (nowMs - vc.engagedMs >= VCH_MAX_MS) {
+        log_msg(LOG_LEVEL_ERROR, "Virtual chamber: time limit reached - pausing process");
+        vchamber_stop();
+        disengage();
+        return;
+    }
+
+    integrate(uAvg, dtMin, meat);
+    if (state_lock()) {
+        g_tChamber = vc.tVirtual;
+        state_unlock();
+    }
+}
+
+bool vchamber_engage(unsigned long nowMs, double lastGood) {
+    if (!vcInit) resetModel();
+    if (vc.engaged) return true;
+    if (!modelTrained()) return false;
+    if (!state_lock()) return false;
+    if (!isRunning(g_currentState)) {
+        state_unlock();
+        return false;
+    }
+    vc.setpointCap = min(g_tSet - VCH_SETPOINT_DROP, VCH_SETPOINT_MAX);
+    g_chamberVirtual = true;
+    g_tChamber = lastGood;
+    state_unlock();
+
+    vc.engaged = true;
+    vc.engagedMs = nowMs;
+    vc.tVirtual = lastGood;
+    vc.engagements++;
+    LOG_FMT(LOG_LEVEL_ERROR, "Chamber probe lost - VIRTUAL sensor (model tau %.0f min), setpoint limited to %.1f C",
+            modelTau(), vc.setpointCap);
+    buzzerBeep(3, 300, 200);
+    return true;
+}
+
+void vchamber_release(double measured) {
+    if (!vc.engaged) return;
+    vc.lastError = vc.tVirtual - measured;
+    vc.lastErrorValid = true;
+    disengage();
+    LOG_FMT(LOG_LEVEL_INFO, "Chamber probe back after %lu s, model error %.1f C",
+            (millis() - vc.engagedMs) / 1000, vc.lastError);
+}
+
+// Tylko zmiana stanu procesu – model odłącza się w vchamber_update() (task czujników)
+void vchamber_stop() {
+    if (!state_lock()) return;
+    bool wasVirtual = g_chamberVirtual;
+    g_errorSensor = true;
+    if (isRunning(g_currentState)) g_currentState = ProcessState::PAUSE_SENSOR;
+    state_unlock();
+    if (wasVirtual) log_msg(LOG_LEVEL_WARN, "Virtual chamber stopped - process paused");
+}
+
+bool vchamber_active() {
+    return vc.engaged;
+}
+
+double vchamber_limitSetpoint(double tSet) {
+    return g_chamberVirtual ? min(tSet, vc.setpointCap) : tSet;
+}
+
+String vchamber_getStatusJSON() {
+    char json[448];
+    double km = vc.kmDen > 0.0 ? vc.kmNum / vc.kmDen : 0.0;
+    snprintf(json, sizeof(json),
+        "{\"active\":%s,\"trained\":%s,\"samples\":%lu,\"meatSamples\":%lu,"
+        "\"tauMin\":%.1f,\"gainPerHeater\":%.1f,\"ambient\":%.1f,\"meatTauMin\":%.0f,"
+        "\"tVirtual\":%.2f,\"activeSec\":%lu,\"maxSec\":%lu,\"setpointCap\":%.1f,"
+        "\"engagements\":%lu,\"lastError\":%s}",
+        vc.engaged ? "true" : "false", modelTrained() ? "true" : "false",
+        vc.samples, vc.meatSamples,
+        modelTau(), vc.theta[0] * modelTau(), modelAmbient(), km > 0.0 ? 1.0 / km : 0.0,
+        vc.tVirtual, vc.engaged ? (millis() - vc.engagedMs) / 1000 : 0, VCH_MAX_MS / 1000,
+        vc.setpointCap, vc.engagements,
+        vc.lastErrorValid ? String(vc.lastError, 2).c_str() : "null");
+    return String(json);
+}
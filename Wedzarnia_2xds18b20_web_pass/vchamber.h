@@ -0,0 +1,22 @@
+// vchamber.h - Wirtualny czujnik komory (praca awaryjna po utracie sondy)
+// Model cieplny 1. rzędu komory: dT/dt = a*u + b*(T - T0)/T0 + c, gdzie
+// u = moc oddana przez grzałki [grzałki] (po budżecie mocy). Parametry uczone RLS
+// na bieżąco, dopóki sonda komory działa; sprzężenie komora→mięso
+// (dTm/dt = km*(Tc - Tm)) uczone osobno. Po utracie sondy model całkowany
+// od ostatniego dobrego odczytu i korygowany sondą mięsa; regulator
+// trzyma obniżony setpoint do interwencji operatora lub VCH_MAX_MS.
+#pragma once
+#include <Arduino.h>
+
+// Krok modelu – task czujników (co obieg); chamberAgeMs = wiek odczytu komory
+void vchamber_update(unsigned long nowMs, unsigned long chamberAgeMs);
+// Próba przejęcia komory przez model (próg błędów sondy); false = model nienauczony
+bool vchamber_engage(unsigned long nowMs, double lastGood);
+// Sonda komory wróciła – koniec pracy na modelu
+void vchamber_release(double measured);
+// Operator przejmuje: zatrzymanie procesu (PAUSE_SENSOR); dowolny task
+void vchamber_stop();
+bool vchamber_active();
+// Ograniczenie setpointu w trybie wirtualnym – wywoływać pod state_lock()
+double vchamber_limitSetpoint(double tSet);
+String vchamber_getStatusJSON();
@@ -7,8 +7,20 @@
 #include "state.h"
 #include "storage.h"
 #include "process.h"
+#include "gainsched.h"
+#include "mpc.h"
+#include "doorrec.h"
+#include "ssrout.h"
+#include "powerbudget.h"
 #include "outputs.h"
 #include "sensors.h"
+#include "estimator.h"
+#include "calibration.h"
+#include "lagcomp.h"
+#include "vchamber.h"
+#include "feedforward.h"
+#include "meateta.h"
+#include "sensor_driver.h"
 #include <WiFi.h>
 #include <Update.h>
 #include "FS.h"
@@ -195,6 +207,7 @@ button{padding:10px 15px;font-size:0.9em;}
 <div class="temp-box temp-meat">
 <div class="label">🍖 Mięso</div>
 <div class="value" id="temp-meat">--°C</div>
+<div class="label" id="meat-probes"></div>
 </div>
 <div class="temp-box temp-target">
 <div class="label">🎯 Zadana</div>
@@ -327,8 +340,14 @@ function fetchStatus(){
 fetch('/status')
 .then(r =>r.json())
 .then(data =>{
-document.getElementById('temp-chamber').textContent = data.tChamber.toFixed(1)+'°C';
+const tcEl = document.getElementById('temp-chamber');
+tcEl.textContent = (data.chamberVirtual ? '~' : '') + data.tChamber.toFixed(1) + '°C' + (data.chamberVirtual ? ' (MODEL)' : '');
+tcEl.style.color = data.chamberVirtual ? '#e040fb' : '';
+tcEl.title = data.chamberVirtual ? 'Sonda komory utracona – temperatura z modelu cieplnego' : '';
 document.getElementById('temp-meat').textContent = data.tMeat.toFixed(1)+'°C';
+const mp = data.tMeatProbes || [];
+document.getElementById('meat-probes').textContent = mp.length > 1
+? mp.map((t, i) =>(i + 1) + ': ' + (t === null ? '--' : t.toFixed(1))).join('  ') + ' (' + data.meatRule + ')' : '';
 document.getElementById('temp-target').textContent = data.tSet.toFixed(1)+'°C';
 let statusClass = 'status-idle';
 let statusText = data.mode;
@@ -347,14 +366,16 @@ if(data.mode === 'AUTO' || data.mode === 'MANUAL'){
 timerSection.classList.add('active');
 document.getElementById('timer-elapsed').textContent = formatTime(data.elapsedTimeSec);
 if(data.mode === 'AUTO'){
-document.getElementById('step-name').textContent = 'Krok:'+data.stepName;
+document.getElementById('step-name').textContent = 'Krok:'+data.stepName + (data.stall ? ' ⏸️ plateau mięsa (' + data.stallAction + ')' : '');
 document.getElementById('countdown-section').style.display = 'block';
 document.getElementById('nextStepBtn').style.display = 'inline-block';
-document.getElementById('timer-remaining').textContent = formatTime(Math.max(0,data.stepTotalTimeSec - data.elapsedTimeSec));
+// Krok z warunkiem mięsa: czas z predykcji ETA ("~"), "?" gdy model się uczy
+document.getElementById('timer-remaining').textContent = data.stepEtaSec === null ? '?'
+: (data.stepEtaSec > Math.max(0,data.stepTotalTimeSec - data.elapsedTimeSec) ? '~' : '') + formatTime(data.stepEtaSec);
 const ps = document.getElementById('process-total-section');
 if(data.remainingProcessTimeSec>0){
 ps.style.display = 'block';
-document.getElementById('process-remaining').textContent = formatTime(data.remainingProcessTimeSec);
+document.getElementById('process-remaining').textContent = (data.etaPredicted ? '' : '≥ ') + formatTime(data.remainingProcessTimeSec);
 }else{ps.style.display = 'none';}
 }else{
 document.getElementById('step-name').textContent = 'Tryb Manualny';
@@ -473,6 +494,19 @@ static const char HTML_TEMPLATE_CREATOR[] PROGMEM = R"rawliteral(<!DOCTYPE html>
 <input type="checkbox" id="stepUseMeatTemp">
 <span>Użyj temperatury mięsa</span>
 </div>
+<label>Reguła sond mięsa</label>
+<select id="stepMeatRule">
+<option value="min" selected>Najzimniejsza sonda</option>
+<option value="mean">Średnia sond</option>
+<option value="all">Każda sonda osiągnęła cel</option>
+</select>
+<label>Reakcja na plateau mięsa (stall)</label>
+<select id="stepStall">
+<option value="none" selected>Brak – krok czeka</option>
+<option value="raise">Podnieś temperaturę komory</option>
+<option value="notify">Powiadom</option>
+<option value="wrap">Przejdź do następnego kroku (zawijanie)</option>
+</select>
 <div class="btn-row">
 <button id="addStepBtn" class="btn-add" onclick="addStep()">Dodaj krok</button>
 </div>
@@ -493,12 +527,12 @@ static const char HTML_TEMPLATE_CREATOR[] PROGMEM = R"rawliteral(<!DOCTYPE html>
 <script>
 let newProfileSteps=[];let stepCounter=1;let editIndex=-1;
 document.addEventListener('DOMContentLoaded',function(){const params=new URLSearchParams(window.location.search);const profileToEdit=params.get('edit');const source=params.get('source')||'sd';if(profileToEdit){document.getElementById('creator-title').textContent='📝 Edytor Profilu:'+profileToEdit;document.getElementById('profileFilename').value=profileToEdit;document.getElementById('profileFilename').readOnly=true;fetch('/profile/get?name='+profileToEdit+'&source='+source).then(r=>r.json()).then(data=>{newProfileSteps=data;updatePreview();if(data.length>0){stepCounter=data.length+1;document.getElementById('step-counter').textContent=stepCounter;}})}});
-function addStep(){const e={name:document.getElementById("stepName").value,tSet:document.getElementById("stepTSet").value,tMeat:document.getElementById("stepTMeat").value,minTime:document.getElementById("stepMinTime").value,powerMode:document.getElementById("stepPowerMode").value,smoke:document.getElementById("stepSmoke").value,fanMode:document.getElementById("stepFanMode").value,fanOn:document.getElementById("stepFanOn").value,fanOff:document.getElementById("stepFanOff").value,useMeatTemp:document.getElementById("stepUseMeatTemp").checked?1:0};if(editIndex===-1){newProfileSteps.push(e);stepCounter++}else{newProfileSteps[editIndex]=e;editIndex=-1}updatePreview();document.getElementById('step-counter').textContent=stepCounter;document.getElementById('stepName').value="Krok "+stepCounter;document.getElementById('addStepBtn').textContent='Dodaj krok';}
+function addStep(){const e={name:document.getElementById("stepName").value,tSet:document.getElementById("stepTSet").value,tMeat:document.getElementById("stepTMeat").value,minTime:document.getElementById("stepMinTime").value,powerMode:document.getElementById("stepPowerMode").value,smoke:document.getElementById("stepSmoke").value,fanMode:document.getElementById("stepFanMode").value,fanOn:document.getElementById("stepFanOn").value,fanOff:document.getElementById("stepFanOff").value,useMeatTemp:document.getElementById("stepUseMeatTemp").checked?1:0,meatRule:document.getElementById("stepMeatRule").value,stall:document.getElementById("stepStall").value};if(editIndex===-1){newProfileSteps.push(e);stepCounter++}else{newProfileSteps[editIndex]=e;editIndex=-1}updatePreview();document.getElementById('step-counter').textContent=stepCounter;document.getElementById('stepName').value="Krok "+stepCounter;document.getElementById('addStepBtn').textContent='Dodaj krok';}
 function updatePreview(){const e=document.getElementById("steps-preview");e.innerHTML="";newProfileSteps.forEach((t,n)=>{const o=document.createElement("div");o.className="step-preview";o.textContent=`Krok ${n+1}:${t.name};${t.tSet}°C;${t.minTime}min`;o.onclick=function(){loadStepForEdit(n)};e.appendChild(o)})}
-function loadStepForEdit(e){const t=newProfileSteps[e];document.getElementById("stepName").value=t.name;document.getElementById("stepTSet").value=t.tSet;document.getElementById("stepTMeat").value=t.tMeat;document.getElementById("stepMinTime").value=t.minTime;document.getElementById("stepPowerMode").value=t.powerMode;document.getElementById("stepSmoke").value=t.smoke;document.getElementById("stepFanMode").value=t.fanMode;document.getElementById("stepFanOn").value=t.fanOn;document.getElementById("stepFanOff").value=t.fanOff;document.getElementById("stepUseMeatTemp").checked=1==t.useMeatTemp;editIndex=e;document.getElementById("step-counter").textContent=e+1;document.getElementById("addStepBtn").textContent="Aktualizuj krok";window.scrollTo(0,0)}
+function loadStepForEdit(e){const t=newProfileSteps[e];document.getElementById("stepName").value=t.name;document.getElementById("stepTSet").value=t.tSet;document.getElementById("stepTMeat").value=t.tMeat;document.getElementById("stepMinTime").value=t.minTime;document.getElementById("stepPowerMode").value=t.powerMode;document.getElementById("stepSmoke").value=t.smoke;document.getElementById("stepFanMode").value=t.fanMode;document.getElementById("stepFanOn").value=t.fanOn;document.getElementById("stepFanOff").value=t.fanOff;document.getElementById("stepUseMeatTemp").checked=1==t.useMeatTemp;document.getElementById("stepMeatRule").value=t.meatRule||"min";document.getElementById("stepStall").value=t.stall||"none";editIndex=e;document.getElementById("step-counter").textContent=e+1;document.getElementById("addStepBtn").textContent="Aktualizuj krok";window.scrollTo(0,0)}
 function clearCreator(){if(confirm("Wyczyścić kreator?")){newProfileSteps=[];stepCounter=1;editIndex=-1;document.getElementById("step-counter").textContent="1";document.getElementById("steps-preview").innerHTML="";document.getElementById("profileFilename").value="";document.getElementById("profileFilename").readOnly=false;document.getElementById("creator-title").textContent="📝 Kreator Profili"}}
-function saveProfile(){const e=document.getElementById("profileFilename").value;if(!e)return alert("Wpisz nazwę pliku!");if(0===newProfileSteps.length)return alert("Dodaj przynajmniej jeden krok!");let t="# Profil\n";newProfileSteps.forEach(e=>{t+=`${e.name};${e.tSet};${e.tMeat};${e.minTime};${e.powerMode};${e.smoke};${e.fanMode};${e.fanOn};${e.fanOff};${e.useMeatTemp}\n`});const n=new URLSearchParams;n.append("filename",e);n.append("data",t);fetch("/profile/create",{method:"POST",body:n}).then(e=>e.text().then(t=>({ok:e.ok,text:t}))).then(({ok:e,text:t})=>{alert(t);e&&(window.location.href="/")})}
-function saveProfileToPC(){const e=document.getElementById("profileFilename").value;if(!e)return alert("Wpisz nazwę pliku!");if(0===newProfileSteps.length)return alert("Dodaj przynajmniej jeden krok!");let t="# Profil\n";newProfileSteps.forEach(e=>{t+=`${e.name};${e.tSet};${e.tMeat};${e.minTime};${e.powerMode};${e.smoke};${e.fanMode};${e.fanOn};${e.fanOff};${e.useMeatTemp}\n`});const n=new Blob([t],{type:"text/plain;charset=utf-8"}),o=URL.createObjectURL(n),d=document.createElement("a");d.href=o;let l=e.endsWith(".prof")?e:e+".prof";d.download=l;document.body.appendChild(d);d.click();document.body.removeChild(d);URL.revokeObjectURL(o)}
+function saveProfile(){const e=document.getElementById("profileFilename").value;if(!e)return alert("Wpisz nazwę pliku!");if(0===newProfileSteps.length)return alert("Dodaj przynajmniej jeden krok!");let t="# Profil\n";newProfileSteps.forEach(e=>{t+=`${e.name};${e.tSet};${e.tMeat};${e.minTime};${e.powerMode};${e.smoke};${e.fanMode};${e.fanOn};${e.fanOff};${e.useMeatTemp};${e.meatRule||"min"};${e.stall||"none"}\n`});const n=new URLSearchParams;n.append("filename",e);n.append("data",t);fetch("/profile/create",{method:"POST",body:n}).then(e=>e.text().then(t=>({ok:e.ok,text:t}))).then(({ok:e,text:t})=>{alert(t);e&&(window.location.href="/")})}
+function saveProfileToPC(){const e=document.getElementById("profileFilename").value;if(!e)return alert("Wpisz nazwę pliku!");if(0===newProfileSteps.length)return alert("Dodaj przynajmniej jeden krok!");let t="# Profil\n";newProfileSteps.forEach(e=>{t+=`${e.name};${e.tSet};${e.tMeat};${e.minTime};${e.powerMode};${e.smoke};${e.fanMode};${e.fanOn};${e.fanOff};${e.useMeatTemp};${e.meatRule||"min"};${e.stall||"none"}\n`});const n=new Blob([t],{type:"text/plain;charset=utf-8"}),o=URL.createObjectURL(n),d=document.createElement("a");d.href=o;let l=e.endsWith(".prof")?e:e+".prof";d.download=l;document.body.appendChild(d);d.click();document.body.removeChild(d);URL.revokeObjectURL(o)}
 </script>
 </body>
 </html>)rawliteral";
@@ -723,32 +757,393 @@ static const char HTML_SENSORS[] PROGMEM = R"rawliteral(<!DOCTYPE html>
 <div class="row"><span class="lbl">Zidentyfikowane</span><span class="val" id="identified">-</span></div>
 </div>
 <div class="card">
+<h3>Głosowanie sond komory</h3>
+<div class="row"><span class="lbl">Sondy w głosowaniu</span><span class="val" id="voteUsed">-</span></div>
+<div class="row"><span class="lbl">Niezgodności / przełączenia</span><span class="val" id="voteStats">-</span></div>
+<div id="voteMembers"></div>
+</div>
+<div class="card">
+<h3>Sondy mięsa</h3>
+<div id="meatProbes"></div>
+</div>
+<div class="card">
+<h3>Magistrala OneWire</h3>
+<div id="busDiag"></div>
+<div class="btn-row">
+<button class="btn-auto" onclick="fetch('/api/sensors/bus',{method:'POST',body:new URLSearchParams({reset:1})}).then(()=>setTimeout(loadBus,500))">🗑️ Zeruj liczniki</button>
+</div>
+</div>
+<div class="card">
+<h3>Kanały</h3>
+<div id="channels"></div>
+</div>
+<div class="card">
 <h3>Przypisz ręcznie</h3>
 <label>Indeks czujnika komory</label>
 <input type="number" id="chamberInput" min="0" value="0">
 <label>Indeks czujnika mięsa</label>
 <input type="number" id="meatInput" min="0" value="1">
+<label>Zapasowe sondy komory (-1 = brak)</label>
+<input type="number" id="backup1Input" min="-1" value="-1">
+<input type="number" id="backup2Input" min="-1" value="-1">
+<label>Dodatkowe sondy mięsa (indeksy po przecinku, maks. 7)</label>
+<input type="text" id="meatExtraInput" placeholder="np. 3,4,5">
+<label>Sonda otoczenia (na zewnątrz komory, -1 = brak)</label>
+<input type="number" id="ambientInput" min="-1" value="-1">
 <div class="btn-row">
 <button class="btn-primary" onclick="reassign()">✅ Przypisz</button>
 <button class="btn-auto" onclick="autodetect()">🔍 Auto-wykryj</button>
 </div>
 <div id="msg"></div>
 </div>
+<div class="card">
+<h3>Kalibracja</h3>
+<label>Czujnik</label>
+<select id="calRole"><option value="chamber">Komora</option><option value="meat">Mięso</option><option value="chamber2">Komora 2</option><option value="chamber3">Komora 3</option><option value="ambient">Otoczenie</option></select>
+<div class="btn-row">
+<button class="btn-primary" onclick="calCmd('start',{role:calRole.value})">▶️ Rozpocznij</button>
+<button class="btn-auto" onclick="calCmd('clear',{role:calRole.value})">🗑️ Usuń kalibrację</button>
+</div>
+<label>Temperatura wzorcowa [°C] (lód 0, wrzątek ~100, termometr wzorcowy)</label>
+<input type="number" id="calRef" step="0.01" value="0">
+<div class="btn-row">
+<button class="btn-primary" onclick="calCmd('capture',{ref:calRef.value})">📍 Zapisz punkt</button>
+<button class="btn-primary" onclick="calCmd('finish',{})">💾 Oblicz i zapisz</button>
+<button class="btn-auto" onclick="calCmd('cancel',{})">✖️ Przerwij</button>
+</div>
+<div id="calStatus"></div>
+<div id="calPoints"></div>
+</div>
+<div class="card">
+<h3>Opóźnienie sondy</h3>
+<div class="row"><span class="lbl">Tau komory [s]</span><span class="val" id="tauChamber">-</span></div>
+<div class="row"><span class="lbl">Tau mięsa [s]</span><span class="val" id="tauMeat">-</span></div>
+<label>Nowa stała czasowa [s] (0 = automatycznie)</label>
+<input type="number" id="tauInput" step="0.5" min="0" value="0">
+<div class="btn-row">
+<button class="btn-primary" onclick="setTau()">💾 Zapisz dla wybranego czujnika</button>
+</div>
+<label>Wejście regulatora PID</label>
+<select id="pidInput" onchange="setPidInput()">
+<option value="raw">Surowy odczyt</option>
+<option value="filtered">Filtrowany (estymator)</option>
+<option value="compensated">Skompensowany (opóźnienie sondy)</option>
+</select>
+<div id="lagMsg"></div>
+</div>
+<div class="card">
+<h3>Wirtualny czujnik komory</h3>
+<div class="row"><span class="lbl">Stan</span><span class="val" id="vchState">-</span></div>
+<div class="row"><span class="lbl">Model (tau / wzmocnienie / otoczenie)</span><span class="val" id="vchModel">-</span></div>
+<div class="row"><span class="lbl">Ostatni błąd modelu</span><span class="val" id="vchError">-</span></div>
+<div class="btn-row">
+<button class="btn-auto" onclick="fetch('/api/sensors/virtual/stop',{method:'POST'}).then(loadVirtual)">⏹️ Zatrzymaj proces</button>
+</div>
+</div>
+<div class="card">
+<h3>Feedforward strat ciepła</h3>
+<div class="row"><span class="lbl">Otoczenie</span><span class="val" id="ffAmbient">-</span></div>
+<div class="row"><span class="lbl">Współczynnik strat</span><span class="val" id="ffK">-</span></div>
+<div class="row"><span class="lbl">Udział w mocy</span><span class="val" id="ffDuty">-</span></div>
+<label>Feedforward</label>
+<select id="ffEnable" onchange="ffCmd({enable:ffEnable.value})">
+<option value="1">Włączony</option>
+<option value="0">Wyłączony</option>
+</select>
+<div class="btn-row">
+<button class="btn-auto" onclick="ffCmd({reset:1})">🗑️ Zapomnij współczynnik</button>
+</div>
+</div>
+<div class="card">
+<h3>Autotune PID (przekaźnik)</h3>
+<div class="row"><span class="lbl">Stan</span><span class="val" id="atState">-</span></div>
+<div id="atGains"></div>
+<label>Setpoint [°C]</label>
+<input type="number" id="atSet" value="70" min="20" max="120">
+<label>Tryb mocy</label>
+<select id="atPm">
+<option value="1">1 grzałka</option>
+<option value="2">2 grzałki</option>
+<option value="3">3 grzałki</option>
+</select>
+<div class="btn-row">
+<button class="btn-auto" onclick="atCmd({start:1,tSet:atSet.value,powerMode:atPm.value})">▶️ Start (tylko w czuwaniu)</button>
+<button class="btn-auto" onclick="atCmd({cancel:1})">⏹️ Przerwij</button>
+</div>
+</div>
+<div class="card">
+<h3>Harmonogram nastaw PID</h3>
+<div class="row"><span class="lbl">Aktywne</span><span class="val" id="gsActive">-</span></div>
+<div id="gsTable"></div>
+<label>Tryb mocy / punkt [°C]</label>
+<select id="gsPm"><option value="1">1 grzałka</option><option value="2">2 grzałki</option><option value="3">3 grzałki</option></select>
+<select id="gsBand"></select>
+<label>Kp / Ki / Kd</label>
+<input type="number" id="gsKp" step="0.01" placeholder="Kp">
+<input type="number" id="gsKi" step="0.0001" placeholder="Ki">
+<input type="number" id="gsKd" step="0.1" placeholder="Kd">
+<div class="btn-row">
+<button class="btn-auto" onclick="gsCmd({powerMode:gsPm.value,band:gsBand.value,kp:gsKp.value,ki:gsKi.value,kd:gsKd.value})">💾 Zapisz punkt</button>
+<button class="btn-auto" onclick="gsCmd({clear:1,powerMode:gsPm.value,band:gsBand.value})">🗑️ Usuń punkt</button>
+</div>
+</div>
+<div class="card">
+<h3>Regulator predykcyjny (MPC)</h3>
+<div class="row"><span class="lbl">Stan</span><span class="val" id="mpcState">-</span></div>
+<div class="row"><span class="lbl">Model FOPDT (opóźnienie / tau / wzmocnienie / otoczenie)</span><span class="val" id="mpcModel">-</span></div>
+<div class="row"><span class="lbl">Wypełnienie MPC</span><span class="val" id="mpcDuty">-</span></div>
+<label>Silnik regulacji</label>
+<select id="mpcEngine" onchange="mpcCmd({engine:mpcEngine.value})">
+<option value="pid">PID</option>
+<option value="mpc">MPC (PID do nauczenia modelu)</option>
+</select>
+<label>Symulacja skoku: z / do [°C], tryb mocy, minuty</label>
+<input type="number" id="bnFrom" value="50">
+<input type="number" id="bnTo" value="80">
+<input type="number" id="bnPm" value="2" min="1" max="3">
+<input type="number" id="bnMin" value="120" min="10" max="480">
+<div id="bnResult"></div>
+<div class="btn-row">
+<button class="btn-auto" onclick="runBench()">📊 Porównaj PID / MPC</button>
+<button class="btn-auto" onclick="mpcCmd({reset:1})">🗑️ Zapomnij model</button>
+</div>
+</div>
+<div class="card">
+<h3>Powrót po otwarciu drzwi</h3>
+<div class="row"><span class="lbl">Stan</span><span class="val" id="drState">-</span></div>
+<div class="row"><span class="lbl">Ostatni powrót</span><span class="val" id="drLast">-</span></div>
+<label>Symulacja: setpoint [°C], otwarcie [s], tryb mocy</label>
+<input type="number" id="drSet" value="80">
+<input type="number" id="drOpen" value="120" min="10" max="1800">
+<input type="number" id="drPm" value="2" min="1" max="3">
+<div id="drResult"></div>
+<div class="btn-row">
+<button class="btn-auto" onclick="runDoorBench()">📊 Porównaj wznowienie</button>
+</div>
+</div>
+<div class="card">
+<h3>Wyjścia SSR grzałek</h3>
+<div class="row"><span class="lbl">Tryb</span><span class="val" id="ssrMode">-</span></div>
+<div class="row"><span class="lbl">Grzałki (zadane / oddane)</span><span class="val" id="ssrCh">-</span></div>
+<div class="row"><span class="lbl">Równocześnie załączone</span><span class="val" id="ssrConc">-</span></div>
+<label>Harmonogram: tryb, okno [ms]</label>
+<select id="ssrSel"><option value="burst">Pakiety połówek (równomiernie)</option><option value="window">Okno czasowe (grzałki kolejno)</option></select>
+<input type="number" id="ssrWin" value="2000" min="200" max="10000" step="100">
+<div class="btn-row">
+<button class="btn-auto" onclick="ssrCmd({mode:ssrSel.value,windowMs:ssrWin.value})">💾 Zapisz</button>
+<button class="btn-auto" onclick="ssrCmd({reset:1})">🗑️ Zeruj statystyki</button>
+</div>
+</div>
+<div class="card">
+<h3>Budżet mocy przyłącza</h3>
+<div class="row"><span class="lbl">Pobór (zapotrzebowanie)</span><span class="val" id="pbNow">-</span></div>
+<div class="row"><span class="lbl">Ograniczenie</span><span class="val" id="pbLim">-</span></div>
+<label>Limit [W] (0 = bez), grzałki 1–3 [W], dym [W], priorytet</label>
+<input type="number" id="pbLimit" min="0" max="20000" step="100">
+<input type="number" id="pbH1" min="0" max="20000" step="50">
+<input type="number" id="pbH2" min="0" max="20000" step="50">
+<input type="number" id="pbH3" min="0" max="20000" step="50">
+<input type="number" id="pbSmoke" min="0" max="20000" step="50">
+<select id="pbPrio"><option value="smoke">Najpierw dym</option><option value="heaters">Najpierw grzałki</option></select>
+<div class="btn-row">
+<button class="btn-auto" onclick="pbSave()">💾 Zapisz</button>
+</div>
+</div>
 <a class="back-link" href="/">⬅️ Wróć do strony głównej</a>
 </div>
 <script>
+function loadSsr(){
+fetch('/api/heaters/ssr').then(r =>r.json()).then(d =>{
+if (d.mode !== 'burst') { document.getElementById('ssrMode').textContent = 'PWM (LEDC)'; document.getElementById('ssrCh').textContent = '-'; return; }
+document.getElementById('ssrMode').textContent = (d.mode === 'window' ? 'okno ' + d.windowMs + ' ms' : 'pakiety połówek') + ', ' +
+(d.source === 'zc' ? 'detektor zera ' + d.mainsHz.toFixed(2) + ' Hz' : 'timer') + (d.zcLoss ? ' (zaniki zboczy: ' + d.zcLoss + ')' : '');
+document.getElementById('ssrCh').textContent = d.channels.map(c =>c.set.toFixed(1) + ' / ' + c.delivered.toFixed(1) + ' %').join(' | ');
+const c = d.concurrency;
+document.getElementById('ssrConc').textContent = 'szczyt ' + c.peak + ' (min. ' + c.minPossible + '), średnio ' + c.avg.toFixed(2) +
+', jednoczesne załączenia ' + c.stackedStarts + ' | ' + c.hist.map((h, i) =>i + ':' + h.toFixed(0) + '%').join(' ');
+ssrSel.value = d.mode;
+ssrWin.value = d.windowMs;
+});
+}
+function loadPb(first){
+fetch('/api/power/budget').then(r =>r.json()).then(d =>{
+document.getElementById('pbNow').textContent = d.actualW + ' W (' + d.demandW + ' W), grzałki ' + d.heaterActualW + ' W, dym ' + d.smokeActualW + ' W';
+document.getElementById('pbLim').textContent = (d.limitW ? (d.limiting ? '⚠️ aktywne, sufit PID ' + d.capPct.toFixed(0) + ' %' : '✅ brak') : 'wyłączony') +
+', łącznie ' + Math.round(d.limitedSec / 60) + ' min w ' + d.episodes + ' epizodach, szczyt ' + d.peakDemandW + ' W';
+if (first) {
+pbLimit.value = d.limitW; pbH1.value = d.heaterW[0]; pbH2.value = d.heaterW[1]; pbH3.value = d.heaterW[2];
+pbSmoke.value = d.smokeW; pbPrio.value = d.priority;
+}
+});
+}
+function pbSave(){
+fetch('/api/power/budget',{method:'POST',body:new URLSearchParams({limitW:pbLimit.value,heater1W:pbH1.value,heater2W:pbH2.value,
+heater3W:pbH3.value,smokeW:pbSmoke.value,priority:pbPrio.value})}).then(() =>loadPb(true));
+}
+function ssrCmd(p){
+fetch('/api/heaters/ssr',{method:'POST',body:new URLSearchParams(p)}).then(loadSsr);
+}
+function loadFf(){
+fetch('/api/pid/feedforward').then(r =>r.json()).then(d =>{
+document.getElementById('ffAmbient').textContent = d.ambientValid ? d.ambient.toFixed(1) + ' °C' : 'brak sondy';
+document.getElementById('ffK').textContent = d.learned ? (d.kLoss * 100).toFixed(2) + ' % grzałki/°C (' + d.samples + ' próbek)' : '⏳ Uczenie w stanie ustalonym';
+document.getElementById('ffDuty').textContent = d.duty.toFixed(1) + ' %';
+document.getElementById('ffEnable').value = d.enabled ? '1' : '0';
+});
+}
+function ffCmd(params){
+fetch('/api/pid/feedforward',{method:'POST',body:new URLSearchParams(params)}).then(loadFf);
+}
+const atStates = {none:'nie uruchamiany',running:'⏳ oscylacja',done:'✅ zakończony',failed:'❌ przerwany'};
+function loadAt(){
+fetch('/api/pid/autotune').then(r =>r.json()).then(d =>{
+let st = atStates[d.status] + (d.message ? ' – ' + d.message : '');
+if (d.status === 'running') st += ' | ' + d.setpoint.toFixed(1) + ' °C, tryb ' + d.powerMode + ', cykle ' + d.cycles + ', ' + Math.floor(d.elapsedSec / 60) + ' min';
+if (d.status === 'done') st += ' | Ku ' + d.ku.toFixed(2) + ', Pu ' + d.pu.toFixed(0) + ' s';
+document.getElementById('atState').textContent = st;
+document.getElementById('atGains').innerHTML = d.gains.map(g =>
+'<div class="row"><span class="lbl">Tryb ' + g.powerMode + (g.tuned ? ' (autotune)' : ' (domyślne)') + '</span><span class="val">Kp ' + g.kp.toFixed(2) +
+', Ki ' + g.ki.toFixed(4) + ', Kd ' + g.kd.toFixed(1) + '</span></div>').join('');
+});
+}
+function loadGs(){
+fetch('/api/pid/schedule').then(r =>r.json()).then(d =>{
+const a = d.active;
+document.getElementById('gsActive').textContent = a.powerMode ? 'Kp ' + a.kp.toFixed(2) + ', Ki ' + a.ki.toFixed(4) + ', Kd ' + a.kd.toFixed(1) +
+' @ ' + a.setpoint.toFixed(1) + ' °C, tryb ' + a.powerMode + (a.scheduled ? ' (harmonogram)' : ' (autotune / domyślne)') : '-';
+if (!gsBand.options.length) gsBand.innerHTML = d.bands.map((t, i) =>'<option value="' + i + '">' + t + ' °C</option>').join('');
+document.getElementById('gsTable').innerHTML = d.modes.map((row, pm) =>
+'<div class="row"><span class="lbl">Tryb ' + (pm + 1) + '</span><span class="val">' + row.map((g, i) =>
+d.bands[i] + '°: ' + (g ? g.kp.toFixed(2) + '/' + g.ki.toFixed(4) + '/' + g.kd.toFixed(1) : '-')).join(' | ') + '</span></div>').join('');
+});
+}
+function gsCmd(params){
+fetch('/api/pid/schedule',{method:'POST',body:new URLSearchParams(params)}).then(r =>{if (!r.ok) r.json().then(e =>alert(e.error));}).then(loadGs);
+}
+function loadMpc(){
+fetch('/api/pid/mpc').then(r =>r.json()).then(d =>{
+document.getElementById('mpcState').textContent = (d.active ? '✅ MPC steruje' : (d.engine === 'mpc' ? '⏳ PID (model się uczy)' : 'PID')) +
+' | próbki ' + d.samples + '/' + d.needed;
+document.getElementById('mpcModel').textContent = d.ready ? d.deadSec + ' s / ' + d.tauMin.toFixed(1) + ' min / ' + d.gain.toFixed(1) + ' °C/grzałkę / ' + d.ambient.toFixed(1) + ' °C' : '⏳ Identyfikacja';
+document.getElementById('mpcDuty').textContent = d.dutyValid ? d.duty.toFixed(1) + ' %' : '-';
+document.getElementById('mpcEngine').value = d.engine;
+});
+}
+function mpcCmd(params){
+fetch('/api/pid/mpc',{method:'POST',body:new URLSearchParams(params)}).then(loadMpc);
+}
+function benchLine(name, r){
+return '<div class="row"><span class="lbl">' + name + '</span><span class="val">przeregulowanie ' + r.overshoot.toFixed(2) + ' °C, narastanie ' +
+(r.riseSec < 0 ? '-' : Math.round(r.riseSec / 60) + ' min') + ', ustalenie ' + (r.settleSec < 0 ? '-' : Math.round(r.settleSec / 60) + ' min') +
+', IAE ' + r.iae.toFixed(0) + ' °C·min</span></div>';
+}
+function runBench(){
+fetch('/api/pid/mpc/benchmark?' + new URLSearchParams({from:bnFrom.value,to:bnTo.value,powerMode:bnPm.value,minutes:bnMin.value})).then(r =>r.json()).then(d =>{
+document.getElementById('bnResult').innerHTML = d.error ? d.error : benchLine('PID', d.pid) + benchLine('MPC', d.mpc);
+});
+}
+function loadDoor(){
+fetch('/api/process/door').then(r =>r.json()).then(d =>{
+document.getElementById('drState').textContent = d.active ? ('⏳ powrót, dodatek ' + d.boost.toFixed(0) + ' %' + (d.reached ? ', w paśmie' : '')) :
+(d.frozen ? '🚪 zamrożony (wypełnienie ' + d.duty.toFixed(1) + ' %)' : '-');
+const l = d.last;
+document.getElementById('drLast').textContent = d.count ? 'otwarcie ' + l.openSec + ' s, spadek ' + l.drop.toFixed(1) + ' °C, dodatek ' + l.boost.toFixed(0) +
+' %, powrót ' + (l.recoverySec < 0 ? '-' : Math.round(l.recoverySec / 60) + ' min') + ', przeregulowanie ' + l.overshoot.toFixed(1) + ' °C (średnio ' +
+Math.round(d.avgRecoverySec / 60) + ' min, ' + d.count + ' razy)' : 'brak';
+});
+}
+function runDoorBench(){
+fetch('/api/process/door/benchmark?' + new URLSearchParams({tSet:drSet.value,openSec:drOpen.value,powerMode:drPm.value})).then(r =>r.json()).then(d =>{
+const line = (n, r) =>'<div class="row"><span class="lbl">' + n + '</span><span class="val">powrót ' + (r.recoverySec < 0 ? '-' : (r.recoverySec / 60).toFixed(1) + ' min') +
+', przeregulowanie ' + r.overshoot.toFixed(2) + ' °C, IAE ' + r.iae.toFixed(0) + ' °C·min</span></div>';
+document.getElementById('drResult').innerHTML = d.error ? d.error : 'spadek ' + d.drop.toFixed(1) + ' °C' + line('Dotychczas', d.legacy) + line('Z powrotem', d.recovery);
+});
+}
+function atCmd(params){
+fetch('/api/pid/autotune',{method:'POST',body:new URLSearchParams(params)}).then(r =>{if (!r.ok) r.json().then(e =>alert(e.error));}).then(loadAt);
+}
+const busVerdicts = {idle:'brak ruchu',ok:'✅ OK',marginal:'⚠️ wolne zbocza (długi kabel)',probe:'⚠️ sonda',probe_or_cable:'⚠️ sonda lub kabel',cable:'❌ kabel / magistrala'};
+function loadBus(){
+fetch('/api/sensors/bus').then(r =>r.json()).then(d =>{
+document.getElementById('busDiag').innerHTML = d.buses.filter(b =>b.active).map(b =>
+'<div class="row"><span class="lbl">Bus ' + b.bus + ' (GPIO ' + b.gpio + ')</span><span class="val">' + busVerdicts[b.verdict] +
+(b.suspect >= 0 ? ' #' + b.suspect : '') + ' | błędy ' + b.errorRate.toFixed(2) + '%, narastanie max ' + b.riseMaxUs + ' µs</span></div>').join('') +
+d.devices.filter(v =>v.index >= 0).map(v =>
+'<div class="row"><span class="lbl">#' + v.index + ' ' + (v.role || '-') + '</span><span class="val">presence ' + v.presenceFail +
+', timeout ' + v.timeouts + ', crc ' + v.crc + ', brak danych ' + v.noData + ', powtórki ' + v.retries + ' / ' + v.transactions + '</span></div>').join('');
+});
+}
+function loadCal(){
+fetch('/api/sensors/cal').then(r =>r.json()).then(d =>{
+let st = d.active ? ('Aktywna: ' + calRole.querySelector('option[value="' + d.role + '"]').textContent) : 'Brak aktywnej kalibracji';
+if (d.capturing) st += ' – próbki ' + d.samples + '/' + d.needed;
+document.getElementById('calStatus').textContent = st + (d.message ? ' | ' + d.message : '');
+document.getElementById('calPoints').innerHTML = d.points.map((p, i) =>
+'<div class="row"><span class="lbl">Punkt ' + (i + 1) + '</span><span class="val">' + p.raw.toFixed(2) + ' → ' + p.ref.toFixed(2) + ' °C</span></div>').join('');
+if (d.capturing) setTimeout(loadCal, 1000);
+});
+}
+function calCmd(cmd, params){
+fetch('/api/sensors/cal/' + cmd,{method:'POST',body:new URLSearchParams(params)})
+.then(r =>r.json())
+.then(d =>{document.getElementById('calStatus').textContent = d.message || d.error || '';setTimeout(loadCal,300);loadInfo();});
+}
+function tauText(p){return p.tau.toFixed(1) + (p.identified ? ' (zidentyfikowana, ' + p.fits + ' skoków)' : ' (domyślna)');}
+function loadLag(){
+fetch('/api/sensors/lag').then(r =>r.json()).then(d =>{
+document.getElementById('tauChamber').textContent = tauText(d.probes.chamber);
+document.getElementById('tauMeat').textContent = tauText(d.probes.meat);
+document.getElementById('pidInput').value = d.pidInput;
+});
+}
+function setTau(){
+fetch('/api/sensors/lag',{method:'POST',body:new URLSearchParams({role:calRole.value,tau:tauInput.value})})
+.then(r =>r.json()).then(d =>{document.getElementById('lagMsg').textContent = d.message || d.error;setTimeout(loadLag,500);});
+}
+function setPidInput(){
+fetch('/api/pid/input',{method:'POST',body:new URLSearchParams({src:pidInput.value})})
+.then(r =>r.json()).then(d =>{document.getElementById('lagMsg').textContent = d.message || d.error;});
+}
+function loadVirtual(){
+fetch('/api/sensors/virtual').then(r =>r.json()).then(d =>{
+document.getElementById('vchState').textContent = d.active
+? '⚠️ AKTYWNY ' + d.tVirtual.toFixed(1) + ' °C, ' + Math.round(d.activeSec / 60) + '/' + Math.round(d.maxSec / 60) + ' min, setpoint ≤ ' + d.setpointCap.toFixed(1) + ' °C'
+: (d.trained ? '✅ Gotowy (' + d.samples + ' próbek)' : '⏳ Uczenie (' + d.samples + ' próbek)');
+document.getElementById('vchModel').textContent = d.tauMin.toFixed(0) + ' min / ' + d.gainPerHeater.toFixed(0) + ' °C / ' + d.ambient.toFixed(0) + ' °C';
+document.getElementById('vchError').textContent = d.lastError === null ? '-' : d.lastError.toFixed(1) + ' °C';
+});
+}
 function loadInfo(){
 fetch('/api/sensors').then(r =>r.json()).then(d =>{
 document.getElementById('totalSensors').textContent = d.total_sensors;
 document.getElementById('chamberIdx').textContent = d.chamber_index;
 document.getElementById('meatIdx').textContent = d.meat_index;
 document.getElementById('identified').textContent = d.identified ? '✅ Tak':'❌ Nie';
+const v = d.vote;
+document.getElementById('voteUsed').textContent = v.used + '/' + v.assigned + (v.disagree ? ' ⚠️ niezgodność' : '');
+document.getElementById('voteStats').textContent = v.disagreements + ' / ' + v.failovers;
+document.getElementById('voteMembers').innerHTML = v.members.filter(m =>m.index >= 0).map(m =>
+'<div class="row"><span class="lbl">' + m.role + ' #' + m.index + '</span><span class="val">' +
+(m.voting ? m.value.toFixed(2) + ' °C' : 'brak') + (m.outlier ? ' ⚠️' : '') + (m.degraded ? ' (zdegradowana)' : '') +
+' | błędy ' + m.errorRate.toFixed(1) + '%, odstępstwa ' + m.outliers + '</span></div>').join('');
+document.getElementById('meatProbes').innerHTML = d.meat_probes.filter(p =>p.index >= 0).map(p =>
+'<div class="row"><span class="lbl">Mięso ' + p.probe + ' #' + p.index + '</span><span class="val">' +
+(p.valid ? p.value.toFixed(2) + ' °C (' + p.age + ' s)' : 'brak') + (p.degraded ? ' (zdegradowana)' : '') +
+' | błędy ' + p.errorRate.toFixed(1) + '%</span></div>').join('');
+document.getElementById('meatExtraInput').value = d.meat_probes.slice(1).filter(p =>p.index >= 0).map(p =>p.index).join(',');
+document.getElementById('backup1Input').value = d.chamber_backup[0];
+document.getElementById('backup2Input').value = d.chamber_backup[1];
+document.getElementById('ambientInput').value = d.ambient_index;
+document.getElementById('channels').innerHTML = (d.channels || []).map(c =>
+'<div class="row"><span class="lbl">#' + c.index + ' ' + c.type + (c.bus >= 0 ? ' (bus ' + c.bus + ')' : '') + '</span><span class="val">' + c.id +
+(c.gain !== 1 || c.offset !== 0 ? ' (x' + c.gain.toFixed(4) + ' ' + (c.offset >= 0 ? '+' : '') + c.offset.toFixed(2) + ')' : '') +
+'</span></div>').join('');
 });
 }
 function reassign(){
 const c = document.getElementById('chamberInput').value;
 const m = document.getElementById('meatInput').value;
-const body = new URLSearchParams({chamber:c,meat:m});
+const body = new URLSearchParams({chamber:c,meat:m,chamber2:backup1Input.value,chamber3:backup2Input.value,meat_extra:meatExtraInput.value,ambient:ambientInput.value});
 fetch('/api/sensors/reassign',{method:'POST',body})
 .then(r =>r.json())
 .then(d =>{document.getElementById('msg').textContent = d.status === 'ok' ? '✅ Przypisano':'❌ Błąd';loadInfo();});
@@ -757,9 +1152,29 @@ function autodetect(){
 document.getElementById('msg').textContent = '⏳ Wykrywanie...';
 fetch('/api/sensors/autodetect',{method:'POST'})
 .then(r =>r.json())
-.then(d =>{document.getElementById('msg').textContent = d.message || d.error;loadInfo();});
+.then(d =>{document.getElementById('msg').textContent = d.message || d.error;setTimeout(loadInfo,2000);});
 }
 loadInfo();
+loadCal();
+loadLag();
+loadVirtual();
+loadFf();
+loadAt();
+loadGs();
+loadMpc();
+loadDoor();
+loadSsr();
+loadPb(true);
+loadBus();
+setInterval(loadVirtual, 10000);
+setInterval(loadBus, 10000);
+setInterval(loadFf, 10000);
+setInterval(loadAt, 10000);
+setInterval(loadGs, 10000);
+setInterval(loadMpc, 10000);
+setInterval(loadDoor, 10000);
+setInterval(loadSsr, 5000);
+setInterval(() =>loadPb(false), 5000);
 </script>
 </body>
 </html>)rawliteral";
@@ -781,12 +1196,21 @@ static const char* getStateString(ProcessState st) {
         case ProcessState::PAUSE_USER:         return "PAUZA UZYTK.";
         case ProcessState::ERROR_PROFILE:      return "ERROR_PROFILE";
         case ProcessState::SOFT_RESUME:        return "Wznawianie...";
+        case ProcessState::AUTOTUNE:           return "AUTOTUNE PID";
         default:                               return "UNKNOWN";
     }
 }
 
+static const char* pidInputSourceName(PidInputSource src) {
+    switch (src) {
+        case PidInputSource::RAW:         return "raw";
+        case PidInputSource::COMPENSATED: return "compensated";
+        default:                          return "filtered";
+    }
+}
+
 static const char* getStatusJSON() {
-    static char jsonBuffer[600];
+    static char jsonBuffer[1344];
     double tc, tm, ts;
     int pm, fm, sm;
     ProcessState st;
@@ -794,27 +1218,53 @@ static const char* getStatusJSON() {
     unsigned long stepTotalSec = 0;
     const char* stepName = "";
     unsigned long remainingProcessTimeSec = 0;
+    long stepEtaSec = -1;
+    bool etaPredicted = false;
     char activeProfile[64] = "Brak";
+    TempEstimate estChamber = estimator_get(EST_CHAMBER);
+    TempEstimate estMeat = estimator_get(EST_MEAT);
+    double compChamber = lagcomp_apply(EST_CHAMBER, estChamber);
+    PidInputSource pidSrc;
+    int voteUsed, voteAssigned;
+    bool voteDisagree, chamberVirtual;
+    double tAmbient, ffDuty;
+    double meatProbes[MEAT_PROBES_MAX];
+    uint16_t meatMask;
+    MeatRule meatRule = MeatRule::MIN;
+    StallAction stallAction = StallAction::NONE;
+    bool stallDetected;
+    getChamberVoteSummary(voteUsed, voteAssigned, voteDisagree);
 
     state_lock();
+    pidSrc = g_pidInputSource;
     st   = g_currentState;
     tc   = g_tChamber;
+    chamberVirtual = g_chamberVirtual;
+    stallDetected = g_stallDetected;
+    tAmbient = g_tAmbient;
+    ffDuty = pidFeedforward;
+    meatMask = g_meatProbeMask;
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) meatProbes[i] = g_tMeatProbes[i];
     tm   = g_tMeat;
     ts   = g_tSet;
     pm   = g_powerMode;
     fm   = g_fanMode;
     sm   = g_manualSmokePwm;
     remainingProcessTimeSec = g_processStats.remainingProcessTimeSec;
+    stepEtaSec = g_processStats.stepEtaSec;
+    etaPredicted = g_processStats.etaPredicted;
     strncpy(activeProfile, storage_get_profile_path(), sizeof(activeProfile) - 1);
     activeProfile[sizeof(activeProfile) - 1] = '\0';
 
-    if (st == ProcessState::RUNNING_MANUAL) {
+    if (st == ProcessState::RUNNING_MANUAL || st == ProcessState::AUTOTUNE) {
         elapsedSec = (millis() - g_processStartTime) / 1000;
     } else if (st == ProcessState::RUNNING_AUTO) {
         elapsedSec = (millis() - g_stepStartTime) / 1000;
         if (g_currentStep < g_stepCount) {
             stepName     = g_profile[g_currentStep].name;
             stepTotalSec = g_profile[g_currentStep].minTimeMs / 1000;
+            meatRule     = g_profile[g_currentStep].meatRule;
+            stallAction  = g_profile[g_currentStep].stallAction;
         }
     }
     state_unlock();
@@ -834,6 +1284,30 @@ static const char* getStatusJSON() {
         default: fanModeStr = "Brak";       break;
     }
 
+    // Przypisane sondy mięsa w kolejności; null = brak świeżego odczytu
+    char meatList[16 + MEAT_PROBES_MAX * 8];
+    int meatOffset = snprintf(meatList, sizeof(meatList), "[");
+    bool firstProbe = true;
+    for (int i = 0; i < MEAT_PROBES_MAX; i++) {
+        if (!(meatMask & (1 << i))) continue;
+        meatOffset += isnan(meatProbes[i])
+            ? snprintf(meatList + meatOffset, sizeof(meatList) - meatOffset, "%snull", firstProbe ? "" : ",")
+            : snprintf(meatList + meatOffset, sizeof(meatList) - meatOffset, "%s%.1f", firstProbe ? "" : ",",
+                       meatProbes[i]);
+        firstProbe = false;
+    }
+    snprintf(meatList + meatOffset, sizeof(meatList) - meatOffset, "]");
+
+    char etaStr[16];
+    if (stepEtaSec < 0) snprintf(etaStr, sizeof(etaStr), "null");
+    else snprintf(etaStr, sizeof(etaStr), "%ld", stepEtaSec);
+    char etaSteps[16 + MAX_STEPS * 12];
+    meateta_formatSteps(etaSteps, sizeof(etaSteps));
+
+    char ambientStr[16];
+    if (isnan(tAmbient)) snprintf(ambientStr, sizeof(ambientStr), "null");
+    else snprintf(ambientStr, sizeof(ambientStr), "%.1f", tAmbient);
+
     char cleanProfileName[64];
     strncpy(cleanProfileName, activeProfile, sizeof(cleanProfileName));
     if (strstr(cleanProfileName, "/profiles/") != NULL) {
@@ -849,13 +1323,27 @@ static const char* getStatusJSON() {
         "\"powerModeText\":\"%s\",\"fanModeText\":\"%s\","
         "\"elapsedTimeSec\":%lu,\"stepName\":\"%s\","
         "\"stepTotalTimeSec\":%lu,\"activeProfile\":\"%s\","
-        "\"remainingProcessTimeSec\":%lu}",
+        "\"remainingProcessTimeSec\":%lu,"
+        "\"tChamberFilt\":%.2f,\"tChamberRate\":%.2f,\"tChamberConf\":%.2f,"
+        "\"tMeatFilt\":%.2f,\"tMeatRate\":%.2f,\"tMeatConf\":%.2f,"
+        "\"tChamberComp\":%.2f,\"pidInput\":\"%s\","
+        "\"voteUsed\":%d,\"voteMembers\":%d,\"voteDisagree\":%s,\"chamberVirtual\":%s,"
+        "\"tMeatProbes\":%s,\"meatRule\":\"%s\",\"tAmbient\":%s,\"ffDuty\":%.1f,"
+        "\"stepEtaSec\":%s,\"etaPredicted\":%s,\"etaSteps\":%s,"
+        "\"stall\":%s,\"stallAction\":\"%s\"}",
         tc, tm, ts, pm, fm, sm,
         getStateString(st), (int)st,
         powerModeStr, fanModeStr,
         elapsedSec, stepName,
         stepTotalSec, cleanProfileName,
-        remainingProcessTimeSec);
+        remainingProcessTimeSec,
+        estChamber.valid ? estChamber.temp : tc, estChamber.rate * 60.0, estChamber.confidence,
+        estMeat.valid ? estMeat.temp : tm, estMeat.rate * 60.0, estMeat.confidence,
+        estChamber.valid ? compChamber : tc, pidInputSourceName(pidSrc),
+        voteUsed, voteAssigned, voteDisagree ? "true" : "false", chamberVirtual ? "true" : "false",
+        meatList, meatRuleName(meatRule), ambientStr, ffDuty,
+        etaStr, etaPredicted ? "true" : "false", etaSteps,
+        stallDetected ? "true" : "false", stallActionName(stallAction));
 
     return jsonBuffer;
 }
@@ -956,6 +1444,17 @@ static const char HTML_SYSINFO[] PROGMEM = R"rawliteral(<!DOCTYPE html>
 </div>
 </div>
 <div class="card">
+<h3>Grzałki</h3>
+<div class="row">
+<span class="lbl">⏱️ Czas pracy (100 %)</span>
+<span class="val" id="heater_rt">...</span>
+</div>
+<div class="row">
+<span class="lbl">🔁 Obciążenie bazowe</span>
+<span class="val" id="heater_base">...</span>
+</div>
+</div>
+<div class="card">
 <h3>O systemie</h3>
 <div class="row">
 <span class="lbl">🔥 Wersja firmware</span>
@@ -1042,6 +1541,8 @@ setVal('fw_author',d.fw_author);
 setVal('chip_model',d.chip_model);
 setVal('mac_addr',d.mac_addr);
 setVal('flash_size',fmtBytes(d.flash_size));
+setVal('heater_rt',d.heater_runtime_h.map((h,i)=>'G'+(i+1)+': '+h.toFixed(1)+' h').join(' | '));
+setVal('heater_base','Grzałka '+d.heater_base,'info');
 document.getElementById('updated_at').textContent =
 'Odświeżono:'+new Date().toLocaleTimeString('pl-PL');
 })
@@ -1112,7 +1613,7 @@ static void handleSysInfoJson() {
     }
 
     // --- Czujniki ---
-    int sensorCount      = sensors.getDeviceCount();
+    int sensorCount      = getTotalSensorCount();
     bool sensorsIdent    = areSensorsIdentified();
 
     // --- WiFi ---
@@ -1129,8 +1630,16 @@ static void handleSysInfoJson() {
     String macString = WiFi.macAddress();  // zwraca "XX:XX:XX:XX:XX:XX"
     const char* macStr = macString.c_str();
 
-    // --- Skonstruuj JSON (static bufor – wystarczy ok. 600 B) ---
-    static char json[900];
+    // --- Grzałki: czas pracy przy 100 % (wyrównanie zużycia) ---
+    double heaterRt[HEATER_COUNT] = {0.0, 0.0, 0.0};
+    if (state_lock()) {
+        for (int i = 0; i < HEATER_COUNT; i++) heaterRt[i] = g_heaterRuntimeSec[i];
+        state_unlock();
+    }
+    int heaterBase = getBaseLoadHeater();
+
+    // --- Skonstruuj JSON (static bufor – wystarczy ok. 700 B) ---
+    static char json[1024];
     snprintf(json, sizeof(json),
         "{"
         "\"heap_free\":%u,"
@@ -1157,7 +1666,9 @@ static void handleSysInfoJson() {
         "\"fw_author\":\""   FW_AUTHOR   "\","  
         "\"chip_model\":\"%s\","
         "\"mac_addr\":\"%s\","
-        "\"flash_size\":%u"
+        "\"flash_size\":%u,"
+        "\"heater_runtime_h\":[%.2f,%.2f,%.2f],"
+        "\"heater_base\":%d"
         "}",
         heapFree, heapTotal, heapMin, psramTotal,
         uptimeSec,
@@ -1168,7 +1679,9 @@ static void handleSysInfoJson() {
         wifiConn  ? "true" : "false",
         wifiSsid.c_str(), wifiIp.c_str(), apIp.c_str(), wifiRssi,
         chipModel.c_str(), macStr,
-        flashSize
+        flashSize,
+        heaterRt[0] / 3600.0, heaterRt[1] / 3600.0, heaterRt[2] / 3600.0,
+        heaterBase
     );
 
     server.send(200, "application/json", json);
@@ -1183,36 +1696,420 @@ static void handleSensorInfo() {
     String json = "{";
     json += "\"chamber_index\":" + String(getChamberSensorIndex()) + ",";
     json += "\"meat_index\":"    + String(getMeatSensorIndex())    + ",";
-    json += "\"total_sensors\":" + String(sensors.getDeviceCount()) + ",";
-    json += "\"identified\":"    + String(areSensorsIdentified() ? "true" : "false");
+    json += "\"total_sensors\":" + String(getTotalSensorCount()) + ",";
+    json += "\"identified\":"    + String(areSensorsIdentified() ? "true" : "false") + ",";
+    json += "\"chamber_backup\":[" + String(getChamberBackupIndex(0)) + "," + String(getChamberBackupIndex(1)) + "],";
+    json += "\"ambient_index\":"  + String(getAmbientProbeIndex()) + ",";
+    json += "\"channels\":"      + getSensorChannelsJson() + ",";
+    json += "\"vote\":"          + getSensorVoteJson() + ",";
+    json += "\"meat_probes\":"   + getMeatProbesJson();
     json += "}";
     server.send(200, "application/json", json);
 }
 
 static void handleSensorReassign() {
     if (!requireAuth()) return;
-    if (server.hasArg("chamber") && server.hasArg("meat")) {
-        int chamber = server.arg("chamber").toInt();
-        int meat    = server.arg("meat").toInt();
-        if (chamber >= 0 && meat >= 0 && chamber != meat) {
-            reassignSensors(chamber, meat);
-            server.send(200, "application/json", "{\"status\":\"ok\"}");
-        } else {
-            server.send(400, "application/json", "{\"error\":\"Invalid indices\"}");
+    if (!server.hasArg("chamber") || !server.hasArg("meat")) {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    SensorAssignment req = {};
+    req.chamber = server.arg("chamber").toInt();
+    req.meat    = server.arg("meat").toInt();
+    // Sondy zapasowe komory – opcjonalne (-1 = brak)
+    if (server.hasArg("chamber2") || server.hasArg("chamber3")) {
+        req.setBackups = true;
+        req.backup[0] = server.hasArg("chamber2") ? server.arg("chamber2").toInt() : -1;
+        req.backup[1] = server.hasArg("chamber3") ? server.arg("chamber3").toInt() : -1;
+    }
+    // Dodatkowe sondy mięsa: lista indeksów "4,5,6" (pusta = brak)
+    if (server.hasArg("meat_extra")) {
+        req.setMeatExtra = true;
+        for (int i = 0; i < MEAT_PROBES_MAX - 1; i++) req.meatExtra[i] = -1;
+        int n = 0;
+        String list = server.arg("meat_extra");
+        int start = 0;
+        while (start < (int)list.length()) {
+            int comma = list.indexOf(',', start);
+            if (comma < 0) comma = list.length();
+            String item = list.substring(start, comma);
+            item.trim();
+            if (item.length() > 0) {
+                if (n >= MEAT_PROBES_MAX - 1) {
+                    server.send(400, "application/json", "{\"error\":\"Too many meat probes\"}");
+                    return;
+                }
+                req.meatExtra[n++] = item.toInt();
+            }
+            start = comma + 1;
         }
+    }
+    // Sonda otoczenia – opcjonalna (-1 = brak)
+    if (server.hasArg("ambient")) {
+        req.setAmbient = true;
+        req.ambient = server.arg("ambient").toInt();
+    }
+    // Wszystkie indeksy sprawdzane razem – przy błędzie nic nie jest zapisywane
+    if (!requestSensorAssignment(req)) {
+        server.send(400, "application/json", "{\"error\":\"Invalid indices\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"status\":\"ok\"}");
+}
+
+static void handleSensorAutoDetect() {
+    if (!requireAuth()) return;
+    // Skan magistrali wykonuje task czujników – tu tylko zlecenie
+    requestSensorRescan();
+    server.send(200, "application/json", "{\"message\":\"Bus rescan scheduled\"}");
+}
+
+static int parseProbeRole() {
+    if (!server.hasArg("role")) return -1;
+    String role = server.arg("role");
+    for (int r = 0; r < PROBE_COUNT; r++) {
+        if (role == probeRoleKey(r)) return r;
+    }
+    return -1;
+}
+
+static void handleSensorCalStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", calibration_getStatusJSON());
+}
+
+static void handleSensorCalStart() {
+    if (!requireAuth()) return;
+    if (startSensorCalibration(parseProbeRole())) {
+        server.send(200, "application/json", "{\"message\":\"Calibration started\"}");
     } else {
+        server.send(400, "application/json", "{\"error\":\"Probe not assigned\"}");
+    }
+}
+
+static void handleSensorCalCapture() {
+    if (!requireAuth()) return;
+    if (!server.hasArg("ref")) {
         server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
     }
+    double ref = server.arg("ref").toFloat();
+    if (ref < -20.0 || ref > 200.0 || !calibration_capture(ref)) {
+        server.send(400, "application/json", "{\"error\":\"Cannot capture point\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"message\":\"Capturing\"}");
 }
 
-static void handleSensorAutoDetect() {
+static void handleSensorCalFinish() {
     if (!requireAuth()) return;
-    identifyAndAssignSensors();
-    if (areSensorsIdentified()) {
-        server.send(200, "application/json", "{\"message\":\"Sensors auto-detected and assigned\"}");
+    char err[64];
+    if (!calibration_finish(err, sizeof(err))) {
+        char json[96];
+        snprintf(json, sizeof(json), "{\"error\":\"%s\"}", err);
+        server.send(400, "application/json", json);
+        return;
+    }
+    requestSensorCalReload();
+    server.send(200, "application/json", "{\"message\":\"Calibration saved\"}");
+}
+
+static void handleSensorCalCancel() {
+    if (!requireAuth()) return;
+    calibration_cancel();
+    server.send(200, "application/json", "{\"message\":\"Calibration cancelled\"}");
+}
+
+static void handleSensorCalClear() {
+    if (!requireAuth()) return;
+    if (clearSensorCalibration(parseProbeRole())) {
+        server.send(200, "application/json", "{\"message\":\"Calibration clear scheduled\"}");
+    } else {
+        server.send(400, "application/json", "{\"error\":\"Probe not assigned\"}");
+    }
+}
+
+static void handleSensorLagStatus() {
+    if (!requireAuth()) return;
+    state_lock();
+    PidInputSource src = g_pidInputSource;
+    state_unlock();
+    String json = "{\"pidInput\":\"";
+    json += pidInputSourceName(src);
+    json += "\",\"probes\":" + lagcomp_getStatusJSON() + "}";
+    server.send(200, "application/json", json);
+}
+
+static void handleSensorVirtualStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", vchamber_getStatusJSON());
+}
+
+static void handleSensorVirtualStop() {
+    if (!requireAuth()) return;
+    vchamber_stop();
+    server.send(200, "application/json", "{\"message\":\"Process paused\"}");
+}
+
+static void handleSensorLagSet() {
+    if (!requireAuth()) return;
+    int role = parseProbeRole();
+    if (role < 0 || role > PROBE_MEAT || !server.hasArg("tau")) {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    EstChannel ch = (role == PROBE_CHAMBER) ? EST_CHAMBER : EST_MEAT;
+    if (!lagcomp_setTau(ch, server.arg("tau").toFloat())) {
+        server.send(400, "application/json", "{\"error\":\"Invalid time constant\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"message\":\"Time constant saved\"}");
+}
+
+static void handlePidInputSet() {
+    if (!requireAuth()) return;
+    String src = server.arg("src");
+    PidInputSource val;
+    if (src == "raw") val = PidInputSource::RAW;
+    else if (src == "filtered") val = PidInputSource::FILTERED;
+    else if (src == "compensated") val = PidInputSource::COMPENSATED;
+    else {
+        server.send(400, "application/json", "{\"error\":\"Invalid source\"}");
+        return;
+    }
+    state_lock(); g_pidInputSource = val; state_unlock();
+    storage_save_pid_input_nvs();
+    server.send(200, "application/json", "{\"message\":\"PID input updated\"}");
+}
+
+static void handleFeedforwardStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", feedforward_getStatusJSON());
+}
+
+static void handleFeedforwardSet() {
+    if (!requireAuth()) return;
+    if (server.hasArg("reset")) {
+        feedforward_reset();
+    } else if (server.hasArg("enable")) {
+        feedforward_setEnabled(server.arg("enable").toInt() != 0);
+    } else {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"message\":\"Feedforward updated\"}");
+}
+
+static void handleAutotuneStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", process_getAutotuneJSON());
+}
+
+static void handleAutotuneSet() {
+    if (!requireAuth()) return;
+    if (server.hasArg("cancel")) {
+        process_cancel_autotune();
+    } else if (server.hasArg("start") && server.hasArg("tSet") && server.hasArg("powerMode")) {
+        if (!process_start_autotune(server.arg("tSet").toFloat(), server.arg("powerMode").toInt())) {
+            server.send(409, "application/json", "{\"error\":\"Autotune wymaga stanu IDLE i poprawnych parametrow\"}");
+            return;
+        }
+    } else {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"message\":\"Autotune updated\"}");
+}
+
+static void handleGainScheduleStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", gainsched_getStatusJSON());
+}
+
+static void handleGainScheduleSet() {
+    if (!requireAuth()) return;
+    if (!server.hasArg("powerMode")) {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    int pm = server.arg("powerMode").toInt();
+    int band = server.hasArg("band") ? server.arg("band").toInt() : -1;
+    if (server.hasArg("clear")) {
+        gainsched_clearPoint(pm, band);
+    } else if (server.hasArg("kp") && server.hasArg("ki") && server.hasArg("kd")) {
+        if (!gainsched_setPoint(pm, band, server.arg("kp").toFloat(),
+                                server.arg("ki").toFloat(), server.arg("kd").toFloat())) {
+            server.send(400, "application/json", "{\"error\":\"Niepoprawny tryb, punkt lub nastawy\"}");
+            return;
+        }
+    } else {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    resetAdaptivePid();
+    server.send(200, "application/json", "{\"message\":\"Gain schedule updated\"}");
+}
+
+static void handleMpcStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", mpc_getStatusJSON());
+}
+
+static void handleMpcSet() {
+    if (!requireAuth()) return;
+    if (server.hasArg("reset")) {
+        mpc_requestReset();
+    } else if (server.hasArg("engine")) {
+        String e = server.arg("engine");
+        if (e != "pid" && e != "mpc") {
+            server.send(400, "application/json", "{\"error\":\"Invalid engine\"}");
+            return;
+        }
+        state_lock();
+        g_controlEngine = (e == "mpc") ? ControlEngine::MPC : ControlEngine::PID;
+        state_unlock();
+        storage_save_control_engine_nvs();
+    } else {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"message\":\"MPC updated\"}");
+}
+
+static void handleMpcBenchmark() {
+    if (!requireAuth()) return;
+    if (!server.hasArg("from") || !server.hasArg("to")) {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    double from = server.arg("from").toFloat();
+    double to = server.arg("to").toFloat();
+    if (from < 0.0 || from > CFG_T_MAX_SET || to < CFG_T_MIN_SET || to > CFG_T_MAX_SET) {
+        server.send(400, "application/json", "{\"error\":\"Invalid temperature range\"}");
+        return;
+    }
+    int pm = server.hasArg("powerMode") ? server.arg("powerMode").toInt() : 2;
+    int minutes = server.hasArg("minutes") ? server.arg("minutes").toInt() : 120;
+    server.send(200, "application/json", mpc_benchmarkJSON(from, to, pm, minutes));
+}
+
+static void handleDoorRecoveryStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", doorrec_getStatusJSON());
+}
+
+static void handleDoorBenchmark() {
+    if (!requireAuth()) return;
+    if (!server.hasArg("tSet")) {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    double tSet = server.arg("tSet").toFloat();
+    if (tSet < CFG_T_MIN_SET || tSet > CFG_T_MAX_SET) {
+        server.send(400, "application/json", "{\"error\":\"Invalid temperature\"}");
+        return;
+    }
+    int openSec = server.hasArg("openSec") ? server.arg("openSec").toInt() : 120;
+    int pm = server.hasArg("powerMode") ? server.arg("powerMode").toInt() : 2;
+    server.send(200, "application/json", mpc_doorBenchmarkJSON(tSet, openSec, pm));
+}
+
+static void handleMeatEtaStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", meateta_getStatusJSON());
+}
+
+static void handleSensorBusStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", getSensorBusJson());
+}
+
+static void handleSensorBusSet() {
+    if (!requireAuth()) return;
+    if (server.hasArg("reset")) {
+        resetBusAnalyzer();
+    } else if (server.hasArg("enable")) {
+        setBusAnalyzerEnabled(server.arg("enable").toInt() != 0);
     } else {
-        server.send(500, "application/json", "{\"error\":\"Auto-detection failed\"}");
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+    server.send(200, "application/json", "{\"message\":\"Bus analyzer updated\"}");
+}
+
+static void handleSsrStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", ssrout_getStatusJSON());
+}
+
+static void handleSsrSet() {
+    if (!requireAuth()) return;
+    if (server.hasArg("reset")) {
+        ssrout_resetStats();
+    } else if (server.hasArg("mode") || server.hasArg("windowMs")) {
+        String m = server.hasArg("mode") ? server.arg("mode") : String("");
+        if (m.length() && m != "burst" && m != "window") {
+            server.send(400, "application/json", "{\"error\":\"Invalid mode\"}");
+            return;
+        }
+        long windowMs = server.hasArg("windowMs") ? server.arg("windowMs").toInt() : 0;
+        if (server.hasArg("windowMs") &&
+            (windowMs < (long)SSR_WINDOW_MIN_MS || windowMs > (long)SSR_WINDOW_MAX_MS)) {
+            server.send(400, "application/json", "{\"error\":\"Invalid window\"}");
+            return;
+        }
+        state_lock();
+        if (m.length()) g_ssrMode = (m == "window") ? SsrMode::WINDOW : SsrMode::BURST;
+        if (windowMs > 0) g_ssrWindowMs = windowMs;
+        state_unlock();
+        storage_save_ssr_mode_nvs();
+    } else {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
     }
+    server.send(200, "application/json", "{\"message\":\"SSR output updated\"}");
+}
+
+static void handlePowerBudgetStatus() {
+    if (!requireAuth()) return;
+    server.send(200, "application/json", powerbudget_getStatusJSON());
+}
+
+static void handlePowerBudgetSet() {
+    if (!requireAuth()) return;
+    static const char* keys[] = {"heater1W", "heater2W", "heater3W", "smokeW", "limitW"};
+    long val[5];
+    bool any = false;
+    for (int i = 0; i < 5; i++) {
+        val[i] = -1;
+        if (!server.hasArg(keys[i])) continue;
+        val[i] = server.arg(keys[i]).toInt();
+        if (val[i] < 0 || val[i] > POWER_W_MAX) {
+            server.send(400, "application/json", "{\"error\":\"Invalid wattage\"}");
+            return;
+        }
+        any = true;
+    }
+    String prio = server.hasArg("priority") ? server.arg("priority") : String("");
+    if (prio.length() && prio != "smoke" && prio != "heaters") {
+        server.send(400, "application/json", "{\"error\":\"Invalid priority\"}");
+        return;
+    }
+    if (!any && !prio.length()) {
+        server.send(400, "application/json", "{\"error\":\"Missing parameters\"}");
+        return;
+    }
+
+    state_lock();
+    for (int i = 0; i < HEATER_COUNT; i++) {
+        if (val[i] >= 0) g_powerBudget.heaterW[i] = val[i];
+    }
+    if (val[3] >= 0) g_powerBudget.smokeW = val[3];
+    if (val[4] >= 0) g_powerBudget.limitW = val[4];
+    if (prio.length()) g_powerBudget.smokeFirst = (prio == "smoke");
+    state_unlock();
+    storage_save_power_budget_nvs();
+    server.send(200, "application/json", "{\"message\":\"Power budget updated\"}");
 }
 
 static void handleSensorsPage() {
@@ -1544,6 +2441,35 @@ void web_server_init() {
     server.on("/api/sensors",            HTTP_GET,  handleSensorInfo);
     server.on("/api/sensors/reassign",   HTTP_POST, handleSensorReassign);
     server.on("/api/sensors/autodetect", HTTP_POST, handleSensorAutoDetect);
+    server.on("/api/sensors/cal",         HTTP_GET,  handleSensorCalStatus);
+    server.on("/api/sensors/cal/start",   HTTP_POST, handleSensorCalStart);
+    server.on("/api/sensors/cal/capture", HTTP_POST, handleSensorCalCapture);
+    server.on("/api/sensors/cal/finish",  HTTP_POST, handleSensorCalFinish);
+    server.on("/api/sensors/cal/cancel",  HTTP_POST, handleSensorCalCancel);
+    server.on("/api/sensors/cal/clear",   HTTP_POST, handleSensorCalClear);
+    server.on("/api/sensors/lag",         HTTP_GET,  handleSensorLagStatus);
+    server.on("/api/sensors/lag",         HTTP_POST, handleSensorLagSet);
+    server.on("/api/sensors/virtual",     HTTP_GET,  handleSensorVirtualStatus);
+    server.on("/api/sensors/virtual/stop", HTTP_POST, handleSensorVirtualStop);
+    server.on("/api/sensors/bus",         HTTP_GET,  handleSensorBusStatus);
+    server.on("/api/sensors/bus",         HTTP_POST, handleSensorBusSet);
+    server.on("/api/pid/input",           HTTP_POST, handlePidInputSet);
+    server.on("/api/pid/feedforward",     HTTP_GET,  handleFeedforwardStatus);
+    server.on("/api/pid/feedforward",     HTTP_POST, handleFeedforwardSet);
+    server.on("/api/pid/autotune",        HTTP_GET,  handleAutotuneStatus);
+    server.on("/api/pid/autotune",        HTTP_POST, handleAutotuneSet);
+    server.on("/api/pid/schedule",        HTTP_GET,  handleGainScheduleStatus);
+    server.on("/api/pid/schedule",        HTTP_POST, handleGainScheduleSet);
+    server.on("/api/pid/mpc",             HTTP_GET,  handleMpcStatus);
+    server.on("/api/pid/mpc",             HTTP_POST, handleMpcSet);
+    server.on("/api/pid/mpc/benchmark",   HTTP_GET,  handleMpcBenchmark);
+    server.on("/api/process/eta",         HTTP_GET,  handleMeatEtaStatus);
+    server.on("/api/process/door",        HTTP_GET,  handleDoorRecoveryStatus);
+    server.on("/api/process/door/benchmark", HTTP_GET, handleDoorBenchmark);
+    server.on("/api/heaters/ssr",         HTTP_GET,  handleSsrStatus);
+    server.on("/api/heaters/ssr",         HTTP_POST, handleSsrSet);
+    server.on("/api/power/budget",        HTTP_GET,  handlePowerBudgetStatus);
+    server.on("/api/power/budget",        HTTP_POST, handlePowerBudgetSet);
     server.on("/sensors",                HTTP_GET,  handleSensorsPage);
 
     // Ustawienia manualne